@@ -0,0 +1,448 @@
+/*
+  ==============================================================================
+
+    EngineBenchmark.cpp
+    Created: 17 Oct 2026 2:18:51am
+
+    Times the audio engine callback, DeckMixerEngine over DJAudioPlayer decks,
+    exactly as the app drives it but with no audio device. Each case varies one
+    thing from a baseline (two decks, 512-sample blocks, speed 1, 16-bit WAV
+    at 44.1 kHz on a 48 kHz engine, decoding in the callback), sweeping:
+
+      block size    32 to 2048
+      deck count    1 to 16
+      speed         0.5x to 2x, with and without key lock
+      file format   WAV, AIFF, FLAC and Ogg written on the fly, plus any --file
+      playback      decoding in the callback, or from memory
+
+    and reports p50/p99/max callback time and the real-time headroom (block
+    duration over callback time) as JSON or CSV. With --baseline, the p99 of
+    every case is compared with an earlier run and regressions fail the run.
+
+    Usage:
+      EngineBenchmark [--json|--csv] [--out FILE] [--seconds S] [--full]
+                      [--file FILE ...] [--baseline FILE] [--tolerance PERCENT]
+
+  ==============================================================================
+*/
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include "../Source/DJAudioPlayer.h"
+#include "../Source/DeckMixerEngine.h"
+
+namespace {
+
+constexpr double engineRate = 48000.0;
+constexpr double testFileSeconds = 20.0;
+constexpr double warmUpSeconds = 0.5;
+
+struct TestFile {
+    String name;
+    File file;
+};
+
+struct Case {
+    String format;
+    int numDecks = 2;
+    int blockSize = 512;
+    double speed = 1.0;
+    bool keyLock = false;
+    bool inMemory = false;
+
+    String getName() const {
+        return "format=" + format + " decks=" + String(numDecks) + " block=" + String(blockSize)
+             + " speed=" + String(speed, 2) + (keyLock ? " keylock" : "") + (inMemory ? " memory" : " direct");
+    }
+};
+
+struct Result {
+    Case benchmarkCase;
+    int numCallbacks = 0;
+    double p50Us = 0.0;
+    double p99Us = 0.0;
+    double maxUs = 0.0;
+    double meanUs = 0.0;
+    double blockUs = 0.0;
+};
+
+//==============================================================================
+/** Writes a few seconds of a drum-and-chord-like test signal in the given format */
+bool writeTestFile(AudioFormat& format, const File& file, double sampleRate, int bitsPerSample, int quality) {
+    auto numSamples = static_cast<int>(testFileSeconds * sampleRate);
+    AudioBuffer<float> signal(2, numSamples);
+    Random random(11);
+
+    for (int i = 0; i < numSamples; ++i) {
+        auto t = i / sampleRate;
+        auto beatPhase = std::fmod(t * 2.0, 1.0); // 120 bpm
+        auto kick = std::exp(-beatPhase * 30.0) * std::sin(MathConstants<double>::twoPi * 55.0 * t);
+        auto chord = 0.15 * (std::sin(MathConstants<double>::twoPi * 220.0 * t)
+                           + std::sin(MathConstants<double>::twoPi * 277.2 * t)
+                           + std::sin(MathConstants<double>::twoPi * 329.6 * t));
+        auto hat = std::exp(-std::fmod(t * 4.0, 1.0) * 80.0) * (random.nextDouble() - 0.5);
+
+        signal.setSample(0, i, static_cast<float>(0.5 * kick + chord + 0.3 * hat));
+        signal.setSample(1, i, static_cast<float>(0.5 * kick + chord - 0.3 * hat));
+    }
+
+    file.deleteFile();
+    auto stream = file.createOutputStream();
+    if (stream == nullptr)
+        return false;
+
+    std::unique_ptr<AudioFormatWriter> writer(format.createWriterFor(stream.get(), sampleRate, 2, bitsPerSample, {}, quality));
+    if (writer == nullptr)
+        return false;
+
+    stream.release();
+    return writer->writeFromAudioSampleBuffer(signal, 0, numSamples);
+}
+
+/** Creates the synthetic test files, skipping any format this build can't write */
+Array<TestFile> createTestFiles(const File& directory) {
+    directory.createDirectory();
+    Array<TestFile> files;
+
+    auto add = [&](const String& name, AudioFormat& format, const String& extension,
+                   double sampleRate, int bitsPerSample, int quality) {
+        auto file = directory.getChildFile(name + extension);
+        if (writeTestFile(format, file, sampleRate, bitsPerSample, quality))
+            files.add({ name, file });
+        else
+            std::cerr << "EngineBenchmark: could not write a " << name << " test file" << std::endl;
+    };
+
+    WavAudioFormat wav;
+    AiffAudioFormat aiff;
+    add("wav16", wav, ".wav", 44100.0, 16, 0);
+    add("wav24-48k", wav, ".wav", 48000.0, 24, 0);
+    add("aiff16", aiff, ".aiff", 44100.0, 16, 0);
+
+   #if JUCE_USE_FLAC
+    FlacAudioFormat flac;
+    add("flac16", flac, ".flac", 44100.0, 16, 5);
+   #endif
+
+   #if JUCE_USE_OGGVORBIS
+    OggVorbisAudioFormat ogg;
+    add("ogg", ogg, ".ogg", 44100.0, 16, 5);
+   #endif
+
+    return files;
+}
+
+/** Builds the sweep: a baseline plus one axis varied at a time, or every combination with full */
+Array<Case> createCases(const Array<TestFile>& files, bool full) {
+    const int blockSizes[] = { 32, 64, 128, 256, 512, 1024, 2048 };
+    const int deckCounts[] = { 1, 2, 4, 8, 16 };
+    const double speeds[] = { 0.5, 0.92, 1.0, 1.08, 2.0 };
+
+    Case baseline;
+    baseline.format = files.getFirst().name;
+
+    Array<Case> cases;
+    auto addUnique = [&cases](const Case& c) {
+        for (auto& existing : cases)
+            if (existing.getName() == c.getName())
+                return;
+        cases.add(c);
+    };
+
+    if (full) {
+        for (auto& file : files)
+            for (auto blockSize : blockSizes)
+                for (auto numDecks : deckCounts)
+                    for (auto speed : speeds)
+                        for (auto keyLock : { false, true }) {
+                            auto c = baseline;
+                            c.format = file.name;
+                            c.blockSize = blockSize;
+                            c.numDecks = numDecks;
+                            c.speed = speed;
+                            c.keyLock = keyLock;
+                            addUnique(c);
+                        }
+        return cases;
+    }
+
+    addUnique(baseline);
+
+    for (auto blockSize : blockSizes) { auto c = baseline; c.blockSize = blockSize; addUnique(c); }
+    for (auto numDecks : deckCounts)  { auto c = baseline; c.numDecks = numDecks; addUnique(c); }
+    for (auto speed : speeds)         { auto c = baseline; c.speed = speed; addUnique(c); }
+    for (auto speed : speeds)         { auto c = baseline; c.speed = speed; c.keyLock = true; addUnique(c); }
+    for (auto& file : files)          { auto c = baseline; c.format = file.name; addUnique(c); }
+    for (auto& file : files)          { auto c = baseline; c.format = file.name; c.inMemory = true; addUnique(c); }
+
+    return cases;
+}
+
+//==============================================================================
+Result runCase(const Case& benchmarkCase, const File& file, AudioFormatManager& formatManager, double secondsToTime) {
+    OwnedArray<DJAudioPlayer> players;
+    DeckMixerEngine mixer;
+
+    for (int i = 0; i < benchmarkCase.numDecks; ++i) {
+        auto* player = players.add(new DJAudioPlayer(formatManager));
+
+        // Decoding in the callback makes the format's cost show up in the timings; read-ahead would hide it
+        player->setReadAheadSamples(0);
+        player->setUsePcmCache(false);
+        player->setAnalyseOnLoad(false);
+        player->setPlaybackMode(benchmarkCase.inMemory ? DJAudioPlayer::PlaybackMode::inMemory
+                                                       : DJAudioPlayer::PlaybackMode::streaming);
+        mixer.addDeck(player);
+    }
+
+    mixer.prepareToPlay(benchmarkCase.blockSize, engineRate);
+
+    for (int i = 0; i < players.size(); ++i) {
+        auto* player = players[i];
+        player->loadURL(URL(file));
+        player->setKeyLock(benchmarkCase.keyLock);
+        player->setSpeed(benchmarkCase.speed);
+
+        // Decks a little apart, as in a real mix
+        player->setPosition(std::fmod(i * 1.7, 10.0));
+        player->start();
+    }
+
+    AudioBuffer<float> output(DeckMixerEngine::numDeckChannels, benchmarkCase.blockSize);
+    auto blockSeconds = benchmarkCase.blockSize / engineRate;
+    auto numWarmUpBlocks = static_cast<int>(warmUpSeconds / blockSeconds);
+    auto numBlocks = jmax(1, static_cast<int>(secondsToTime / blockSeconds));
+    auto blocksPerSecond = jmax(1, static_cast<int>(1.0 / blockSeconds));
+
+    std::vector<double> durations;
+    durations.reserve(static_cast<size_t>(numBlocks));
+
+    for (int block = -numWarmUpBlocks; block < numBlocks; ++block) {
+        // Loop the deck before it runs out, so every timed block does the same work
+        if (block % blocksPerSecond == 0)
+            for (int i = 0; i < players.size(); ++i)
+                if (players[i]->getPositionRelative() > 0.7)
+                    players[i]->setPosition(std::fmod(i * 1.7, 10.0));
+
+        auto start = Time::getHighResolutionTicks();
+        mixer.getNextAudioBlock(AudioSourceChannelInfo(output));
+        auto elapsed = Time::highResolutionTicksToSeconds(Time::getHighResolutionTicks() - start);
+
+        if (block >= 0)
+            durations.push_back(elapsed * 1.0e6);
+    }
+
+    mixer.releaseResources();
+
+    Result result;
+    result.benchmarkCase = benchmarkCase;
+    result.numCallbacks = static_cast<int>(durations.size());
+    result.blockUs = blockSeconds * 1.0e6;
+
+    std::sort(durations.begin(), durations.end());
+    auto percentile = [&durations](double p) {
+        auto index = static_cast<size_t>(std::ceil(p * static_cast<double>(durations.size()))) - 1;
+        return durations[jmin(index, durations.size() - 1)];
+    };
+
+    result.p50Us = percentile(0.50);
+    result.p99Us = percentile(0.99);
+    result.maxUs = durations.back();
+    result.meanUs = std::accumulate(durations.begin(), durations.end(), 0.0) / static_cast<double>(durations.size());
+    return result;
+}
+
+//==============================================================================
+var toVar(const Result& result) {
+    auto* object = new DynamicObject();
+    const auto& c = result.benchmarkCase;
+
+    object->setProperty("name", c.getName());
+    object->setProperty("format", c.format);
+    object->setProperty("decks", c.numDecks);
+    object->setProperty("block", c.blockSize);
+    object->setProperty("speed", c.speed);
+    object->setProperty("keylock", c.keyLock);
+    object->setProperty("mode", c.inMemory ? "memory" : "direct");
+    object->setProperty("callbacks", result.numCallbacks);
+    object->setProperty("p50_us", result.p50Us);
+    object->setProperty("p99_us", result.p99Us);
+    object->setProperty("max_us", result.maxUs);
+    object->setProperty("mean_us", result.meanUs);
+    object->setProperty("block_us", result.blockUs);
+    object->setProperty("headroom_p99", result.blockUs / result.p99Us);
+    object->setProperty("headroom_max", result.blockUs / result.maxUs);
+
+    return var(object);
+}
+
+var getMachineInfo() {
+    auto* machine = new DynamicObject();
+    machine->setProperty("cpu", SystemStats::getCpuModel());
+    machine->setProperty("cores", SystemStats::getNumCpus());
+    machine->setProperty("physical_cores", SystemStats::getNumPhysicalCpus());
+    machine->setProperty("os", SystemStats::getOperatingSystemName());
+    machine->setProperty("juce", SystemStats::getJUCEVersion());
+    machine->setProperty("time", Time::getCurrentTime().toISO8601(true));
+   #if JUCE_DEBUG
+    machine->setProperty("build", "debug");
+   #else
+    machine->setProperty("build", "release");
+   #endif
+    return var(machine);
+}
+
+String toCsv(const Array<Result>& results) {
+    String csv = "name,format,decks,block,speed,keylock,mode,callbacks,p50_us,p99_us,max_us,mean_us,block_us,headroom_p99,headroom_max\n";
+
+    for (auto& result : results) {
+        const auto& c = result.benchmarkCase;
+        csv << c.getName() << "," << c.format << "," << c.numDecks << "," << c.blockSize << ","
+            << String(c.speed, 2) << "," << (c.keyLock ? 1 : 0) << "," << (c.inMemory ? "memory" : "direct") << ","
+            << result.numCallbacks << "," << String(result.p50Us, 2) << "," << String(result.p99Us, 2) << ","
+            << String(result.maxUs, 2) << "," << String(result.meanUs, 2) << "," << String(result.blockUs, 2) << ","
+            << String(result.blockUs / result.p99Us, 2) << "," << String(result.blockUs / result.maxUs, 2) << "\n";
+    }
+
+    return csv;
+}
+
+/**
+ * Compares p99 times with a previous JSON run
+ * @return the number of cases slower than the baseline by more than the tolerance
+ */
+int compareWithBaseline(const Array<Result>& results, const File& baselineFile, double tolerancePercent) {
+    auto baseline = JSON::parse(baselineFile);
+    auto* baselineResults = baseline["results"].getArray();
+    if (baselineResults == nullptr) {
+        std::cerr << "EngineBenchmark: " << baselineFile.getFullPathName() << " has no results" << std::endl;
+        return -1;
+    }
+
+    auto numRegressions = 0;
+
+    for (auto& result : results) {
+        auto name = result.benchmarkCase.getName();
+
+        for (auto& previous : *baselineResults) {
+            if (previous["name"].toString() != name)
+                continue;
+
+            auto previousP99 = static_cast<double>(previous["p99_us"]);
+            auto change = 100.0 * (result.p99Us - previousP99) / jmax(previousP99, 1.0e-9);
+
+            if (change > tolerancePercent) {
+                std::cerr << "REGRESSION " << name << ": p99 " << String(previousP99, 1) << " -> "
+                          << String(result.p99Us, 1) << " us (+" << String(change, 1) << "%)" << std::endl;
+                ++numRegressions;
+            }
+        }
+    }
+
+    return numRegressions;
+}
+
+} // namespace
+
+//==============================================================================
+int main(int argc, char* argv[]) {
+    ScopedJuceInitialiser_GUI juceInitialiser;
+
+    auto useCsv = false;
+    auto full = false;
+    auto secondsToTime = 10.0;
+    auto tolerancePercent = 10.0;
+    File outputFile, baselineFile;
+    Array<File> realFiles;
+
+    for (int i = 1; i < argc; ++i) {
+        String argument(CharPointer_UTF8(argv[i]));
+        auto nextValue = [&]() { return i + 1 < argc ? String(CharPointer_UTF8(argv[++i])) : String(); };
+
+        if (argument == "--csv")             useCsv = true;
+        else if (argument == "--json")       useCsv = false;
+        else if (argument == "--full")       full = true;
+        else if (argument == "--seconds")    secondsToTime = jmax(0.1, nextValue().getDoubleValue());
+        else if (argument == "--tolerance")  tolerancePercent = nextValue().getDoubleValue();
+        else if (argument == "--out")        outputFile = File::getCurrentWorkingDirectory().getChildFile(nextValue());
+        else if (argument == "--baseline")   baselineFile = File::getCurrentWorkingDirectory().getChildFile(nextValue());
+        else if (argument == "--file")       realFiles.add(File::getCurrentWorkingDirectory().getChildFile(nextValue()));
+        else {
+            std::cerr << "Usage: EngineBenchmark [--json|--csv] [--out FILE] [--seconds S] [--full]" << std::endl
+                      << "                       [--file FILE ...] [--baseline FILE] [--tolerance PERCENT]" << std::endl;
+            return 1;
+        }
+    }
+
+    AudioFormatManager formatManager;
+    formatManager.registerBasicFormats();
+
+    auto testDirectory = File::getSpecialLocation(File::tempDirectory).getChildFile("OtoDecksEngineBenchmark");
+    auto files = createTestFiles(testDirectory);
+
+    for (auto& file : realFiles) {
+        if (file.existsAsFile())
+            files.add({ "file:" + file.getFileName(), file });
+        else
+            std::cerr << "EngineBenchmark: no such file " << file.getFullPathName() << std::endl;
+    }
+
+    if (files.isEmpty()) {
+        std::cerr << "EngineBenchmark: no files to play" << std::endl;
+        return 1;
+    }
+
+    auto cases = createCases(files, full);
+    Array<Result> results;
+
+    for (int i = 0; i < cases.size(); ++i) {
+        const auto& benchmarkCase = cases.getReference(i);
+        File file;
+        for (auto& testFile : files)
+            if (testFile.name == benchmarkCase.format)
+                file = testFile.file;
+
+        // Progress goes to stderr so stdout stays machine-readable
+        std::cerr << "[" << (i + 1) << "/" << cases.size() << "] " << benchmarkCase.getName() << std::endl;
+        results.add(runCase(benchmarkCase, file, formatManager, secondsToTime));
+    }
+
+    String report;
+    if (useCsv) {
+        report = toCsv(results);
+    }
+    else {
+        auto* root = new DynamicObject();
+        root->setProperty("machine", getMachineInfo());
+        root->setProperty("engine_rate", engineRate);
+        root->setProperty("seconds_per_case", secondsToTime);
+
+        Array<var> resultArray;
+        for (auto& result : results)
+            resultArray.add(toVar(result));
+        root->setProperty("results", resultArray);
+
+        report = JSON::toString(var(root));
+    }
+
+    if (outputFile != File()) {
+        if (!outputFile.replaceWithText(report)) {
+            std::cerr << "EngineBenchmark: could not write " << outputFile.getFullPathName() << std::endl;
+            return 1;
+        }
+    }
+    else {
+        std::cout << report << std::endl;
+    }
+
+    testDirectory.deleteRecursively();
+
+    if (baselineFile != File()) {
+        auto numRegressions = compareWithBaseline(results, baselineFile, tolerancePercent);
+        if (numRegressions < 0)
+            return 1;
+        if (numRegressions > 0)
+            return 2;
+    }
+
+    return 0;
+}
@@ -0,0 +1,133 @@
+/*
+  ==============================================================================
+
+    LibraryScanBenchmark.cpp
+    Created: 17 Oct 2026 9:48:05am
+
+    Times library scans of a folder of audio files: the first scan, which reads
+    every file, a rescan with nothing changed, and a rescan after some files have
+    been touched, added and deleted. Without --folder, a synthetic collection of
+    short WAV files is written to a temporary folder first.
+
+    Usage:
+      LibraryScanBenchmark [--files N] [--folder PATH] [--concurrency N]
+
+  ==============================================================================
+*/
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include "../Source/LibraryScanner.h"
+
+namespace {
+
+constexpr int defaultNumFiles = 50000;
+constexpr int filesPerFolder = 100;
+
+/** Writes short silent WAV files, a hundred to a folder, as a collection of albums would be laid out */
+bool writeCollection(const File& root, int numFiles) {
+    WavAudioFormat wav;
+    AudioBuffer<float> silence(2, 4410);
+    silence.clear();
+
+    for (int i = 0; i < numFiles; ++i) {
+        auto folder = root.getChildFile("Artist " + String(i / filesPerFolder / 10))
+                          .getChildFile("Album " + String(i / filesPerFolder));
+        folder.createDirectory();
+
+        auto file = folder.getChildFile("Artist " + String(i / filesPerFolder / 10) + " - Track " + String(i) + ".wav");
+        std::unique_ptr<AudioFormatWriter> writer(wav.createWriterFor(new FileOutputStream(file), 44100.0, 2, 16, {}, 0));
+        if (writer == nullptr || !writer->writeFromAudioSampleBuffer(silence, 0, silence.getNumSamples()))
+            return false;
+    }
+
+    return true;
+}
+
+/** Runs a scan to the end and prints how long it took */
+void timeScan(const String& name, LibraryScanner& scanner, const File& folder, int concurrency) {
+    auto start = Time::getHighResolutionTicks();
+    scanner.scan({ folder }, concurrency);
+
+    while (scanner.isScanning())
+        Thread::sleep(1);
+
+    auto seconds = Time::highResolutionTicksToSeconds(Time::getHighResolutionTicks() - start);
+    auto progress = scanner.getProgress();
+
+    std::cout << name.paddedRight(' ', 20) << String(seconds * 1000.0, 1).paddedLeft(' ', 10) << " ms   "
+              << progress.filesFound << " found, " << progress.filesUnchanged << " unchanged, "
+              << progress.filesRead << " read, " << progress.filesFailed << " failed, "
+              << progress.filesRemoved << " removed" << std::endl;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    ScopedJuceInitialiser_GUI juceInitialiser;
+
+    StringArray arguments(argv + 1, argc - 1);
+    auto argument = [&arguments](const String& name) {
+        auto found = arguments.indexOf(name);
+        return found >= 0 ? arguments[found + 1] : String();
+    };
+
+    auto numFiles = argument("--files").isNotEmpty() ? jmax(1, argument("--files").getIntValue()) : defaultNumFiles;
+    auto concurrency = jmax(0, argument("--concurrency").getIntValue());
+
+    // A synthetic collection is written and deleted by the benchmark; a real one is only read
+    std::unique_ptr<TemporaryFile> tempFolder;
+    auto folder = File(argument("--folder"));
+
+    if (argument("--folder").isEmpty()) {
+        tempFolder = std::make_unique<TemporaryFile>("LibraryScanBenchmark");
+        folder = tempFolder->getFile();
+
+        std::cout << "Writing " << numFiles << " files..." << std::endl;
+        if (!writeCollection(folder, numFiles)) {
+            std::cerr << "LibraryScanBenchmark: could not write to " << folder.getFullPathName() << std::endl;
+            return 1;
+        }
+    }
+
+    if (!folder.isDirectory()) {
+        std::cerr << "LibraryScanBenchmark: " << folder.getFullPathName() << " is not a folder" << std::endl;
+        return 1;
+    }
+
+    AudioFormatManager formatManager;
+    formatManager.registerBasicFormats();
+
+    TemporaryFile indexFile(".index");
+    TrackLibrary library(indexFile.getFile());
+    LibraryScanner scanner(formatManager, library);
+
+    auto storage = LibraryScanner::detectStorage(folder);
+    std::cout << folder.getFullPathName() << ", "
+              << (storage == LibraryScanner::Storage::localDisk ? "local disk" : "network mount") << ", "
+              << (concurrency > 0 ? concurrency : LibraryScanner::getConcurrency(storage)) << " readers"
+              << std::endl << std::endl;
+
+    timeScan("First scan", scanner, folder, concurrency);
+    timeScan("Unchanged rescan", scanner, folder, concurrency);
+
+    if (tempFolder != nullptr) {
+        // Touch 1% of the files, add as many and delete as many
+        auto files = folder.findChildFiles(File::findFiles, true, "*.wav");
+        files.sort();
+
+        for (int i = 0; i + 1 < files.size(); i += 100) {
+            files[i].setLastModificationTime(Time::getCurrentTime() + RelativeTime::hours(1));
+            files[i].copyFileTo(files[i].getSiblingFile("Copy " + files[i].getFileName()));
+            files[i + 1].deleteFile();
+        }
+
+        timeScan("Rescan, 3% changed", scanner, folder, concurrency);
+    }
+
+    std::cout << std::endl << library.getIndex()->getNumTracks() << " tracks in the library" << std::endl;
+
+    if (tempFolder != nullptr)
+        folder.deleteRecursively();
+
+    return 0;
+}
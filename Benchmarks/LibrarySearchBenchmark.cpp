@@ -0,0 +1,125 @@
+/*
+  ==============================================================================
+
+    LibrarySearchBenchmark.cpp
+    Created: 17 Oct 2026 8:15:40am
+
+    Times the library index on a synthetic collection: building it, saving and
+    loading it, and searching it for common, rare and multi-word queries, as the
+    search box does on every keystroke.
+
+    Usage:
+      LibrarySearchBenchmark [--tracks N]
+
+  ==============================================================================
+*/
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include "../Source/TrackLibrary.h"
+
+namespace {
+
+constexpr int defaultNumTracks = 50000;
+constexpr int numRuns = 10;
+
+/** Runs a task several times and returns the fastest time in seconds */
+template <typename Task>
+double timeBest(Task&& task, int runs = numRuns) {
+    double best = std::numeric_limits<double>::max();
+
+    for (int run = 0; run < runs; ++run) {
+        auto start = Time::getHighResolutionTicks();
+        task();
+        best = jmin(best, Time::highResolutionTicksToSeconds(Time::getHighResolutionTicks() - start));
+    }
+
+    return best;
+}
+
+/** Makes up names from a small set of syllables, so words repeat as they do in real collections */
+String makeName(Random& random, int maxWords) {
+    static const char* syllables[] = { "ka", "lo", "mi", "ne", "ta", "ru", "si", "vo", "de", "pa", "zu", "xen",
+                                       "qui", "bor", "lan", "tek", "no", "deep", "club", "love", "night", "sun" };
+    constexpr int numSyllables = static_cast<int>(std::size(syllables));
+
+    StringArray words;
+    for (int w = 1 + random.nextInt(maxWords); --w >= 0;) {
+        String word;
+        for (int s = 1 + random.nextInt(3); --s >= 0;)
+            word << syllables[random.nextInt(numSyllables)];
+        words.add(word.substring(0, 1).toUpperCase() + word.substring(1));
+    }
+
+    return words.joinIntoString(" ");
+}
+
+std::vector<LibraryTrack> makeTracks(int numTracks) {
+    Random random(42);
+    std::vector<LibraryTrack> tracks;
+    tracks.reserve(static_cast<size_t>(numTracks));
+
+    for (int i = 0; i < numTracks; ++i) {
+        LibraryTrack track;
+        track.artist = makeName(random, 2);
+        track.title = makeName(random, 3) + (random.nextInt(4) == 0 ? " (" + makeName(random, 1) + " Remix)" : String());
+        track.album = makeName(random, 3);
+        track.path = "/Music/" + track.artist + "/" + track.album + "/" + String(i % 20 + 1).paddedLeft('0', 2)
+                   + " " + track.title + ".flac";
+        track.lengthSeconds = 120.0 + random.nextInt(360);
+        track.fileSize = 20000000 + random.nextInt(40000000);
+        track.modificationTime = 1700000000000 + random.nextInt(1000000);
+        track.bpm = random.nextInt(3) == 0 ? 0.0f : 90.0f + static_cast<float>(random.nextInt(80));
+        tracks.push_back(std::move(track));
+    }
+
+    return tracks;
+}
+
+void printTime(const String& name, double seconds, const String& note = {}) {
+    std::cout << name.paddedRight(' ', 28) << String(seconds * 1000.0, 3).paddedLeft(' ', 10) << " ms"
+              << (note.isNotEmpty() ? "   " + note : String()) << std::endl;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    ScopedJuceInitialiser_GUI juceInitialiser;
+
+    StringArray arguments(argv + 1, argc - 1);
+    auto numTracks = defaultNumTracks;
+    auto tracksArgument = arguments.indexOf("--tracks");
+    if (tracksArgument >= 0)
+        numTracks = jmax(1, arguments[tracksArgument + 1].getIntValue());
+
+    auto tracks = makeTracks(numTracks);
+    std::cout << "Library index, " << numTracks << " synthetic tracks, best of " << numRuns << " runs" << std::endl
+              << std::endl;
+
+    //==========================================================================
+    std::shared_ptr<const LibraryIndex> index;
+    printTime("Build", timeBest([&] { index = LibraryIndex::build(tracks); }, 3));
+
+    TemporaryFile temp(".index");
+    printTime("Save", timeBest([&] { index->save(temp.getFile()); }, 3),
+              String(temp.getFile().getSize() / 1024) + " KB");
+    printTime("Load", timeBest([&] { index = LibraryIndex::load(temp.getFile()); }, 3));
+
+    if (index == nullptr || index->getNumTracks() != numTracks) {
+        std::cerr << "LibrarySearchBenchmark: the index did not load back" << std::endl;
+        return 1;
+    }
+
+    auto path = tracks[tracks.size() / 2].path;
+    printTime("Find by path", timeBest([&] { index->find(path); }));
+
+    //==========================================================================
+    std::cout << std::endl << "Search:" << std::endl;
+
+    for (auto query : { "k", "ka", "love", "remix", "night club", "deep sun ka", "quixen", "zzz" }) {
+        std::vector<int> results;
+        auto seconds = timeBest([&] { results = index->search(query); });
+        printTime(String("\"") + query + "\"", seconds, String(results.size()) + " results");
+    }
+
+    return 0;
+}
@@ -0,0 +1,136 @@
+/*
+  ==============================================================================
+
+    MixerBenchmark.cpp
+    Created: 17 Oct 2026 1:20:44am
+
+    Compares the callback time of JUCE's serial MixerAudioSource with the
+    parallel DeckMixerEngine as the deck count grows. Each synthetic deck is
+    a looping in-memory track through the HQ resampler at a pitched-up speed,
+    which is about what a playing deck costs.
+
+  ==============================================================================
+*/
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include "../Source/DeckMixerEngine.h"
+#include "../Source/QualityResamplingAudioSource.h"
+
+namespace {
+
+constexpr double sampleRate = 48000.0;
+constexpr int numChannels = 2;
+constexpr int blockSize = 256;
+constexpr double secondsToRender = 10.0;
+
+/** A stand-in for a playing deck: a looping track and a resampling stage */
+struct SyntheticDeck : public AudioSource {
+    explicit SyntheticDeck(const AudioBuffer<float>& track)
+        : source(track, false, true),
+          resampler(&source, numChannels) {
+        resampler.setQuality(QualityResamplingAudioSource::Quality::highQuality);
+        resampler.setResamplingRatio(1.08);
+    }
+
+    void prepareToPlay(int samplesPerBlockExpected, double rate) override { resampler.prepareToPlay(samplesPerBlockExpected, rate); }
+    void releaseResources() override { resampler.releaseResources(); }
+    void getNextAudioBlock(const AudioSourceChannelInfo& bufferToFill) override { resampler.getNextAudioBlock(bufferToFill); }
+
+    MemoryAudioSource source;
+    QualityResamplingAudioSource resampler;
+};
+
+AudioBuffer<float> makeTrack() {
+    AudioBuffer<float> track(numChannels, static_cast<int>(sampleRate * 5.0));
+    Random random(3);
+
+    for (int chan = 0; chan < numChannels; ++chan) {
+        auto* samples = track.getWritePointer(chan);
+        for (int i = 0; i < track.getNumSamples(); ++i)
+            samples[i] = 0.25f * (random.nextFloat() - 0.5f);
+    }
+
+    return track;
+}
+
+struct Timing {
+    double averageSeconds = 0.0;
+    double worstSeconds = 0.0;
+};
+
+Timing timeCallbacks(AudioSource& mixer) {
+    AudioBuffer<float> output(numChannels, blockSize);
+    auto numBlocks = static_cast<int>(secondsToRender * sampleRate / blockSize);
+    Timing timing;
+
+    for (int block = 0; block < numBlocks; ++block) {
+        auto start = Time::getHighResolutionTicks();
+        mixer.getNextAudioBlock(AudioSourceChannelInfo(output));
+        auto elapsed = Time::highResolutionTicksToSeconds(Time::getHighResolutionTicks() - start);
+
+        timing.averageSeconds += elapsed;
+        timing.worstSeconds = jmax(timing.worstSeconds, elapsed);
+    }
+
+    timing.averageSeconds /= numBlocks;
+    return timing;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    ignoreUnused(argc, argv);
+    ScopedJuceInitialiser_GUI juceInitialiser;
+
+    auto track = makeTrack();
+    auto blockSeconds = blockSize / sampleRate;
+
+    std::cout << "Mixer callback time, " << blockSize << "-sample blocks at " << sampleRate << " Hz, "
+              << SystemStats::getNumCpus() << " cores" << std::endl << std::endl;
+
+    std::cout << String("decks").paddedRight(' ', 8)
+              << String("serial us").paddedLeft(' ', 12)
+              << String("worst").paddedLeft(' ', 10)
+              << String("parallel us").paddedLeft(' ', 14)
+              << String("worst").paddedLeft(' ', 10)
+              << String("speed-up").paddedLeft(' ', 10)
+              << String("% of block").paddedLeft(' ', 12) << std::endl;
+
+    for (auto numDecks : { 1, 2, 4, 8, 12, 16 }) {
+        OwnedArray<SyntheticDeck> decks;
+        for (int i = 0; i < numDecks; ++i)
+            decks.add(new SyntheticDeck(track));
+
+        Timing serial;
+        {
+            MixerAudioSource mixer;
+            for (auto* deck : decks)
+                mixer.addInputSource(deck, false);
+
+            mixer.prepareToPlay(blockSize, sampleRate);
+            serial = timeCallbacks(mixer);
+            mixer.releaseResources();
+        }
+
+        Timing parallel;
+        {
+            DeckMixerEngine mixer;
+            for (auto* deck : decks)
+                mixer.addDeck(deck);
+
+            mixer.prepareToPlay(blockSize, sampleRate);
+            parallel = timeCallbacks(mixer);
+            mixer.releaseResources();
+        }
+
+        std::cout << String(numDecks).paddedRight(' ', 8)
+                  << String(serial.averageSeconds * 1.0e6, 1).paddedLeft(' ', 12)
+                  << String(serial.worstSeconds * 1.0e6, 0).paddedLeft(' ', 10)
+                  << String(parallel.averageSeconds * 1.0e6, 1).paddedLeft(' ', 14)
+                  << String(parallel.worstSeconds * 1.0e6, 0).paddedLeft(' ', 10)
+                  << (String(serial.averageSeconds / parallel.averageSeconds, 2) + "x").paddedLeft(' ', 10)
+                  << String(100.0 * parallel.averageSeconds / blockSeconds, 1).paddedLeft(' ', 12) << std::endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,117 @@
+/*
+  ==============================================================================
+
+    ResamplerBenchmark.cpp
+    Created: 16 Oct 2026 11:58:13pm
+
+    Measures the per-deck CPU cost and accuracy of each resampler quality tier
+    across the speed range, rendering in device-sized blocks from a looping
+    in-memory sine. Accuracy is the residual after a sine fit (see SineFit.h).
+
+  ==============================================================================
+*/
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include "../Source/QualityResamplingAudioSource.h"
+#include "SineFit.h"
+
+namespace {
+
+constexpr double sampleRate = 48000.0;
+constexpr int numChannels = 2;
+constexpr int blockSize = 512;
+constexpr double secondsToRender = 20.0;
+constexpr double testFrequency = 1000.0;
+
+/** A whole number of cycles, so the loop point is seamless */
+AudioBuffer<float> makeTestSignal() {
+    auto numSamples = static_cast<int>(sampleRate * 10.0);
+    AudioBuffer<float> signal(numChannels, numSamples);
+
+    for (int chan = 0; chan < numChannels; ++chan) {
+        auto* samples = signal.getWritePointer(chan);
+        for (int i = 0; i < numSamples; ++i)
+            samples[i] = 0.5f * static_cast<float>(std::sin(MathConstants<double>::twoPi * testFrequency * i / sampleRate));
+    }
+
+    return signal;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    ignoreUnused(argc, argv);
+    ScopedJuceInitialiser_GUI juceInitialiser;
+
+    auto signal = makeTestSignal();
+    MemoryAudioSource source(signal, false, true);
+
+    QualityResamplingAudioSource resampler(&source, numChannels);
+    resampler.prepareToPlay(blockSize, sampleRate);
+
+    AudioBuffer<float> output(numChannels, blockSize);
+    auto numBlocks = static_cast<int>(secondsToRender * sampleRate / blockSize);
+    auto blockSeconds = blockSize / sampleRate;
+
+    // One second of output, after the filters have settled, is checked for accuracy
+    constexpr int settleBlocks = 10;
+    AudioBuffer<float> capture(1, static_cast<int>(sampleRate));
+
+    std::cout << "Resampler cost per deck, " << numChannels << " channels at " << sampleRate
+              << " Hz, " << blockSize << "-sample blocks, " << testFrequency << " Hz test tone"
+              << std::endl << std::endl;
+
+    std::cout << String("tier").paddedRight(' ', 8)
+              << String("ratio").paddedRight(' ', 10)
+              << String("us/block").paddedLeft(' ', 12)
+              << String("worst us").paddedLeft(' ', 12)
+              << String("% of core").paddedLeft(' ', 12)
+              << String("decks/core").paddedLeft(' ', 12)
+              << String("residual dB").paddedLeft(' ', 14) << std::endl;
+
+    using Quality = QualityResamplingAudioSource::Quality;
+
+    for (auto quality : { Quality::fast, Quality::sinc, Quality::highQuality }) {
+        // 44.1 kHz material on a 48 kHz device is the most common fixed ratio
+        for (auto ratio : { 0.5, 44100.0 / 48000.0, 0.92, 1.0, 1.08, 1.5, 2.0 }) {
+            resampler.setQuality(quality);
+            resampler.setResamplingRatio(ratio);
+            resampler.flushBuffers();
+            source.setNextReadPosition(0);
+
+            double totalSeconds = 0.0;
+            double worstSeconds = 0.0;
+            int captured = 0;
+
+            for (int block = 0; block < numBlocks; ++block) {
+                auto start = Time::getHighResolutionTicks();
+                resampler.getNextAudioBlock(AudioSourceChannelInfo(output));
+                auto elapsed = Time::highResolutionTicksToSeconds(Time::getHighResolutionTicks() - start);
+
+                totalSeconds += elapsed;
+                worstSeconds = jmax(worstSeconds, elapsed);
+
+                if (block >= settleBlocks && captured < capture.getNumSamples()) {
+                    auto numToCopy = jmin(blockSize, capture.getNumSamples() - captured);
+                    capture.copyFrom(0, captured, output, 0, 0, numToCopy);
+                    captured += numToCopy;
+                }
+            }
+
+            auto averageSeconds = totalSeconds / numBlocks;
+            auto coreFraction = averageSeconds / blockSeconds;
+            auto residual = getSineFitResidualDecibels(capture.getReadPointer(0), captured, testFrequency * ratio, sampleRate);
+
+            std::cout << QualityResamplingAudioSource::getQualityName(quality).paddedRight(' ', 8)
+                      << String(ratio, 4).paddedRight(' ', 10)
+                      << String(averageSeconds * 1.0e6, 1).paddedLeft(' ', 12)
+                      << String(worstSeconds * 1.0e6, 1).paddedLeft(' ', 12)
+                      << String(coreFraction * 100.0, 2).paddedLeft(' ', 12)
+                      << String(1.0 / coreFraction, 0).paddedLeft(' ', 12)
+                      << String(residual, 1).paddedLeft(' ', 14) << std::endl;
+        }
+    }
+
+    resampler.releaseResources();
+    return 0;
+}
@@ -0,0 +1,145 @@
+/*
+  ==============================================================================
+
+    SampleRateConversionBenchmark.cpp
+    Created: 17 Oct 2026 12:34:05am
+
+    Compares the deck's old signal path for a 44.1 kHz file on a 48 kHz device,
+    where the transport corrected the sample rate and a second resampler applied
+    the speed, with the single stage that now does both. Reports the per-deck
+    cost and the residual after a sine fit (see SineFit.h) for each.
+
+  ==============================================================================
+*/
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include "../Source/QualityResamplingAudioSource.h"
+#include "SineFit.h"
+
+namespace {
+
+constexpr double fileRate = 44100.0;
+constexpr double deviceRate = 48000.0;
+constexpr int numChannels = 2;
+constexpr int blockSize = 512;
+constexpr double secondsToRender = 20.0;
+constexpr double testFrequency = 1000.0;
+
+/** A whole number of cycles at the file rate, so the loop point is seamless */
+AudioBuffer<float> makeTestSignal() {
+    auto numSamples = static_cast<int>(fileRate * 10.0);
+    AudioBuffer<float> signal(numChannels, numSamples);
+
+    for (int chan = 0; chan < numChannels; ++chan) {
+        auto* samples = signal.getWritePointer(chan);
+        for (int i = 0; i < numSamples; ++i)
+            samples[i] = 0.5f * static_cast<float>(std::sin(MathConstants<double>::twoPi * testFrequency * i / fileRate));
+    }
+
+    return signal;
+}
+
+struct Result {
+    double averageSeconds = 0.0;
+    double residualDecibels = 0.0;
+};
+
+/** Renders from the given source, timing each block and capturing one second after the filters settle */
+Result run(AudioSource& source, double expectedFrequency) {
+    constexpr int settleBlocks = 10;
+
+    AudioBuffer<float> output(numChannels, blockSize);
+    AudioBuffer<float> capture(1, static_cast<int>(deviceRate));
+    auto numBlocks = static_cast<int>(secondsToRender * deviceRate / blockSize);
+
+    double totalSeconds = 0.0;
+    int captured = 0;
+
+    for (int block = 0; block < numBlocks; ++block) {
+        auto start = Time::getHighResolutionTicks();
+        source.getNextAudioBlock(AudioSourceChannelInfo(output));
+        totalSeconds += Time::highResolutionTicksToSeconds(Time::getHighResolutionTicks() - start);
+
+        if (block >= settleBlocks && captured < capture.getNumSamples()) {
+            auto numToCopy = jmin(blockSize, capture.getNumSamples() - captured);
+            capture.copyFrom(0, captured, output, 0, 0, numToCopy);
+            captured += numToCopy;
+        }
+    }
+
+    Result result;
+    result.averageSeconds = totalSeconds / numBlocks;
+    result.residualDecibels = getSineFitResidualDecibels(capture.getReadPointer(0), captured, expectedFrequency, deviceRate);
+    return result;
+}
+
+void printRow(const String& path, double speed, const Result& result) {
+    auto coreFraction = result.averageSeconds / (blockSize / deviceRate);
+
+    std::cout << path.paddedRight(' ', 24)
+              << (String(speed, 2) + "x").paddedRight(' ', 8)
+              << String(result.averageSeconds * 1.0e6, 1).paddedLeft(' ', 12)
+              << String(coreFraction * 100.0, 2).paddedLeft(' ', 12)
+              << String(result.residualDecibels, 1).paddedLeft(' ', 14) << std::endl;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    ignoreUnused(argc, argv);
+    ScopedJuceInitialiser_GUI juceInitialiser;
+
+    auto signal = makeTestSignal();
+    MemoryAudioSource source(signal, false, true);
+
+    std::cout << "44.1 kHz file on a 48 kHz device, " << numChannels << " channels, "
+              << blockSize << "-sample blocks, " << testFrequency << " Hz test tone" << std::endl << std::endl;
+
+    std::cout << String("path").paddedRight(' ', 24)
+              << String("speed").paddedRight(' ', 8)
+              << String("us/block").paddedLeft(' ', 12)
+              << String("% of core").paddedLeft(' ', 12)
+              << String("residual dB").paddedLeft(' ', 14) << std::endl;
+
+    for (auto speed : { 0.92, 1.0, 1.08, 1.5 }) {
+        auto expectedFrequency = testFrequency * speed;
+
+        {
+            // Before: the transport converts 44.1k to 48k, then the speed is applied at 48k
+            AudioTransportSource transport;
+            transport.setSource(&source, 0, nullptr, fileRate);
+            ResamplingAudioSource speedStage(&transport, false, numChannels);
+            speedStage.setResamplingRatio(speed);
+            speedStage.prepareToPlay(blockSize, deviceRate);
+            source.setNextReadPosition(0);
+            transport.start();
+
+            printRow("transport + Fast", speed, run(speedStage, expectedFrequency));
+
+            speedStage.releaseResources();
+            transport.setSource(nullptr);
+        }
+
+        using Quality = QualityResamplingAudioSource::Quality;
+
+        for (auto quality : { Quality::fast, Quality::sinc, Quality::highQuality }) {
+            // After: the transport plays at the file rate and one stage converts speed and rate together
+            AudioTransportSource transport;
+            transport.setSource(&source);
+            QualityResamplingAudioSource combinedStage(&transport, numChannels);
+            combinedStage.setQuality(quality);
+            combinedStage.setResamplingRatio(speed * fileRate / deviceRate);
+            combinedStage.prepareToPlay(blockSize, deviceRate);
+            source.setNextReadPosition(0);
+            transport.start();
+
+            printRow("single " + QualityResamplingAudioSource::getQualityName(quality), speed,
+                     run(combinedStage, expectedFrequency));
+
+            combinedStage.releaseResources();
+            transport.setSource(nullptr);
+        }
+    }
+
+    return 0;
+}
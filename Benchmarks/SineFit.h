@@ -0,0 +1,48 @@
+/*
+  ==============================================================================
+
+    SineFit.h
+    Created: 17 Oct 2026 12:21:36am
+
+    Accuracy measure shared by the resampling benchmarks: the level of whatever
+    is left after a least-squares fit of a sine at the expected frequency. The
+    fit absorbs gain and delay, so only distortion, aliasing and noise count.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "../JuceLibraryCode/JuceHeader.h"
+
+/**
+ * Gets the residual after fitting a sine at the given frequency, in dB relative to the fit
+ * @param samples The signal to measure
+ * @param numSamples Number of samples to measure
+ * @param frequency Expected frequency of the sine in Hz
+ * @param sampleRate Sample rate of the signal
+ */
+inline double getSineFitResidualDecibels(const float* samples, int numSamples, double frequency, double sampleRate) {
+    auto omega = MathConstants<double>::twoPi * frequency / sampleRate;
+    double ss = 0.0, sc = 0.0, cc = 0.0, xs = 0.0, xc = 0.0;
+
+    for (int i = 0; i < numSamples; ++i) {
+        auto s = std::sin(omega * i);
+        auto c = std::cos(omega * i);
+        ss += s * s; sc += s * c; cc += c * c;
+        xs += samples[i] * s; xc += samples[i] * c;
+    }
+
+    auto determinant = ss * cc - sc * sc;
+    auto a = (xs * cc - xc * sc) / determinant;
+    auto b = (xc * ss - xs * sc) / determinant;
+
+    double signalPower = 0.0, residualPower = 0.0;
+    for (int i = 0; i < numSamples; ++i) {
+        auto fit = a * std::sin(omega * i) + b * std::cos(omega * i);
+        signalPower += fit * fit;
+        residualPower += (samples[i] - fit) * (samples[i] - fit);
+    }
+
+    return Decibels::gainToDecibels(std::sqrt(residualPower / jmax(signalPower, 1.0e-30)), -200.0);
+}
@@ -0,0 +1,98 @@
+/*
+  ==============================================================================
+
+    TimeStretchBenchmark.cpp
+    Created: 16 Oct 2026 10:58:40pm
+
+    Measures the per-deck CPU cost of the key lock time-stretch stage at tempo
+    ratios from 0.5x to 2x, rendering in device-sized blocks from a looping
+    in-memory source so only the stretcher itself is timed.
+
+  ==============================================================================
+*/
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include "../Source/TimeStretchAudioSource.h"
+
+namespace {
+
+constexpr double sampleRate = 48000.0;
+constexpr int numChannels = 2;
+constexpr int blockSize = 512;
+constexpr double secondsToRender = 60.0;
+
+AudioBuffer<float> makeTestSignal(int numSamples) {
+    AudioBuffer<float> signal(numChannels, numSamples);
+    Random random(7);
+
+    // A few harmonics and some noise, so the frame search has real work to do
+    for (int chan = 0; chan < numChannels; ++chan) {
+        auto* samples = signal.getWritePointer(chan);
+        for (int i = 0; i < numSamples; ++i) {
+            auto t = static_cast<float>(i) / static_cast<float>(sampleRate);
+            samples[i] = 0.3f * std::sin(MathConstants<float>::twoPi * 110.0f * t)
+                       + 0.2f * std::sin(MathConstants<float>::twoPi * 440.0f * t + static_cast<float>(chan))
+                       + 0.1f * std::sin(MathConstants<float>::twoPi * 1760.0f * t)
+                       + 0.05f * (random.nextFloat() - 0.5f);
+        }
+    }
+
+    return signal;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    ignoreUnused(argc, argv);
+    ScopedJuceInitialiser_GUI juceInitialiser;
+
+    auto signal = makeTestSignal(static_cast<int>(sampleRate * 30.0));
+    MemoryAudioSource source(signal, false, true);
+
+    TimeStretchAudioSource stretcher(&source, numChannels);
+    stretcher.prepareToPlay(blockSize, sampleRate);
+
+    AudioBuffer<float> output(numChannels, blockSize);
+    auto numBlocks = static_cast<int>(secondsToRender * sampleRate / blockSize);
+    auto blockSeconds = blockSize / sampleRate;
+
+    std::cout << "Time-stretch cost per deck, " << numChannels << " channels at " << sampleRate
+              << " Hz, " << blockSize << "-sample blocks, latency "
+              << stretcher.getLatencySamples() << " samples" << std::endl << std::endl;
+
+    std::cout << String("tempo").paddedRight(' ', 8)
+              << String("us/block").paddedLeft(' ', 12)
+              << String("worst us").paddedLeft(' ', 12)
+              << String("% of core").paddedLeft(' ', 12)
+              << String("decks/core").paddedLeft(' ', 12) << std::endl;
+
+    for (auto tempo : { 0.5, 0.75, 0.9, 1.0, 1.1, 1.25, 1.5, 2.0 }) {
+        stretcher.setTempo(tempo);
+        stretcher.flushBuffers();
+        source.setNextReadPosition(0);
+
+        double totalSeconds = 0.0;
+        double worstSeconds = 0.0;
+
+        for (int block = 0; block < numBlocks; ++block) {
+            auto start = Time::getHighResolutionTicks();
+            stretcher.getNextAudioBlock(AudioSourceChannelInfo(output));
+            auto elapsed = Time::highResolutionTicksToSeconds(Time::getHighResolutionTicks() - start);
+
+            totalSeconds += elapsed;
+            worstSeconds = jmax(worstSeconds, elapsed);
+        }
+
+        auto averageSeconds = totalSeconds / numBlocks;
+        auto coreFraction = averageSeconds / blockSeconds;
+
+        std::cout << (String(tempo, 2) + "x").paddedRight(' ', 8)
+                  << String(averageSeconds * 1.0e6, 1).paddedLeft(' ', 12)
+                  << String(worstSeconds * 1.0e6, 1).paddedLeft(' ', 12)
+                  << String(coreFraction * 100.0, 2).paddedLeft(' ', 12)
+                  << String(1.0 / coreFraction, 0).paddedLeft(' ', 12) << std::endl;
+    }
+
+    stretcher.releaseResources();
+    return 0;
+}
@@ -0,0 +1,134 @@
+/*
+  ==============================================================================
+
+    WaveformKernelBenchmark.cpp
+    Created: 16 Oct 2026 8:31:07pm
+
+    Times the waveform analysis kernels against each other, and building a
+    WaveformPyramid against the AudioThumbnail path it replaces, on ten minutes
+    of synthetic stereo audio fed in decoder-sized blocks.
+
+  ==============================================================================
+*/
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include "../Source/PeakKernels.h"
+#include "../Source/WaveformPyramid.h"
+
+namespace {
+
+constexpr double sampleRate = 44100.0;
+constexpr int numChannels = 2;
+constexpr int blockSize = 65536;
+constexpr int numRuns = 5;
+
+/** Runs a task several times and returns the fastest time in seconds */
+template <typename Task>
+double timeBest(Task&& task) {
+    double best = std::numeric_limits<double>::max();
+
+    for (int run = 0; run < numRuns; ++run) {
+        auto start = Time::getHighResolutionTicks();
+        task();
+        best = jmin(best, Time::highResolutionTicksToSeconds(Time::getHighResolutionTicks() - start));
+    }
+
+    return best;
+}
+
+AudioBuffer<float> makeTestSignal(int numSamples) {
+    AudioBuffer<float> signal(numChannels, numSamples);
+    Random random(42);
+
+    for (int chan = 0; chan < numChannels; ++chan) {
+        auto* samples = signal.getWritePointer(chan);
+        for (int i = 0; i < numSamples; ++i)
+            samples[i] = 0.5f * std::sin(static_cast<float>(i) * 0.031f * static_cast<float>(chan + 1))
+                       + 0.2f * (random.nextFloat() - 0.5f);
+    }
+
+    return signal;
+}
+
+/** Feeds the signal to a consumer in blocks, as the track loader would */
+template <typename Consumer>
+void feedInBlocks(const AudioBuffer<float>& signal, Consumer&& consumer) {
+    for (int start = 0; start < signal.getNumSamples(); start += blockSize) {
+        auto numThisTime = jmin(blockSize, signal.getNumSamples() - start);
+        AudioBuffer<float> block(const_cast<float* const*>(signal.getArrayOfReadPointers()),
+                                 numChannels, start, numThisTime);
+        consumer(block, numThisTime, start);
+    }
+}
+
+void printResult(const String& name, double seconds, double baselineSeconds, int64 numSamples) {
+    auto megasamplesPerSecond = static_cast<double>(numSamples) * numChannels / seconds / 1.0e6;
+
+    std::cout << name.paddedRight(' ', 28)
+              << String(seconds * 1000.0, 2).paddedLeft(' ', 10) << " ms"
+              << String(megasamplesPerSecond, 1).paddedLeft(' ', 10) << " Msamples/s"
+              << String(baselineSeconds / seconds, 2).paddedLeft(' ', 8) << "x" << std::endl;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    ignoreUnused(argc, argv);
+    ScopedJuceInitialiser_GUI juceInitialiser;
+
+    auto numSamples = static_cast<int>(sampleRate * 600.0);
+    auto signal = makeTestSignal(numSamples);
+
+    std::cout << "Waveform analysis, " << numChannels << " channels x " << numSamples << " samples, best of "
+              << numRuns << " runs" << std::endl << std::endl;
+
+    //==========================================================================
+    std::cout << "Kernels, " << WaveformPyramid::minBaseBinSize << "-sample bins:" << std::endl;
+
+    std::vector<PeakKernels::Stats> stats(static_cast<size_t>(numSamples / WaveformPyramid::minBaseBinSize));
+    double scalarSeconds = 0.0;
+
+    for (const auto& implementation : PeakKernels::getAvailableImplementations()) {
+        auto seconds = timeBest([&] {
+            for (int chan = 0; chan < numChannels; ++chan)
+                implementation.analyseBins(signal.getReadPointer(chan), static_cast<int>(stats.size()),
+                                           WaveformPyramid::minBaseBinSize, stats.data());
+        });
+
+        if (scalarSeconds == 0.0)
+            scalarSeconds = seconds;
+
+        printResult(implementation.name, seconds, scalarSeconds, numSamples);
+    }
+
+    //==========================================================================
+    std::cout << std::endl << "Full build from decoded blocks:" << std::endl;
+
+    AudioFormatManager formatManager;
+    AudioThumbnailCache thumbCache(1);
+
+    auto thumbnailSeconds = timeBest([&] {
+        AudioThumbnail thumbnail(1000, formatManager, thumbCache);
+        thumbnail.reset(numChannels, sampleRate, numSamples);
+
+        feedInBlocks(signal, [&](const AudioBuffer<float>& block, int numThisTime, int start) {
+            thumbnail.addBlock(start, block, 0, numThisTime);
+        });
+    });
+
+    auto pyramidSeconds = timeBest([&] {
+        WaveformPyramid pyramid(numChannels, sampleRate, numSamples);
+
+        feedInBlocks(signal, [&](const AudioBuffer<float>& block, int numThisTime, int) {
+            pyramid.addBlock(block, numThisTime);
+        });
+
+        pyramid.finish();
+    });
+
+    printResult("AudioThumbnail", thumbnailSeconds, thumbnailSeconds, numSamples);
+    printResult(String("WaveformPyramid (") + PeakKernels::getBestImplementation().name + ")",
+                pyramidSeconds, thumbnailSeconds, numSamples);
+
+    return 0;
+}
@@ -0,0 +1,194 @@
+/*
+  ==============================================================================
+
+    AudioCallbackProfiler.cpp
+    Created: 17 Oct 2026 2:55:08am
+
+  ==============================================================================
+*/
+
+#include "AudioCallbackProfiler.h"
+
+namespace {
+
+constexpr size_t maxMarkers = 1024;
+
+/** A callback starting this much later than the previous block ran out is flagged as late */
+constexpr double lateStartTolerance = 0.5;
+
+/** Smoothing of the load meter per callback; about a third of a second at typical block sizes */
+constexpr float loadSmoothing = 0.03f;
+
+} // namespace
+
+//==============================================================================
+AudioCallbackProfiler::AudioCallbackProfiler()
+    : records(new CallbackRecord[capacity]) {
+}
+
+AudioCallbackProfiler::~AudioCallbackProfiler() {
+}
+
+double AudioCallbackProfiler::beginCallback() noexcept {
+    current.deckStartOffsetMs.fill(0.0f);
+    current.deckDurationMs.fill(0.0f);
+    current.startMs = Time::getMillisecondCounterHiRes();
+    return current.startMs;
+}
+
+void AudioCallbackProfiler::setDeckTiming(int deck, double startMs, double durationMs) noexcept {
+    if (!isPositiveAndBelow(deck, maxDecks))
+        return;
+
+    current.deckStartOffsetMs[static_cast<size_t>(deck)] = static_cast<float>(startMs - current.startMs);
+    current.deckDurationMs[static_cast<size_t>(deck)] = static_cast<float>(durationMs);
+}
+
+void AudioCallbackProfiler::flagEvent(Flags flag) noexcept {
+    pendingFlags.fetch_or(flag, std::memory_order_relaxed);
+}
+
+void AudioCallbackProfiler::endCallback(double startMs, int numSamples, double sampleRate, int numDecks) noexcept {
+    auto endMs = Time::getMillisecondCounterHiRes();
+
+    current.startMs = startMs;
+    current.durationMs = static_cast<float>(endMs - startMs);
+    current.budgetMs = sampleRate > 0.0 ? static_cast<float>(1000.0 * numSamples / sampleRate) : 0.0f;
+    current.numSamples = numSamples;
+    current.numDecks = jmin(numDecks, maxDecks);
+    current.flags = pendingFlags.exchange(0, std::memory_order_relaxed);
+
+    if (current.budgetMs > 0.0f && current.durationMs > current.budgetMs) {
+        current.flags |= missedDeadline;
+        missedDeadlines.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // The device asks for the next block about when the previous one runs out; much later means a gap
+    if (previousStartMs > 0.0 && startMs - previousStartMs > previousBudgetMs * (1.0 + lateStartTolerance) + 1.0) {
+        current.flags |= lateStart;
+        lateStarts.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    previousStartMs = startMs;
+    previousBudgetMs = current.budgetMs;
+
+    auto load = current.budgetMs > 0.0f ? current.durationMs / current.budgetMs : 0.0f;
+    smoothedLoad.store(smoothedLoad.load(std::memory_order_relaxed) + loadSmoothing * (load - smoothedLoad.load(std::memory_order_relaxed)),
+                       std::memory_order_relaxed);
+
+    auto peak = peakLoad.load(std::memory_order_relaxed);
+    while (load > peak && !peakLoad.compare_exchange_weak(peak, load, std::memory_order_relaxed)) {
+    }
+
+    auto index = numWritten.load(std::memory_order_relaxed);
+    records[static_cast<size_t>(index % capacity)] = current;
+    numWritten.store(index + 1, std::memory_order_release);
+}
+
+//==============================================================================
+void AudioCallbackProfiler::addMarker(const String& text) {
+    const ScopedLock lock(markerLock);
+
+    markers.push_back({ Time::getMillisecondCounterHiRes(), text });
+    if (markers.size() > maxMarkers)
+        markers.pop_front();
+}
+
+AudioCallbackProfiler::Summary AudioCallbackProfiler::getSummary() noexcept {
+    Summary summary;
+    summary.load = smoothedLoad.load(std::memory_order_relaxed);
+    summary.peakLoad = peakLoad.exchange(0.0f, std::memory_order_relaxed);
+    summary.numCallbacks = numWritten.load(std::memory_order_relaxed);
+    summary.missedDeadlines = missedDeadlines.load(std::memory_order_relaxed);
+    summary.lateStarts = lateStarts.load(std::memory_order_relaxed);
+    return summary;
+}
+
+std::vector<AudioCallbackProfiler::CallbackRecord> AudioCallbackProfiler::getRecords() const {
+    auto end = numWritten.load(std::memory_order_acquire);
+    auto start = jmax(static_cast<int64>(0), end - capacity);
+
+    std::vector<CallbackRecord> copy;
+    copy.reserve(static_cast<size_t>(end - start));
+
+    for (auto i = start; i < end; ++i)
+        copy.push_back(records[static_cast<size_t>(i % capacity)]);
+
+    // The audio thread kept writing while this copied; drop whatever it overwrote, and the slot it may be writing now
+    auto overwritten = jmax(static_cast<int64>(0), numWritten.load(std::memory_order_acquire) + 1 - capacity - start);
+    copy.erase(copy.begin(), copy.begin() + static_cast<std::ptrdiff_t>(jmin(overwritten, static_cast<int64>(copy.size()))));
+
+    return copy;
+}
+
+bool AudioCallbackProfiler::exportTrace(const File& file) const {
+    auto callbacks = getRecords();
+
+    std::deque<Marker> markersCopy;
+    {
+        const ScopedLock lock(markerLock);
+        markersCopy = markers;
+    }
+
+    // Chrome trace events: timestamps and durations in microseconds, one row (tid) per deck
+    Array<var> events;
+    auto addEvent = [&events](const String& name, const String& phase, double timeMs, double durationMs, int tid, var args) {
+        auto* event = new DynamicObject();
+        event->setProperty("name", name);
+        event->setProperty("ph", phase);
+        event->setProperty("ts", timeMs * 1000.0);
+        if (phase == "X")
+            event->setProperty("dur", durationMs * 1000.0);
+        else
+            event->setProperty("s", "g");
+        event->setProperty("pid", 1);
+        event->setProperty("tid", tid);
+        if (!args.isVoid())
+            event->setProperty("args", args);
+        events.add(var(event));
+    };
+
+    for (auto& record : callbacks) {
+        auto* args = new DynamicObject();
+        args->setProperty("samples", record.numSamples);
+        args->setProperty("budget_ms", record.budgetMs);
+        args->setProperty("load", record.budgetMs > 0.0f ? record.durationMs / record.budgetMs : 0.0f);
+        addEvent("callback", "X", record.startMs, record.durationMs, 0, var(args));
+
+        for (int deck = 0; deck < record.numDecks; ++deck) {
+            auto index = static_cast<size_t>(deck);
+            if (record.deckDurationMs[index] > 0.0f)
+                addEvent("deck " + String(deck + 1), "X", record.startMs + record.deckStartOffsetMs[index],
+                         record.deckDurationMs[index], deck + 1, {});
+        }
+
+        if ((record.flags & missedDeadline) != 0)
+            addEvent("missed deadline", "i", record.startMs + record.durationMs, 0.0, 0, {});
+        if ((record.flags & lateStart) != 0)
+            addEvent("late callback", "i", record.startMs, 0.0, 0, {});
+        if ((record.flags & trackSwapped) != 0)
+            addEvent("track swapped in", "i", record.startMs, 0.0, 0, {});
+        if ((record.flags & readAheadEmpty) != 0)
+            addEvent("read-ahead underrun", "i", record.startMs, 0.0, 0, {});
+    }
+
+    for (auto& marker : markersCopy)
+        addEvent(marker.text, "i", marker.timeMs, 0.0, 0, {});
+
+    auto* root = new DynamicObject();
+    root->setProperty("traceEvents", events);
+    root->setProperty("displayTimeUnit", "ms");
+
+    return file.replaceWithText(JSON::toString(var(root), true));
+}
+
+void AudioCallbackProfiler::reset() {
+    {
+        const ScopedLock lock(markerLock);
+        markers.clear();
+    }
+
+    missedDeadlines = 0;
+    lateStarts = 0;
+    peakLoad = 0.0f;
+}
@@ -0,0 +1,129 @@
+/*
+  ==============================================================================
+
+    AudioCallbackProfiler.h
+    Created: 17 Oct 2026 2:55:08am
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "../JuceLibraryCode/JuceHeader.h"
+
+/**
+ * @class AudioCallbackProfiler
+ * @brief Always-on timing of the audio callback, shared by the whole app
+ *
+ * The audio thread records each callback's duration, its deadline, how late it
+ * started and how long every deck took, into a fixed ring of records. Nothing on
+ * that path locks or allocates: a record is two clock reads and a few stores.
+ *
+ * The UI reads summary counters for the load meter, and can export the ring,
+ * together with markers such as track loads from the message thread, as a Chrome
+ * trace (chrome://tracing or ui.perfetto.dev) to line glitches up with events.
+ *
+ * Shared through SharedResourcePointer, like the other app-wide services, so any
+ * component can add markers without being handed the profiler.
+ */
+class AudioCallbackProfiler {
+public:
+    /** Decks whose render time is recorded per callback */
+    static constexpr int maxDecks = 16;
+
+    /** Callbacks kept in the ring, a few minutes at typical block sizes */
+    static constexpr int capacity = 16384;
+
+    /** Things that happened during a callback */
+    enum Flags : uint32 {
+        missedDeadline  = 1 << 0,   /**< The callback took longer than its block lasts */
+        lateStart       = 1 << 1,   /**< The callback started well after the previous block ran out */
+        trackSwapped    = 1 << 2,   /**< A deck swapped in a newly loaded track */
+        readAheadEmpty  = 1 << 3    /**< A deck's read-ahead buffer ran dry */
+    };
+
+    /** Timing of one audio callback; times are Time::getMillisecondCounterHiRes() values */
+    struct CallbackRecord {
+        double startMs = 0.0;
+        float durationMs = 0.0f;
+        float budgetMs = 0.0f;
+        int numSamples = 0;
+        int numDecks = 0;
+        uint32 flags = 0;
+        std::array<float, maxDecks> deckStartOffsetMs{};
+        std::array<float, maxDecks> deckDurationMs{};
+    };
+
+    /** A message-thread event, e.g. a track load starting */
+    struct Marker {
+        double timeMs = 0.0;
+        String text;
+    };
+
+    /** Summary for the load meter */
+    struct Summary {
+        float load = 0.0f;          /**< Smoothed callback time as a proportion of the deadline */
+        float peakLoad = 0.0f;      /**< Highest load since the last call to getSummary() */
+        int64 numCallbacks = 0;
+        int64 missedDeadlines = 0;
+        int64 lateStarts = 0;
+    };
+
+    AudioCallbackProfiler();
+    ~AudioCallbackProfiler();
+
+    //==========================================================================
+    // Audio thread
+    //==========================================================================
+
+    /** Marks the start of a callback, returning its start time */
+    double beginCallback() noexcept;
+
+    /** Records when one deck started rendering in the current callback and how long it took */
+    void setDeckTiming(int deck, double startMs, double durationMs) noexcept;
+
+    /** Flags an event for the current callback; safe from any thread */
+    void flagEvent(Flags flag) noexcept;
+
+    /** Finishes the record for the current callback */
+    void endCallback(double startMs, int numSamples, double sampleRate, int numDecks) noexcept;
+
+    //==========================================================================
+    // Message thread
+    //==========================================================================
+
+    /** Adds a marker at the current time */
+    void addMarker(const String& text);
+
+    /** Gets the load meter summary and starts a new peak */
+    Summary getSummary() noexcept;
+
+    /** Copies the recorded callbacks, oldest first, skipping any overwritten while copying */
+    std::vector<CallbackRecord> getRecords() const;
+
+    /** Writes the ring and the markers as a Chrome trace event file */
+    bool exportTrace(const File& file) const;
+
+    /** Forgets the markers, deadline counters and peak; recorded callbacks age out of the ring */
+    void reset();
+
+private:
+    std::unique_ptr<CallbackRecord[]> records;
+    std::atomic<int64> numWritten{0};
+
+    // Staging for the callback in progress (audio thread)
+    CallbackRecord current;
+    double previousStartMs = 0.0;
+    double previousBudgetMs = 0.0;
+    std::atomic<uint32> pendingFlags{0};
+
+    std::atomic<float> smoothedLoad{0.0f};
+    std::atomic<float> peakLoad{0.0f};
+    std::atomic<int64> missedDeadlines{0};
+    std::atomic<int64> lateStarts{0};
+
+    CriticalSection markerLock;
+    std::deque<Marker> markers;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(AudioCallbackProfiler)
+};
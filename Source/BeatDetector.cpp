@@ -0,0 +1,252 @@
+/*
+  ==============================================================================
+
+    BeatDetector.cpp
+    Created: 17 Oct 2026 3:48:12am
+
+  ==============================================================================
+*/
+
+#include "BeatDetector.h"
+
+namespace {
+
+// 93 ms frames every 11.6 ms at the analysis rate: fine enough in frequency to separate kick
+// from bass, and in time to place a beat within a few milliseconds
+constexpr int fftOrder = 10;
+constexpr int fftSize = 1 << fftOrder;
+constexpr int hopSize = 128;
+
+/** Scales magnitudes before the log so quiet onsets still register */
+constexpr float logCompression = 1000.0f;
+
+/** Top of the kick and bass band used to tell beats from offbeats, in Hz */
+constexpr double lowBandHz = 150.0;
+
+/** How regularly the low band must repeat for it to place the beats */
+constexpr double minLowBandConfidence = 0.2;
+
+/** Length of the moving average taken off the onset strength, in seconds */
+constexpr double localMeanSeconds = 0.5;
+
+/** Tempo the autocorrelation leans towards, and how far the lean reaches, in octaves */
+constexpr double preferredBpm = 120.0;
+constexpr double tempoPreferenceOctaves = 1.0;
+
+/** Range and step of the fine tempo search around the rough estimate */
+constexpr double refineRange = 0.03;
+constexpr double refineStepBpm = 0.02;
+
+/** Shortest track worth analysing */
+constexpr double minSeconds = 8.0;
+
+/** Onset strength per frame, across the whole spectrum and in the kick and bass band alone */
+struct OnsetStrength {
+    std::vector<float> allBands;
+    std::vector<float> lowBand;
+};
+
+/** Takes the local mean off an onset curve, so steady loud passages don't count as onsets */
+std::vector<float> removeLocalMean(const std::vector<float>& flux, int halfWidth) {
+    auto numFrames = static_cast<int>(flux.size());
+
+    std::vector<double> prefix(flux.size() + 1, 0.0);
+    for (size_t i = 0; i < flux.size(); ++i)
+        prefix[i + 1] = prefix[i] + flux[i];
+
+    std::vector<float> onsets(flux.size());
+    for (int f = 0; f < numFrames; ++f) {
+        auto from = jmax(0, f - halfWidth);
+        auto to = jmin(numFrames, f + halfWidth + 1);
+        auto mean = (prefix[static_cast<size_t>(to)] - prefix[static_cast<size_t>(from)]) / (to - from);
+        onsets[static_cast<size_t>(f)] = jmax(0.0f, flux[static_cast<size_t>(f)] - static_cast<float>(mean));
+    }
+
+    return onsets;
+}
+
+/** Computes the onset strength of every frame as the summed rise in log magnitude over the bins */
+OnsetStrength computeOnsetStrength(const float* samples, int numSamples, double sampleRate,
+                                   const std::function<bool()>& shouldExit) {
+    auto numFrames = 1 + (numSamples - fftSize) / hopSize;
+
+    dsp::FFT fft(fftOrder);
+    std::vector<float> window(fftSize);
+    for (int i = 0; i < fftSize; ++i)
+        window[static_cast<size_t>(i)] = 0.5f - 0.5f * std::cos(MathConstants<float>::twoPi * static_cast<float>(i) / fftSize);
+
+    std::vector<float> frame(static_cast<size_t>(fftSize) * 2);
+    std::vector<float> previous(fftSize / 2 + 1, 0.0f);
+    std::vector<float> flux(static_cast<size_t>(numFrames), 0.0f);
+    std::vector<float> lowFlux(static_cast<size_t>(numFrames), 0.0f);
+
+    auto lowBins = jlimit(1, fftSize / 2, roundToInt(lowBandHz * fftSize / sampleRate));
+
+    for (int f = 0; f < numFrames; ++f) {
+        if (shouldExit && (f & 1023) == 0 && shouldExit())
+            return {};
+
+        FloatVectorOperations::multiply(frame.data(), samples + f * hopSize, window.data(), fftSize);
+        fft.performFrequencyOnlyForwardTransform(frame.data(), true);
+
+        auto rise = 0.0f;
+        auto lowRise = 0.0f;
+        for (int bin = 1; bin <= fftSize / 2; ++bin) {
+            auto magnitude = std::log1p(logCompression * frame[static_cast<size_t>(bin)]);
+            rise += jmax(0.0f, magnitude - previous[static_cast<size_t>(bin)]);
+            previous[static_cast<size_t>(bin)] = magnitude;
+
+            if (bin == lowBins)
+                lowRise = rise;
+        }
+
+        // The first frame rises from silence everywhere, which is no onset
+        flux[static_cast<size_t>(f)] = f > 0 ? rise : 0.0f;
+        lowFlux[static_cast<size_t>(f)] = f > 0 ? lowRise : 0.0f;
+    }
+
+    auto halfWidth = jmax(1, roundToInt(localMeanSeconds * sampleRate / hopSize * 0.5));
+    return { removeLocalMean(flux, halfWidth), removeLocalMean(lowFlux, halfWidth) };
+}
+
+/** Interpolates the position of a peak from the values either side of it */
+double interpolatePeak(double left, double centre, double right) {
+    auto denominator = left - 2.0 * centre + right;
+    return denominator < 0.0 ? jlimit(-0.5, 0.5, 0.5 * (left - right) / denominator) : 0.0;
+}
+
+/** Estimates the beat period in frames from the autocorrelation of the onset strength */
+double estimateBeatPeriod(const std::vector<float>& onsets, double framesPerSecond) {
+    auto minLag = jmax(2, static_cast<int>(std::floor(framesPerSecond * 60.0 / BeatDetector::maxBpm)));
+    auto maxLag = static_cast<int>(std::ceil(framesPerSecond * 60.0 / BeatDetector::minBpm));
+    auto numFrames = static_cast<int>(onsets.size());
+
+    // Twice the longest lag, so each period can also be scored on the bar-level repeat at double its length
+    std::vector<double> correlation(static_cast<size_t>(2 * maxLag + 2), 0.0);
+    for (int lag = minLag; lag < static_cast<int>(correlation.size()) && lag < numFrames; ++lag) {
+        auto sum = 0.0;
+        for (int n = 0; n + lag < numFrames; ++n)
+            sum += static_cast<double>(onsets[static_cast<size_t>(n)]) * onsets[static_cast<size_t>(n + lag)];
+        correlation[static_cast<size_t>(lag)] = sum / (numFrames - lag);
+    }
+
+    auto scoreAt = [&](int lag) {
+        auto bpm = framesPerSecond * 60.0 / lag;
+        auto octaves = std::log2(bpm / preferredBpm) / tempoPreferenceOctaves;
+        return (correlation[static_cast<size_t>(lag)] + 0.5 * correlation[static_cast<size_t>(2 * lag)])
+             * std::exp(-0.5 * octaves * octaves);
+    };
+
+    auto bestLag = minLag;
+    for (int lag = minLag; lag <= maxLag; ++lag)
+        if (scoreAt(lag) > scoreAt(bestLag))
+            bestLag = lag;
+
+    if (bestLag > minLag && bestLag < maxLag)
+        return bestLag + interpolatePeak(scoreAt(bestLag - 1), scoreAt(bestLag), scoreAt(bestLag + 1));
+
+    return bestLag;
+}
+
+/** Sums the onset strength at every beat of a grid given in frames */
+double sumOnBeats(const std::vector<float>& onsets, double firstFrame, double period) {
+    auto sum = 0.0;
+    for (auto position = firstFrame; position < static_cast<double>(onsets.size() - 1); position += period) {
+        auto index = static_cast<size_t>(position);
+        auto fraction = static_cast<float>(position - static_cast<double>(index));
+        sum += onsets[index] + fraction * (onsets[index + 1] - onsets[index]);
+    }
+    return sum;
+}
+
+/**
+ * Measures how strongly the onsets repeat every period frames, as the onset strength's
+ * Fourier component at that period; its argument gives the phase of the repeats
+ */
+std::complex<double> measurePeriodicity(const std::vector<float>& onsets, double period) {
+    auto step = std::polar(1.0, -MathConstants<double>::twoPi / period);
+    std::complex<double> phasor(1.0, 0.0);
+    std::complex<double> sum(0.0, 0.0);
+
+    for (size_t n = 0; n < onsets.size(); ++n) {
+        sum += static_cast<double>(onsets[n]) * phasor;
+        phasor *= step;
+
+        // Keeps rounding from building up over tens of thousands of steps
+        if ((n & 4095) == 4095)
+            phasor /= std::abs(phasor);
+    }
+
+    return sum;
+}
+
+} // namespace
+
+//==============================================================================
+BeatGrid BeatDetector::analyse(const float* samples, int numSamples, double sampleRate,
+                               const std::function<bool()>& shouldExit) {
+    if (samples == nullptr || sampleRate <= 0.0 || numSamples < fftSize || numSamples < minSeconds * sampleRate)
+        return {};
+
+    auto strength = computeOnsetStrength(samples, numSamples, sampleRate, shouldExit);
+    const auto& onsets = strength.allBands;
+    if (onsets.empty())
+        return {};
+
+    auto framesPerSecond = sampleRate / hopSize;
+    auto roughPeriod = estimateBeatPeriod(onsets, framesPerSecond);
+    auto roughBpm = framesPerSecond * 60.0 / roughPeriod;
+
+    if (shouldExit && shouldExit())
+        return {};
+
+    // Every beat in the track sharpens this peak, so it pins the tempo down far more finely than the lag can
+    auto numSteps = static_cast<int>(std::ceil(roughBpm * refineRange / refineStepBpm));
+    std::vector<double> strengths(static_cast<size_t>(2 * numSteps + 1));
+    auto bestStep = 0;
+
+    for (int i = 0; i < static_cast<int>(strengths.size()); ++i) {
+        auto bpm = roughBpm + (i - numSteps) * refineStepBpm;
+        strengths[static_cast<size_t>(i)] = std::abs(measurePeriodicity(onsets, framesPerSecond * 60.0 / bpm));
+
+        if (strengths[static_cast<size_t>(i)] > strengths[static_cast<size_t>(bestStep)])
+            bestStep = i;
+    }
+
+    auto offset = 0.0;
+    if (bestStep > 0 && bestStep + 1 < static_cast<int>(strengths.size()))
+        offset = interpolatePeak(strengths[static_cast<size_t>(bestStep - 1)], strengths[static_cast<size_t>(bestStep)],
+                                 strengths[static_cast<size_t>(bestStep + 1)]);
+
+    BeatGrid grid;
+    grid.bpm = jlimit(minBpm, maxBpm, roughBpm + (bestStep - numSteps + offset) * refineStepBpm);
+
+    auto period = framesPerSecond * 60.0 / grid.bpm;
+    auto periodicity = measurePeriodicity(onsets, period);
+
+    // The kick and bass mark the beat in most dance music, so they place it when they repeat clearly enough
+    auto lowPeriodicity = measurePeriodicity(strength.lowBand, period);
+    auto totalLowOnsets = std::accumulate(strength.lowBand.begin(), strength.lowBand.end(), 0.0);
+    auto phase = std::abs(lowPeriodicity) > minLowBandConfidence * totalLowOnsets ? std::arg(lowPeriodicity)
+                                                                                   : std::arg(periodicity);
+
+    // The onsets peak at frames firstFrame + k * period, where the component's phase is -2 pi firstFrame / period
+    auto firstFrame = -phase * period / MathConstants<double>::twoPi;
+    firstFrame -= std::floor(firstFrame / period) * period;
+
+    // Hi-hats and snares can repeat as strongly as the kick, half a beat off; the kick and bass decide
+    auto halfBeatLater = firstFrame + period * 0.5;
+    if (sumOnBeats(strength.lowBand, halfBeatLater, period) > sumOnBeats(strength.lowBand, firstFrame, period))
+        firstFrame = halfBeatLater;
+
+    // With the log compression a frame registers an onset as soon as it reaches the tail of its window;
+    // the rise is steepest about a hop and a half before the window's end
+    auto frameOnsetOffset = fftSize - 1.5 * hopSize;
+    auto firstBeat = (firstFrame * hopSize + frameOnsetOffset) / sampleRate;
+    grid.firstBeatSeconds = firstBeat - std::floor(firstBeat / grid.getBeatLengthSeconds()) * grid.getBeatLengthSeconds();
+
+    auto totalOnsets = std::accumulate(onsets.begin(), onsets.end(), 0.0);
+    grid.confidence = totalOnsets > 0.0 ? static_cast<float>(jlimit(0.0, 1.0, std::abs(periodicity) / totalOnsets)) : 0.0f;
+
+    return grid;
+}
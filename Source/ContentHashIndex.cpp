@@ -0,0 +1,100 @@
+/*
+  ==============================================================================
+
+    ContentHashIndex.cpp
+    Created: 16 Oct 2026 2:48:31pm
+
+  ==============================================================================
+*/
+
+#include "ContentHashIndex.h"
+
+//==============================================================================
+ContentHashIndex::ContentHashIndex()
+    : indexFile(File::getSpecialLocation(File::userApplicationDataDirectory)
+                    .getChildFile("OtoDecks")
+                    .getChildFile("ContentHashes.xml")) {
+    load();
+}
+
+ContentHashIndex::~ContentHashIndex() {
+    save();
+}
+
+String ContentHashIndex::getHash(const File& file, String* previousHash) {
+    auto path = file.getFullPathName();
+    auto modificationTime = file.getLastModificationTime().toMilliseconds();
+    auto size = file.getSize();
+
+    {
+        const ScopedLock sl(lock);
+        auto found = entries.find(path);
+
+        if (found != entries.end()) {
+            if (found->second.modificationTime == modificationTime && found->second.size == size)
+                return found->second.hash;
+
+            if (previousHash != nullptr)
+                *previousHash = found->second.hash;
+        }
+    }
+
+    if (!file.existsAsFile())
+        return {};
+
+    // Hash outside the lock, other threads may be looking up files that are already known
+    auto hash = MD5(file).toHexString();
+
+    const ScopedLock sl(lock);
+    entries[path] = { modificationTime, size, hash };
+
+    if (++unsavedChanges >= 32)
+        save();
+
+    return hash;
+}
+
+void ContentHashIndex::forget(const File& file) {
+    const ScopedLock sl(lock);
+
+    if (entries.erase(file.getFullPathName()) > 0)
+        ++unsavedChanges;
+}
+
+void ContentHashIndex::save() {
+    const ScopedLock sl(lock);
+
+    if (unsavedChanges == 0)
+        return;
+
+    XmlElement root("CONTENT_HASHES");
+
+    for (const auto& [path, entry] : entries) {
+        auto* e = root.createNewChildElement("FILE");
+        e->setAttribute("path", path);
+        e->setAttribute("mtime", String(entry.modificationTime));
+        e->setAttribute("size", String(entry.size));
+        e->setAttribute("hash", entry.hash);
+    }
+
+    indexFile.getParentDirectory().createDirectory();
+
+    if (root.writeTo(indexFile))
+        unsavedChanges = 0;
+    else
+        DBG("ContentHashIndex: could not write " + indexFile.getFullPathName());
+}
+
+void ContentHashIndex::load() {
+    auto root = parseXMLIfTagMatches(indexFile, "CONTENT_HASHES");
+    if (root == nullptr)
+        return;
+
+    for (auto* e : root->getChildWithTagNameIterator("FILE")) {
+        Entry entry;
+        entry.modificationTime = e->getStringAttribute("mtime").getLargeIntValue();
+        entry.size = e->getStringAttribute("size").getLargeIntValue();
+        entry.hash = e->getStringAttribute("hash");
+        entries[e->getStringAttribute("path")] = entry;
+    }
+}
@@ -0,0 +1,59 @@
+/*
+  ==============================================================================
+
+    ContentHashIndex.h
+    Created: 16 Oct 2026 2:48:31pm
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "../JuceLibraryCode/JuceHeader.h"
+
+/**
+ * @class ContentHashIndex
+ * @brief Remembers the content hash of every file it has seen, keyed by path
+ *
+ * Hashing a file means reading all of it, so the hash is only recomputed when the
+ * file's modification time or size no longer match the stored entry. The index is
+ * kept in the application data folder so it survives restarts. Hold it through a
+ * SharedResourcePointer; it is safe to use from several threads.
+ */
+class ContentHashIndex {
+public:
+    ContentHashIndex();
+    ~ContentHashIndex();
+
+    /**
+     * Gets the MD5 hash of a file's content as a hex string
+     * @param file The file to hash
+     * @param previousHash If not null, receives the old hash when the file has changed since it was
+     *                     last seen, so callers can drop anything stored under that hash
+     * @return The hash, or an empty string if the file can't be read
+     */
+    String getHash(const File& file, String* previousHash = nullptr);
+
+    /** Forgets a file, so its hash is recomputed next time */
+    void forget(const File& file);
+
+    /** Writes the index to disk if it has changed */
+    void save();
+
+private:
+    struct Entry {
+        int64 modificationTime = 0;
+        int64 size = 0;
+        String hash;
+    };
+
+    /** Reads the index from disk */
+    void load();
+
+    File indexFile;
+    std::map<String, Entry> entries;
+    int unsavedChanges = 0;
+    CriticalSection lock;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ContentHashIndex)
+};
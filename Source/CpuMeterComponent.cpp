@@ -0,0 +1,95 @@
+/*
+  ==============================================================================
+
+    CpuMeterComponent.cpp
+    Created: 17 Oct 2026 3:21:40am
+
+  ==============================================================================
+*/
+
+#include "CpuMeterComponent.h"
+
+//==============================================================================
+CpuMeterComponent::CpuMeterComponent(AudioDeviceManager& deviceManager)
+    : deviceManager(deviceManager) {
+    addAndMakeVisible(traceButton);
+    traceButton.addListener(this);
+    traceButton.setTooltip("Save the recent audio callback timings as a Chrome trace");
+    traceButton.setColour(TextButton::buttonColourId, Colour(60, 60, 90));
+    traceButton.setColour(TextButton::textColourOffId, Colours::white);
+
+    startTimerHz(10);
+}
+
+CpuMeterComponent::~CpuMeterComponent() {
+    stopTimer();
+    traceButton.removeListener(this);
+}
+
+//==============================================================================
+void CpuMeterComponent::paint(Graphics& g) {
+    auto area = getLocalBounds();
+    area.removeFromRight(traceButton.getWidth() + 8);
+
+    auto textArea = area.removeFromRight(140);
+    auto bar = area.reduced(0, area.getHeight() / 4).toFloat();
+
+    g.setColour(Colours::black.withAlpha(0.4f));
+    g.fillRoundedRectangle(bar, 3.0f);
+
+    // Green while there is headroom, amber when close, red when callbacks overrun
+    auto load = jlimit(0.0f, 1.0f, summary.load);
+    auto colour = load < 0.6f ? Colour(0, 180, 0) : load < 0.85f ? Colour(220, 160, 0) : Colour(200, 0, 0);
+
+    g.setColour(colour);
+    g.fillRoundedRectangle(bar.withWidth(bar.getWidth() * load), 3.0f);
+
+    auto peakX = bar.getX() + bar.getWidth() * jlimit(0.0f, 1.0f, summary.peakLoad);
+    g.setColour(Colours::white.withAlpha(0.8f));
+    g.drawVerticalLine(roundToInt(peakX), bar.getY(), bar.getBottom());
+
+    g.setColour(Colours::white.withAlpha(0.3f));
+    g.drawRoundedRectangle(bar, 3.0f, 1.0f);
+
+    auto xruns = deviceXRuns >= 0 ? static_cast<int64>(deviceXRuns) : summary.missedDeadlines;
+
+    g.setColour(xruns > 0 ? Colours::orange : Colours::white);
+    g.setFont(Font(13.0f));
+    g.drawFittedText("DSP " + String(roundToInt(summary.load * 100.0f)) + "%  xruns " + String(xruns),
+                     textArea.withTrimmedLeft(8), Justification::centredLeft, 1);
+}
+
+void CpuMeterComponent::resized() {
+    traceButton.setBounds(getLocalBounds().removeFromRight(70).reduced(0, 2));
+}
+
+void CpuMeterComponent::buttonClicked(Button* button) {
+    if (button != &traceButton)
+        return;
+
+    auto defaultFile = File::getSpecialLocation(File::userDocumentsDirectory)
+                           .getChildFile("OtoDecks trace " + Time::getCurrentTime().formatted("%Y-%m-%d %H-%M-%S") + ".json");
+    fileChooser = std::make_unique<FileChooser>("Save audio trace...", defaultFile, "*.json");
+
+    auto flags = FileBrowserComponent::saveMode | FileBrowserComponent::warnAboutOverwriting;
+    fileChooser->launchAsync(flags, [this](const FileChooser& chooser) {
+        auto file = chooser.getResult();
+        if (file != File() && !profiler->exportTrace(file))
+            DBG("CpuMeterComponent: could not write trace to " + file.getFullPathName());
+    });
+}
+
+//==============================================================================
+void CpuMeterComponent::timerCallback() {
+    summary = profiler->getSummary();
+
+    deviceXRuns = -1;
+    if (auto* device = deviceManager.getCurrentAudioDevice())
+        deviceXRuns = device->getXRunCount();
+
+    if (deviceXRuns > lastDeviceXRuns && lastDeviceXRuns >= 0)
+        profiler->addMarker("Device xrun x" + String(deviceXRuns - lastDeviceXRuns));
+
+    lastDeviceXRuns = deviceXRuns;
+    repaint();
+}
@@ -0,0 +1,72 @@
+/*
+  ==============================================================================
+
+    CpuMeterComponent.h
+    Created: 17 Oct 2026 3:21:40am
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include "AudioCallbackProfiler.h"
+
+/**
+ * @class CpuMeterComponent
+ * @brief Live audio load and xrun meter, with a button to export a callback trace
+ *
+ * The bar shows the smoothed share of each block's deadline spent in the audio
+ * callback, with a tick at the peak since the last refresh. The counter shows the
+ * device's own xrun count where the driver reports one, and the callbacks that
+ * overran their deadline otherwise.
+ *
+ * New device xruns are added to the profiler as markers, so they line up with the
+ * callbacks around them in an exported trace.
+ */
+class CpuMeterComponent : public Component,
+                          public Button::Listener,
+                          private Timer {
+public:
+    /**
+     * Constructor for CpuMeterComponent
+     * @param deviceManager The device whose xruns are counted
+     */
+    explicit CpuMeterComponent(AudioDeviceManager& deviceManager);
+
+    /** Destructor */
+    ~CpuMeterComponent() override;
+
+    //==========================================================================
+    // Component overrides
+    //==========================================================================
+
+    /** Draws the load bar and counters */
+    void paint(Graphics& g) override;
+
+    /** Lays out the export button */
+    void resized() override;
+
+    //==========================================================================
+    // Button::Listener overrides
+    //==========================================================================
+
+    /** Asks where to save the trace and writes it */
+    void buttonClicked(Button* button) override;
+
+private:
+    /** Refreshes the readings from the profiler and the device */
+    void timerCallback() override;
+
+    AudioDeviceManager& deviceManager;
+    SharedResourcePointer<AudioCallbackProfiler> profiler;
+
+    TextButton traceButton{"TRACE"};
+    std::unique_ptr<FileChooser> fileChooser;
+
+    AudioCallbackProfiler::Summary summary;
+    int deviceXRuns = -1;
+    int lastDeviceXRuns = -1;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(CpuMeterComponent)
+};
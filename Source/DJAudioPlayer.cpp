@@ -12,37 +12,153 @@
 
 #include "DJAudioPlayer.h"
 
-DJAudioPlayer::DJAudioPlayer(AudioFormatManager& formatManager) 
+DJAudioPlayer::DJAudioPlayer(AudioFormatManager& formatManager)
     : formatManager(formatManager) {
+    hotCues.fill(-1);
 }
 
 DJAudioPlayer::~DJAudioPlayer() {
+    stopTimer();
+    cancelLoad();
+    setSyncMaster(false);
+
+    if (trackAnalyser != nullptr)
+        trackAnalyser->cancel();
+
+    for (auto* job : cancelledJobs)
+        loaderPool->removeJob(job, true, 10000);
+
+    for (auto* job : windowJobs)
+        loaderPool->removeJob(job, true, 10000);
+
+    delete pendingWindows.exchange(nullptr);
+    delete activeWindows.exchange(nullptr);
+    delete retiredWindows.exchange(nullptr);
+
+    delete pendingTrack.exchange(nullptr);
+    delete activeTrack.exchange(nullptr);
+    delete retiredTrack.exchange(nullptr);
 }
 
 void DJAudioPlayer::prepareToPlay(int samplesPerBlockExpected, double sampleRate) {
-    transportSource.prepareToPlay(samplesPerBlockExpected, sampleRate);
+    currentBlockSize = samplesPerBlockExpected;
+    currentSampleRate = sampleRate;
+
+    // A track that is waiting to be swapped in was prepared for the old settings
+    if (auto* pending = pendingTrack.load())
+        pending->transport.prepareToPlay(samplesPerBlockExpected, sampleRate);
+
+    gainRamp.reset(sampleRate, gainRampSeconds);
+    speedRamp.reset(sampleRate, speedRampSeconds);
+    playRamp.reset(sampleRate, playRampSeconds);
+
+    // The stretcher prepares the rate stage feeding it
     resampleSource.prepareToPlay(samplesPerBlockExpected, sampleRate);
+    stretchSource.prepareToPlay(samplesPerBlockExpected, sampleRate);
 }
 
 void DJAudioPlayer::getNextAudioBlock(const AudioSourceChannelInfo& bufferToFill) {
-    resampleSource.getNextAudioBlock(bufferToFill);
+    auto callbackTimeMs = Time::getMillisecondCounterHiRes();
+
+    swapInPendingTrack();
+
+    auto* track = activeTrack.load();
+    syncPlayheadClock(track);
+    swapInPendingWindows(track);
+
+    // The transport plays at the file's own rate, so the conversion to the device rate is folded into the speed stage
+    auto deviceRate = currentSampleRate.load();
+    fileRateRatio = track != nullptr && deviceRate > 0.0 ? track->sampleRate / deviceRate : 1.0;
+
+    commandQueue.drain([this, track](const DeckCommand& command) { applyCommand(command, track); });
+
+    // A stopped deck stops pulling audio once its fade-out has finished, and any deck once the end of the track is heard
+    auto running = track != nullptr && audiblePosition < static_cast<double>(track->lengthInSamples)
+                && (playRamp.getCurrentValue() > 0.0f || playRamp.getTargetValue() > 0.0f);
+
+    // The mixer stamps each chunk with where it starts on the output timeline shared by all decks
+    auto timelineSample = tempoSync->getTimelinePosition();
+    auto* beatGrid = getFinishedBeatGrid(track);
+
+    // A stopped deck lines its beats up again when it next starts
+    if (!running)
+        syncLocked = false;
+    else if (syncActive && beatGrid != nullptr)
+        followMaster(track, *beatGrid, timelineSample);
+
+    auto samplesConsumed = 0.0;
+    if (running) {
+        auto* readAhead = track->bufferedSource.get();
+        auto underrunsBefore = readAhead != nullptr ? readAhead->getUnderrunCount() : 0;
+
+        samplesConsumed = renderAtSpeed(bufferToFill);
+        applyGainRamps(bufferToFill);
+
+        if (readAhead != nullptr && readAhead->getUnderrunCount() != underrunsBefore)
+            profiler->flagEvent(AudioCallbackProfiler::readAheadEmpty);
+    }
+    else {
+        bufferToFill.clearActiveBufferRegion();
+    }
+
+    publishPlayheadClock(track, running, samplesConsumed, callbackTimeMs);
+
+    if (running && beatGrid != nullptr && tempoSync->isMaster(this))
+        publishMasterTempo(track, *beatGrid, timelineSample + bufferToFill.numSamples);
+
+    currentSpeed.store(speedRamp.getCurrentValue(), std::memory_order_relaxed);
 }
 
 void DJAudioPlayer::releaseResources() {
-    transportSource.releaseResources();
     resampleSource.releaseResources();
+    stretchSource.releaseResources();
 }
 
-void DJAudioPlayer::loadURL(URL audioURL) {
-    auto* reader = formatManager.createReaderFor(audioURL.createInputStream(false));
-    if (reader != nullptr) {
-        std::unique_ptr<AudioFormatReaderSource> newSource(new AudioFormatReaderSource(reader, true)); 
-        transportSource.setSource(newSource.get(), 0, nullptr, reader->sampleRate);             
-        readerSource.reset(newSource.release());          
-    }
-    else {
-        DBG("DJAudioPlayer::loadURL failed to load audio file: " + audioURL.toString(false));
+bool DJAudioPlayer::loadURL(URL audioURL, const Array<std::shared_ptr<DecodeSink>>& sinks) {
+    TrackLoadJob job(audioURL, formatManager, getLoadSettings(), beginAnalysis(audioURL, sinks));
+    job.runJob();
+
+    auto track = job.takeResult();
+    finishAnalysis(track != nullptr);
+
+    if (track != nullptr) {
+        track->analyser = trackAnalyser;
+        setTrackAutoGain(*track);
+        publishTrack(std::move(track));
+        profiler->addMarker("Loaded " + audioURL.getFileName());
+        return true;
     }
+
+    DBG("DJAudioPlayer::loadURL failed to load audio file: " + audioURL.toString(false));
+    return false;
+}
+
+void DJAudioPlayer::loadURLAsync(URL audioURL, const Array<std::shared_ptr<DecodeSink>>& sinks) {
+    cancelLoad();
+
+    loadJob = std::make_unique<TrackLoadJob>(audioURL, formatManager, getLoadSettings(), beginAnalysis(audioURL, sinks));
+    loaderPool->addJob(loadJob.get(), false);
+    profiler->addMarker("Load started: " + audioURL.getFileName());
+
+    startTimer(50);
+}
+
+void DJAudioPlayer::cancelLoad() {
+    if (loadJob == nullptr)
+        return;
+
+    finishAnalysis(false);
+
+    // A job stuck in a slow open can't be deleted yet, so park it until the pool lets go
+    if (!loaderPool->removeJob(loadJob.get(), true, 0))
+        cancelledJobs.add(loadJob.release());
+
+    loadJob.reset();
+    profiler->addMarker("Load cancelled");
+}
+
+bool DJAudioPlayer::isLoading() const {
+    return loadJob != nullptr;
 }
 
 void DJAudioPlayer::setGain(double gain) {
@@ -50,7 +166,7 @@ void DJAudioPlayer::setGain(double gain) {
         DBG("DJAudioPlayer::setGain gain should be between 0 and 1, got: " + String(gain));
     }
     else {
-        transportSource.setGain(gain);
+        sendCommand(DeckCommand::Type::setGain, gain);
     }
 }
 
@@ -59,12 +175,12 @@ void DJAudioPlayer::setSpeed(double ratio) {
         DBG("DJAudioPlayer::setSpeed ratio should be between 0 and 100, got: " + String(ratio));
     }
     else {
-        resampleSource.setResamplingRatio(ratio);
+        sendCommand(DeckCommand::Type::setSpeed, ratio);
     }
 }
 
 void DJAudioPlayer::setPosition(double posInSecs) {
-    transportSource.setPosition(posInSecs);
+    sendCommand(DeckCommand::Type::setPosition, posInSecs);
 }
 
 void DJAudioPlayer::setPositionRelative(double pos) {
@@ -72,22 +188,1113 @@ void DJAudioPlayer::setPositionRelative(double pos) {
         DBG("DJAudioPlayer::setPositionRelative pos should be between 0 and 1, got: " + String(pos));
     }
     else {
-        double posInSecs = transportSource.getLengthInSeconds() * pos;
-        setPosition(posInSecs);
+        sendCommand(DeckCommand::Type::setPositionRelative, pos);
     }
 }
 
 void DJAudioPlayer::start() {
-    transportSource.start();
+    sendCommand(DeckCommand::Type::start);
 }
 
 void DJAudioPlayer::stop() {
-    transportSource.stop();
+    sendCommand(DeckCommand::Type::stop);
+}
+
+void DJAudioPlayer::setKeyLock(bool shouldKeepPitch) {
+    keyLock = shouldKeepPitch;
+    sendCommand(DeckCommand::Type::setKeyLock, shouldKeepPitch ? 1.0 : 0.0);
+}
+
+bool DJAudioPlayer::isKeyLockEnabled() const {
+    return keyLock;
+}
+
+void DJAudioPlayer::setResamplerQuality(QualityResamplingAudioSource::Quality quality) {
+    resamplerQuality = quality;
+    sendCommand(DeckCommand::Type::setResamplerQuality, static_cast<double>(quality));
+}
+
+QualityResamplingAudioSource::Quality DJAudioPlayer::getResamplerQuality() const {
+    return resamplerQuality;
+}
+
+int DJAudioPlayer::getTimeStretchLatencySamples() const {
+    return stretchSource.getLatencySamples();
+}
+
+double DJAudioPlayer::getPositionRelative() const {
+    if (auto* track = activeTrack.load()) {
+        if (track->lengthInSamples > 0)
+            return static_cast<double>(track->transport.getNextReadPosition()) / static_cast<double>(track->lengthInSamples);
+    }
+    return 0.0;
+}
+
+double DJAudioPlayer::getAudiblePositionRelative() const {
+    if (!playheadClock.hasPublished())
+        return getPositionRelative();
+
+    auto snapshot = playheadClock.read();
+    if (snapshot.lengthInSamples <= 0)
+        return 0.0;
+
+    return playheadClock.getSamplePositionAt(Time::getMillisecondCounterHiRes())
+         / static_cast<double>(snapshot.lengthInSamples);
+}
+
+void DJAudioPlayer::setOutputLatencySamples(int numSamples) {
+    outputLatencySamples = jmax(0, numSamples);
+}
+
+DeckCommandQueue::Stats DJAudioPlayer::getCommandQueueStats() const {
+    return commandQueue.getStats();
+}
+
+int64 DJAudioPlayer::getReadAheadLockWaits() const {
+    if (auto* track = activeTrack.load())
+        if (track->bufferedSource != nullptr)
+            return track->bufferedSource->getRangeLockWaits();
+    return 0;
+}
+
+void DJAudioPlayer::setReadAheadSamples(int numSamples) {
+    if (numSamples < 0) {
+        DBG("DJAudioPlayer::setReadAheadSamples numSamples should not be negative, got: " + String(numSamples));
+    }
+    else {
+        readAheadSamples = numSamples;
+    }
+}
+
+int DJAudioPlayer::getReadAheadSamples() const {
+    return readAheadSamples;
+}
+
+int DJAudioPlayer::getUnderrunCount() const {
+    if (auto* track = activeTrack.load())
+        if (track->bufferedSource != nullptr)
+            return track->bufferedSource->getUnderrunCount();
+    return 0;
+}
+
+int64 DJAudioPlayer::getUnderrunSamples() const {
+    if (auto* track = activeTrack.load())
+        if (track->bufferedSource != nullptr)
+            return track->bufferedSource->getUnderrunSamples();
+    return 0;
+}
+
+void DJAudioPlayer::resetUnderrunCounters() {
+    if (auto* track = activeTrack.load())
+        if (track->bufferedSource != nullptr)
+            track->bufferedSource->resetUnderrunCounters();
+}
+
+void DJAudioPlayer::setPlaybackMode(PlaybackMode newMode) {
+    playbackMode = newMode;
+}
+
+DJAudioPlayer::PlaybackMode DJAudioPlayer::getPlaybackMode() const {
+    return playbackMode;
+}
+
+bool DJAudioPlayer::isPlayingFromMemory() const {
+    if (auto* track = activeTrack.load())
+        return track->isInMemory();
+    return false;
+}
+
+size_t DJAudioPlayer::getMemoryUsageBytes() const {
+    size_t total = 0;
+
+    // A track waiting to swap in or out still holds its share of the budget
+    for (auto* track : { pendingTrack.load(), activeTrack.load(), retiredTrack.load() })
+        if (track != nullptr)
+            total += track->memoryReservation.getNumBytes();
+
+    return total;
+}
+
+TrackMemoryBudget& DJAudioPlayer::getMemoryBudget() {
+    return *memoryBudget;
+}
+
+void DJAudioPlayer::setUsePcmCache(bool shouldUse) {
+    usePcmCache = shouldUse;
+}
+
+bool DJAudioPlayer::isUsingPcmCache() const {
+    return usePcmCache;
+}
+
+bool DJAudioPlayer::isPlayingFromPcmCache() const {
+    if (auto* track = activeTrack.load())
+        return track->fromPcmCache;
+    return false;
+}
+
+PcmCache& DJAudioPlayer::getPcmCache() {
+    return *pcmCache;
 }
 
-double DJAudioPlayer::getPositionRelative() {
-    if (transportSource.getLengthInSeconds() > 0.0) {
-        return transportSource.getCurrentPosition() / transportSource.getLengthInSeconds();
+//==============================================================================
+// Track hand-over
+//==============================================================================
+
+TrackLoadSettings DJAudioPlayer::getLoadSettings() const {
+    TrackLoadSettings settings;
+    settings.sampleRate = currentSampleRate.load();
+    settings.blockSize = currentBlockSize.load();
+    settings.readAheadSamples = readAheadSamples;
+    settings.decodeToMemory = playbackMode == PlaybackMode::inMemory;
+    settings.usePcmCache = usePcmCache;
+    return settings;
+}
+
+void DJAudioPlayer::publishTrack(std::unique_ptr<LoadedTrack> track) {
+    // Cues and loops belong to the track they were set on, and windows still being read are no use
+    for (auto* job : windowJobs)
+        job->signalJobShouldExit();
+
+    hotCues.fill(-1);
+    loopIn = -1;
+    loop = {};
+    windows = TrackWindowSet();
+    windows.track = track.get();
+    publishWindows();
+
+    // A streaming track is handed over before the decode pass behind it has measured its loudness
+    auto loudnessKnown = track->analyser == nullptr || track->analyser->getLoudness().isValid();
+    trackAwaitingLoudness = loudnessKnown ? nullptr : track.get();
+
+    // If the audio thread hasn't picked up the previous track yet, that one is simply replaced
+    delete pendingTrack.exchange(track.release());
+
+    // Before the player has been prepared there is no audio thread to hand over to
+    if (currentSampleRate.load() <= 0.0)
+        swapInPendingTrack();
+
+    startTimer(50);
+}
+
+void DJAudioPlayer::swapInPendingTrack() {
+    // Only swap when the retired slot is free, so a swapped-out track is never lost
+    if (pendingTrack.load() == nullptr || retiredTrack.load() != nullptr)
+        return;
+
+    if (auto* incoming = pendingTrack.exchange(nullptr)) {
+        retiredTrack.store(activeTrack.exchange(incoming));
+        profiler->flagEvent(AudioCallbackProfiler::trackSwapped);
     }
+}
+
+void DJAudioPlayer::collectRetiredTrack() {
+    auto* retired = retiredTrack.exchange(nullptr);
+    if (retired == trackAwaitingLoudness)
+        trackAwaitingLoudness = nullptr;
+
+    delete retired;
+}
+
+void DJAudioPlayer::applyMeasuredAutoGain() {
+    if (trackAwaitingLoudness == nullptr)
+        return;
+
+    auto& analyser = *trackAwaitingLoudness->analyser;
+    if (!analyser.getLoudness().isValid() && !analyser.isFinished())
+        return;
+
+    setTrackAutoGain(*trackAwaitingLoudness);
+    trackAwaitingLoudness = nullptr;
+
+    // Sending the setting again has the audio thread ramp to the track's new gain
+    sendCommand(DeckCommand::Type::setAutoGain, autoGain ? 1.0 : 0.0);
+}
+
+void DJAudioPlayer::finishLoad() {
+    auto url = loadJob->getURL();
+    auto track = loadJob->takeResult();
+    loadJob.reset();
+
+    bool loaded = track != nullptr;
+    finishAnalysis(loaded);
+
+    if (loaded) {
+        track->analyser = trackAnalyser;
+        setTrackAutoGain(*track);
+        publishTrack(std::move(track));
+        profiler->addMarker("Load finished: " + url.getFileName());
+    }
+    else {
+        DBG("DJAudioPlayer::loadURLAsync failed to load audio file: " + url.toString(false));
+        profiler->addMarker("Load failed: " + url.getFileName());
+    }
+
+    if (onLoadFinished)
+        onLoadFinished(url, loaded);
+}
+
+void DJAudioPlayer::timerCallback() {
+    collectRetiredTrack();
+    applyMeasuredAutoGain();
+    collectWindows();
+
+    if (!analysisReported && trackAnalyser->isFinished()) {
+        analysisReported = true;
+
+        auto grid = getBeatGrid();
+        auto key = getKey();
+        profiler->addMarker(grid.isValid() || key.isValid()
+                                ? "Analysed: " + String(grid.bpm, 2) + " BPM, key " + (key.isValid() ? key.getName() : String("unknown"))
+                                : String("Analysis failed"));
+
+        if (onAnalysisFinished)
+            onAnalysisFinished();
+    }
+
+    for (int i = cancelledJobs.size(); --i >= 0;) {
+        if (!loaderPool->contains(cancelledJobs[i]))
+            cancelledJobs.remove(i);
+    }
+
+    if (loadJob != nullptr) {
+        if (!loaderPool->contains(loadJob.get()))
+            finishLoad();
+        else if (onLoadProgress)
+            onLoadProgress(loadJob->getProgress());
+    }
+
+    if (loadJob == nullptr && cancelledJobs.isEmpty() && analysisReported && trackAwaitingLoudness == nullptr
+        && pendingTrack.load() == nullptr && retiredTrack.load() == nullptr
+        && windowJobs.isEmpty() && pendingWindows.load() == nullptr && retiredWindows.load() == nullptr
+        && lingeringWindow == nullptr)
+        stopTimer();
+}
+
+//==============================================================================
+// Track analysis
+//==============================================================================
+
+void DJAudioPlayer::setAnalyseOnLoad(bool shouldAnalyse) {
+    analyseOnLoad = shouldAnalyse;
+}
+
+bool DJAudioPlayer::isAnalysingOnLoad() const {
+    return analyseOnLoad;
+}
+
+bool DJAudioPlayer::isAnalysing() const {
+    return trackAnalyser != nullptr && !trackAnalyser->isFinished();
+}
+
+std::shared_ptr<const TrackAnalysis> DJAudioPlayer::getAnalysis() const {
+    if (trackAnalyser != nullptr && trackAnalyser->isFinished())
+        return trackAnalyser->getResult();
+    return nullptr;
+}
+
+BeatGrid DJAudioPlayer::getBeatGrid() const {
+    if (auto analysis = getAnalysis())
+        return analysis->beatGrid;
+    return {};
+}
+
+MusicalKey DJAudioPlayer::getKey() const {
+    if (auto analysis = getAnalysis())
+        return analysis->key;
+    return {};
+}
+
+void DJAudioPlayer::setAutoGain(bool shouldNormalise) {
+    autoGain = shouldNormalise;
+    sendCommand(DeckCommand::Type::setAutoGain, shouldNormalise ? 1.0 : 0.0);
+}
+
+bool DJAudioPlayer::isAutoGainEnabled() const {
+    return autoGain;
+}
+
+Loudness DJAudioPlayer::getLoudness() const {
+    if (trackAnalyser != nullptr)
+        return trackAnalyser->getLoudness();
+    return {};
+}
+
+double DJAudioPlayer::getAutoGainDb() const {
+    if (auto* track = activeTrack.load())
+        return Decibels::gainToDecibels(track->autoGain.load());
     return 0.0;
-}
\ No newline at end of file
+}
+
+void DJAudioPlayer::setSyncEnabled(bool shouldSync) {
+    syncEnabled = shouldSync;
+    sendCommand(DeckCommand::Type::setSync, shouldSync ? 1.0 : 0.0);
+}
+
+bool DJAudioPlayer::isSyncEnabled() const {
+    return syncEnabled;
+}
+
+void DJAudioPlayer::setSyncMaster(bool shouldBeMaster) {
+    if (shouldBeMaster)
+        tempoSync->setMaster(this);
+    else if (isSyncMaster())
+        tempoSync->setMaster(nullptr);
+}
+
+bool DJAudioPlayer::isSyncMaster() const {
+    return tempoSync->isMaster(this);
+}
+
+double DJAudioPlayer::getCurrentSpeed() const {
+    return currentSpeed.load(std::memory_order_relaxed);
+}
+
+Array<std::shared_ptr<DecodeSink>> DJAudioPlayer::beginAnalysis(const URL& audioURL, const Array<std::shared_ptr<DecodeSink>>& sinks) {
+    if (pendingAnalyser != nullptr)
+        pendingAnalyser->cancel();
+
+    pendingAnalyser.reset();
+    if (!analyseOnLoad)
+        return sinks;
+
+    pendingAnalyser = std::make_shared<TrackAnalyser>(*analysisPool, audioURL.isLocalFile() ? audioURL.getLocalFile() : File());
+
+    auto sinksWithAnalysis = sinks;
+    sinksWithAnalysis.add(pendingAnalyser);
+    return sinksWithAnalysis;
+}
+
+void DJAudioPlayer::finishAnalysis(bool loaded) {
+    auto analyser = std::move(pendingAnalyser);
+    pendingAnalyser.reset();
+
+    if (!loaded) {
+        if (analyser != nullptr)
+            analyser->cancel();
+        return;
+    }
+
+    // The previous track's analysis is no use once the new track is loaded
+    if (trackAnalyser != nullptr)
+        trackAnalyser->cancel();
+
+    trackAnalyser = std::move(analyser);
+    analysisReported = trackAnalyser == nullptr;
+}
+
+void DJAudioPlayer::setTrackAutoGain(LoadedTrack& track) const {
+    // The loudness comes from the finished decode pass, or the remembered analysis
+    auto loudness = track.analyser != nullptr ? track.analyser->getLoudness() : Loudness();
+    auto gainDb = loudness.getNormalisationGainDb(autoGainTargetLufs, autoGainMaxTruePeakDb);
+
+    track.autoGain = Decibels::decibelsToGain(static_cast<float>(jlimit(minAutoGainDb, maxAutoGainDb, gainDb)));
+}
+
+float DJAudioPlayer::getTargetGain(const LoadedTrack* track) const noexcept {
+    return autoGainActive && track != nullptr ? userGain * track->autoGain.load(std::memory_order_relaxed) : userGain;
+}
+
+//==============================================================================
+// Commands and ramps
+//==============================================================================
+
+void DJAudioPlayer::sendCommand(DeckCommand::Type type, double value) {
+    if (!commandQueue.push({ type, value }))
+        DBG("DJAudioPlayer: command queue full, dropped a command");
+}
+
+void DJAudioPlayer::applyCommand(const DeckCommand& command, LoadedTrack* track) {
+    switch (command.type) {
+        case DeckCommand::Type::setGain:
+            userGain = static_cast<float>(command.value);
+            gainRamp.setTargetValue(getTargetGain(track));
+            break;
+
+        case DeckCommand::Type::setSpeed:
+            speedRamp.setTargetValue(command.value);
+            break;
+
+        case DeckCommand::Type::setPosition:
+        case DeckCommand::Type::setPositionRelative:
+            if (track != nullptr) {
+                // The transport has no rate correction, so its positions are in file samples
+                auto samplePosition = command.type == DeckCommand::Type::setPosition
+                                          ? command.value * track->sampleRate
+                                          : command.value * static_cast<double>(track->lengthInSamples);
+                activeTrackSource.setPosition(static_cast<int64>(samplePosition));
+                flushSpeedStages();
+
+                // Every stage has been flushed, so the source's position is exactly the next sample out
+                audiblePosition = static_cast<double>(activeTrackSource.getPosition());
+                syncLocked = false;
+            }
+            break;
+
+        case DeckCommand::Type::jumpToCue:
+            if (track != nullptr) {
+                auto target = command.value;
+
+                // A synced deck lands as far from a beat as it is now, so it stays in phase with the master
+                if (auto* grid = syncActive ? getFinishedBeatGrid(track) : nullptr) {
+                    auto beatLength = track->sampleRate * grid->getBeatLengthSeconds();
+                    auto beatsAway = (static_cast<double>(activeTrackSource.getPosition()) - target) / beatLength;
+                    target += (beatsAway - std::round(beatsAway)) * beatLength;
+                    if (target < 0.0)
+                        target += beatLength;
+                }
+
+                // The speed stages keep what they have buffered, so the jump is as seamless as a loop wrap
+                activeTrackSource.jumpTo(static_cast<int64>(std::round(target)));
+            }
+            break;
+
+        case DeckCommand::Type::setKeyLock:
+            if (keyLockActive != (command.value != 0.0)) {
+                keyLockActive = command.value != 0.0;
+                realignSpeedStages(track);
+            }
+            break;
+
+        case DeckCommand::Type::setResamplerQuality: {
+            auto quality = static_cast<QualityResamplingAudioSource::Quality>(static_cast<int>(command.value));
+            if (resampleSource.getQuality() != quality) {
+                resampleSource.setQuality(quality);
+                rateSource.setQuality(quality);
+                realignSpeedStages(track);
+            }
+            break;
+        }
+
+        case DeckCommand::Type::setSync:
+            // Leaving sync keeps whatever speed the deck was synced to
+            syncActive = command.value != 0.0;
+            syncLocked = false;
+            speedRamp.setCurrentAndTargetValue(speedRamp.getCurrentValue());
+            break;
+
+        case DeckCommand::Type::setAutoGain:
+            autoGainActive = command.value != 0.0;
+            gainRamp.setTargetValue(getTargetGain(track));
+            break;
+
+        case DeckCommand::Type::start:
+            // The transport was started by the loader and is never stopped, so starting is just the gate
+            playRamp.setTargetValue(1.0f);
+            break;
+
+        case DeckCommand::Type::stop:
+            playRamp.setTargetValue(0.0f);
+            break;
+    }
+}
+
+double DJAudioPlayer::renderAtSpeed(const AudioSourceChannelInfo& bufferToFill) {
+    if (!speedRamp.isSmoothing()) {
+        return renderStep(bufferToFill, speedRamp.getTargetValue()) * bufferToFill.numSamples;
+    }
+
+    // Both stages hold one ratio per call, so the ramp is applied in short steps
+    auto samplesConsumed = 0.0;
+
+    for (int offset = 0; offset < bufferToFill.numSamples; offset += speedRampStepSamples) {
+        auto numThisTime = jmin(speedRampStepSamples, bufferToFill.numSamples - offset);
+        auto ratio = renderStep(AudioSourceChannelInfo(bufferToFill.buffer, bufferToFill.startSample + offset, numThisTime),
+                                speedRamp.skip(numThisTime));
+        samplesConsumed += ratio * numThisTime;
+    }
+
+    return samplesConsumed;
+}
+
+double DJAudioPlayer::renderStep(const AudioSourceChannelInfo& step, double speed) {
+    if (keyLockActive) {
+        // The stretcher's frames map output samples straight onto input samples, so its
+        // read-ahead needs no correction: the nominal tempo is what the playhead follows.
+        // It works at the device rate, behind a stage that only converts the sample rate.
+        rateSource.setResamplingRatio(fileRateRatio);
+        stretchSource.setTempo(speed);
+        stretchSource.getNextAudioBlock(step);
+        return stretchSource.getTempo() * fileRateRatio;
+    }
+
+    // One interpolation pass covers both the speed and the sample rate conversion
+    auto ratio = speed * fileRateRatio;
+    resampleSource.setResamplingRatio(ratio);
+    resampleSource.getNextAudioBlock(step);
+    return ratio;
+}
+
+void DJAudioPlayer::realignSpeedStages(LoadedTrack* track) {
+    // The stage being left has read ahead of what was heard, so rewind the source to the playhead
+    if (track != nullptr)
+        activeTrackSource.setPosition(static_cast<int64>(audiblePosition));
+
+    flushSpeedStages();
+}
+
+void DJAudioPlayer::flushSpeedStages() {
+    resampleSource.flushBuffers();
+    rateSource.flushBuffers();
+    stretchSource.flushBuffers();
+}
+
+void DJAudioPlayer::applyGainRamps(const AudioSourceChannelInfo& bufferToFill) {
+    auto& buffer = *bufferToFill.buffer;
+
+    if (!gainRamp.isSmoothing() && !playRamp.isSmoothing()) {
+        auto gain = gainRamp.getTargetValue() * playRamp.getTargetValue();
+        if (gain != 1.0f)
+            buffer.applyGain(bufferToFill.startSample, bufferToFill.numSamples, gain);
+        return;
+    }
+
+    auto numChannels = buffer.getNumChannels();
+    auto* const* channels = buffer.getArrayOfWritePointers();
+
+    for (int i = bufferToFill.startSample; i < bufferToFill.startSample + bufferToFill.numSamples; ++i) {
+        auto gain = gainRamp.getNextValue() * playRamp.getNextValue();
+
+        for (int chan = 0; chan < numChannels; ++chan)
+            channels[chan][i] *= gain;
+    }
+}
+
+//==============================================================================
+// Playhead clock
+//==============================================================================
+
+void DJAudioPlayer::syncPlayheadClock(LoadedTrack* track) {
+    if (track == clockTrack)
+        return;
+
+    // A newly swapped-in track starts stopped, as it was loaded, so its own auto-gain can apply at once
+    playRamp.setCurrentAndTargetValue(0.0f);
+    gainRamp.setCurrentAndTargetValue(getTargetGain(track));
+    activeTrackSource.reset();
+    flushSpeedStages();
+
+    clockTrack = track;
+    syncLocked = false;
+    audiblePosition = track != nullptr ? static_cast<double>(track->transport.getNextReadPosition()) : 0.0;
+}
+
+void DJAudioPlayer::publishPlayheadClock(LoadedTrack* track, bool wasRunning, double samplesConsumed, double callbackTimeMs) {
+    auto deviceRate = currentSampleRate.load();
+    if (deviceRate <= 0.0)
+        return;
+
+    auto fileSamplesPerOutputSample = 0.0;
+    if (track != nullptr && wasRunning && playRamp.getTargetValue() > 0.0f)
+        fileSamplesPerOutputSample = getFileSamplesPerOutputSample();
+
+    PlayheadClock::Snapshot snapshot;
+    snapshot.samplePosition = audiblePosition;
+    snapshot.timeMs = callbackTimeMs + 1000.0 * outputLatencySamples.load() / deviceRate;
+    snapshot.samplesPerMs = fileSamplesPerOutputSample * deviceRate / 1000.0;
+    snapshot.lengthInSamples = track != nullptr ? track->lengthInSamples : 0;
+    playheadClock.publish(snapshot);
+
+    // Counting what the speed stages consume, rather than reading the transport, leaves out
+    // whatever they have buffered ahead of the output
+    audiblePosition = jmin(activeTrackSource.followJumps(audiblePosition + samplesConsumed),
+                           static_cast<double>(snapshot.lengthInSamples));
+}
+
+double DJAudioPlayer::getFileSamplesPerOutputSample() const {
+    // Through both the speed and the sample rate correction
+    return (keyLockActive ? stretchSource.getTempo() : speedRamp.getCurrentValue()) * fileRateRatio;
+}
+
+//==============================================================================
+// Beat sync
+//==============================================================================
+
+const BeatGrid* DJAudioPlayer::getFinishedBeatGrid(const LoadedTrack* track) noexcept {
+    if (track != nullptr && track->analyser != nullptr)
+        if (auto* analysis = track->analyser->getFinishedResult())
+            if (analysis->beatGrid.isValid())
+                return &analysis->beatGrid;
+    return nullptr;
+}
+
+void DJAudioPlayer::followMaster(LoadedTrack* track, const BeatGrid& grid, int64 timelineSample) {
+    auto deviceRate = currentSampleRate.load();
+    TempoSync::MasterState master;
+
+    if (tempoSync->isMaster(this) || deviceRate <= 0.0 || !tempoSync->readMaster(master) || master.beatsPerSample <= 0.0)
+        return;
+
+    // A master that has stopped publishing is left alone rather than chased
+    if (timelineSample - master.timelineSample > maxMasterAgeSeconds * deviceRate)
+        return;
+
+    // Both beat positions at the first output sample of this block, the master's extrapolated to it
+    auto beatLength = track->sampleRate * grid.getBeatLengthSeconds();
+    auto firstBeatSample = track->sampleRate * grid.firstBeatSeconds;
+    auto masterBeat = master.beat + static_cast<double>(timelineSample - master.timelineSample) * master.beatsPerSample;
+    auto phaseError = (audiblePosition - firstBeatSample) / beatLength - masterBeat;
+    phaseError -= std::round(phaseError);
+
+    if (!syncLocked) {
+        // Jump onto the nearest matching beat once, as a seek would, so the speed only has to hold it there
+        auto target = audiblePosition - phaseError * beatLength;
+        if (target < 0.0)
+            target += beatLength;
+
+        activeTrackSource.setPosition(static_cast<int64>(std::round(target)));
+        flushSpeedStages();
+        audiblePosition = static_cast<double>(activeTrackSource.getPosition());
+
+        phaseError = (audiblePosition - firstBeatSample) / beatLength - masterBeat;
+        phaseError -= std::round(phaseError);
+        syncLocked = true;
+    }
+
+    // The speed that plays the master's beats per sample, bent to close the phase error over the correction time
+    auto tempoMatch = master.beatsPerSample * beatLength / fileRateRatio;
+    auto correction = -phaseError / (syncCorrectionSeconds * deviceRate * master.beatsPerSample);
+
+    speedRamp.setCurrentAndTargetValue(tempoMatch * (1.0 + jlimit(-maxSyncCorrection, maxSyncCorrection, correction)));
+}
+
+void DJAudioPlayer::publishMasterTempo(LoadedTrack* track, const BeatGrid& grid, int64 timelineSample) {
+    auto beatLength = track->sampleRate * grid.getBeatLengthSeconds();
+
+    // The audible position has already moved past the block, so it is heard at the timeline sample after it
+    TempoSync::MasterState state;
+    state.master = this;
+    state.timelineSample = timelineSample;
+    state.beat = (audiblePosition - track->sampleRate * grid.firstBeatSeconds) / beatLength;
+    state.beatsPerSample = getFileSamplesPerOutputSample() / beatLength;
+    tempoSync->publishMaster(state);
+}
+
+//==============================================================================
+// Hot cues and loops
+//==============================================================================
+
+void DJAudioPlayer::setHotCue(int index) {
+    if (!isPositiveAndBelow(index, numHotCues) || windows.track == nullptr) {
+        DBG("DJAudioPlayer::setHotCue needs a loaded track and an index below " + String(numHotCues) + ", got: " + String(index));
+        return;
+    }
+
+    auto& track = *windows.track;
+    auto sample = jlimit(static_cast<int64>(0), track.lengthInSamples, getAudibleSample());
+    hotCues[static_cast<size_t>(index)] = sample;
+    windows.cues[static_cast<size_t>(index)].reset();
+    publishWindows();
+
+    requestWindow(TrackWindow::forCue(track, sample, static_cast<int64>(hotCueWindowSeconds * track.sampleRate)));
+}
+
+void DJAudioPlayer::clearHotCue(int index) {
+    if (!isPositiveAndBelow(index, numHotCues))
+        return;
+
+    hotCues[static_cast<size_t>(index)] = -1;
+    windows.cues[static_cast<size_t>(index)].reset();
+    publishWindows();
+}
+
+bool DJAudioPlayer::hasHotCue(int index) const {
+    return isPositiveAndBelow(index, numHotCues) && hotCues[static_cast<size_t>(index)] >= 0;
+}
+
+void DJAudioPlayer::jumpToHotCue(int index) {
+    if (hasHotCue(index))
+        sendCommand(DeckCommand::Type::jumpToCue, static_cast<double>(hotCues[static_cast<size_t>(index)]));
+}
+
+void DJAudioPlayer::setLoopIn() {
+    if (windows.track != nullptr)
+        loopIn = getAudibleSample();
+}
+
+void DJAudioPlayer::setLoopOut() {
+    if (loopIn < 0) {
+        DBG("DJAudioPlayer::setLoopOut called before setLoopIn");
+        return;
+    }
+
+    setLoop(loopIn, getAudibleSample());
+}
+
+bool DJAudioPlayer::setBeatLoop(double numBeats) {
+    auto grid = getBeatGrid();
+    if (windows.track == nullptr || !grid.isValid() || numBeats <= 0.0)
+        return false;
+
+    auto sampleRate = windows.track->sampleRate;
+    auto beatLength = sampleRate * grid.getBeatLengthSeconds();
+    auto position = getAudibleSample();
+
+    double start;
+    if (loop.contains(position)) {
+        start = static_cast<double>(loop.getStart());
+    }
+    else {
+        start = sampleRate * grid.getTimeOfBeat(std::round(grid.getBeatAt(static_cast<double>(position) / sampleRate)));
+        if (start < 0.0)
+            start += beatLength;
+    }
+
+    setLoop(static_cast<int64>(std::round(start)), static_cast<int64>(std::round(start + numBeats * beatLength)));
+    return true;
+}
+
+void DJAudioPlayer::exitLoop() {
+    loop = {};
+    windows.loop.reset();
+    publishWindows();
+}
+
+bool DJAudioPlayer::isLooping() const {
+    return !loop.isEmpty();
+}
+
+int64 DJAudioPlayer::getAudibleSample() const {
+    if (playheadClock.hasPublished())
+        return static_cast<int64>(playheadClock.getSamplePositionAt(Time::getMillisecondCounterHiRes()));
+
+    if (auto* track = activeTrack.load())
+        return track->transport.getNextReadPosition();
+    return 0;
+}
+
+void DJAudioPlayer::setLoop(int64 start, int64 end) {
+    auto* track = windows.track;
+    if (track == nullptr)
+        return;
+
+    end = jmin(end, track->lengthInSamples);
+    auto length = static_cast<double>(end - start);
+    if (start < 0 || length < minLoopSeconds * track->sampleRate || length > maxLoopSeconds * track->sampleRate) {
+        DBG("DJAudioPlayer::setLoop loop should be between " + String(minLoopSeconds) + " and " + String(maxLoopSeconds)
+            + " seconds inside the track, got samples " + String(start) + " to " + String(end));
+        return;
+    }
+
+    // The old loop keeps playing until the new one's window is ready, so the playhead doesn't escape in between
+    loop = {start, end};
+    requestWindow(TrackWindow::forLoop(*track, start, end));
+}
+
+void DJAudioPlayer::requestWindow(std::unique_ptr<TrackWindow> window) {
+    auto* track = windows.track;
+    if (window == nullptr || track == nullptr)
+        return;
+
+    if (track->isInMemory()) {
+        window->referTo(track->decodedAudio);
+        window->prepareLoop();
+        addWindow(std::move(window));
+        return;
+    }
+
+    auto* job = windowJobs.add(new TrackWindowJob(*track, formatManager, std::move(window)));
+    loaderPool->addJob(job, false);
+    startTimer(50);
+}
+
+void DJAudioPlayer::addWindow(std::unique_ptr<TrackWindow> window) {
+    std::shared_ptr<const TrackWindow> shared(std::move(window));
+    bool wanted = false;
+
+    // The cue or loop may have moved while the window was being read
+    if (shared->isLoop()) {
+        wanted = shared->loopStart == loop.getStart() && shared->loopEnd == loop.getEnd();
+        if (wanted)
+            windows.loop = shared;
+    }
+    else {
+        for (size_t i = 0; i < hotCues.size(); ++i) {
+            if (hotCues[i] == shared->startSample && windows.cues[i] == nullptr) {
+                windows.cues[i] = shared;
+                wanted = true;
+            }
+        }
+    }
+
+    if (wanted)
+        publishWindows();
+}
+
+void DJAudioPlayer::publishWindows() {
+    // If the audio thread hasn't picked up the previous set yet, that one is simply replaced
+    delete pendingWindows.exchange(new TrackWindowSet(windows));
+
+    if (currentSampleRate.load() <= 0.0)
+        swapInPendingWindows(activeTrack.load());
+
+    startTimer(50);
+}
+
+void DJAudioPlayer::swapInPendingWindows(LoadedTrack* track) {
+    // As with tracks, only swap when the retired slot is free
+    if (pendingWindows.load() == nullptr || retiredWindows.load() != nullptr)
+        return;
+
+    if (auto* incoming = pendingWindows.exchange(nullptr)) {
+        auto* previous = activeWindows.exchange(incoming);
+
+        // Only the pointer is kept: the message thread may delete the old set as soon as it is retired
+        auto* previousLoop = previous != nullptr ? previous->loop.get() : nullptr;
+        retiredWindows.store(previous);
+
+        if (incoming->track == track)
+            activeTrackSource.adoptWindows(*incoming, previousLoop);
+    }
+}
+
+void DJAudioPlayer::collectWindows() {
+    for (int i = windowJobs.size(); --i >= 0;) {
+        auto* job = windowJobs[i];
+        if (loaderPool->contains(job))
+            continue;
+
+        if (auto window = job->takeResult())
+            addWindow(std::move(window));
+        windowJobs.remove(i);
+    }
+
+    if (auto* retired = retiredWindows.exchange(nullptr)) {
+        // A window the audio thread is still playing out outlives its set
+        auto* inUse = windowInUse.load();
+        if (retired->loop.get() == inUse)
+            lingeringWindow = retired->loop;
+        for (auto& cue : retired->cues)
+            if (cue != nullptr && cue.get() == inUse)
+                lingeringWindow = cue;
+
+        delete retired;
+    }
+
+    if (lingeringWindow != nullptr && windowInUse.load() != lingeringWindow.get())
+        lingeringWindow.reset();
+}
+
+//==============================================================================
+// ActiveTrackSource
+//==============================================================================
+
+DJAudioPlayer::ActiveTrackSource::ActiveTrackSource(DJAudioPlayer& owner)
+    : owner(owner) {
+}
+
+void DJAudioPlayer::ActiveTrackSource::prepareToPlay(int samplesPerBlockExpected, double sampleRate) {
+    if (auto* track = owner.activeTrack.load())
+        track->transport.prepareToPlay(samplesPerBlockExpected, sampleRate);
+}
+
+void DJAudioPlayer::ActiveTrackSource::getNextAudioBlock(const AudioSourceChannelInfo& bufferToFill) {
+    render(bufferToFill);
+
+    // After a jump, what the source would have played fades out under the new audio
+    if (fadeRemaining > 0) {
+        auto numToFade = jmin(fadeRemaining, bufferToFill.numSamples);
+        auto fadeOffset = fadeLength - fadeRemaining;
+        auto numChannels = jmin(bufferToFill.buffer->getNumChannels(), fadeBuffer.getNumChannels());
+
+        for (int chan = 0; chan < numChannels; ++chan) {
+            auto* samples = bufferToFill.buffer->getWritePointer(chan, bufferToFill.startSample);
+            const auto* previous = fadeBuffer.getReadPointer(chan, fadeOffset);
+
+            for (int i = 0; i < numToFade; ++i) {
+                auto fadeIn = (static_cast<float>(fadeOffset + i) + 0.5f) / static_cast<float>(fadeLength);
+                samples[i] = samples[i] * fadeIn + previous[i] * (1.0f - fadeIn);
+            }
+        }
+
+        fadeRemaining -= numToFade;
+    }
+}
+
+void DJAudioPlayer::ActiveTrackSource::releaseResources() {
+    if (auto* track = owner.activeTrack.load())
+        track->transport.releaseResources();
+}
+
+int64 DJAudioPlayer::ActiveTrackSource::getPosition() const {
+    if (window != nullptr)
+        return windowPosition;
+
+    if (auto* track = owner.activeTrack.load())
+        return track->transport.getNextReadPosition();
+    return 0;
+}
+
+void DJAudioPlayer::ActiveTrackSource::setPosition(int64 position) {
+    numJumps = 0;
+    fadeRemaining = 0;
+
+    if (auto* track = owner.activeTrack.load())
+        moveTo(*track, position);
+}
+
+void DJAudioPlayer::ActiveTrackSource::jumpTo(int64 position) {
+    auto* track = owner.activeTrack.load();
+    if (track == nullptr)
+        return;
+
+    auto from = getPosition();
+
+    // Render where the source was going, to fade out under the jump; that doesn't count as having played it
+    fadeLength = TrackWindow::getCrossfadeSamples(track->sampleRate);
+    if (fadeLength > 0) {
+        auto jumpsBefore = numJumps;
+        render(AudioSourceChannelInfo(&fadeBuffer, 0, fadeLength));
+        numJumps = jumpsBefore;
+    }
+    fadeRemaining = fadeLength;
+
+    moveTo(*track, position);
+    addJump(from, position);
+}
+
+void DJAudioPlayer::ActiveTrackSource::reset() {
+    leaveWindow();
+    numJumps = 0;
+    fadeRemaining = 0;
+}
+
+void DJAudioPlayer::ActiveTrackSource::adoptWindows(const TrackWindowSet& incoming, const TrackWindow* previousLoop) {
+    auto* track = owner.activeTrack.load();
+    auto* newLoop = incoming.loop.get();
+
+    if (track != nullptr && newLoop != nullptr && newLoop != previousLoop) {
+        auto position = getPosition();
+        if (newLoop->contains(position)) {
+            enterWindow(*track, *newLoop, position);
+            return;
+        }
+
+        // Loop-out is set where the playhead already was, so the source is a little past the end
+        auto overshoot = position - newLoop->loopEnd;
+        if (overshoot >= 0 && overshoot < static_cast<int64>(loopCatchUpSeconds * track->sampleRate)) {
+            jumpTo(newLoop->loopStart + (position - newLoop->loopStart) % (newLoop->loopEnd - newLoop->loopStart));
+            return;
+        }
+    }
+
+    // A window the new set doesn't hold is played to its end, where the stream is waiting
+    if (window != nullptr && !incoming.contains(window))
+        wrapping = false;
+}
+
+double DJAudioPlayer::ActiveTrackSource::followJumps(double position) {
+    while (numJumps > 0 && position >= static_cast<double>(jumps[0].from)) {
+        position += static_cast<double>(jumps[0].to - jumps[0].from);
+
+        if (--jumps[0].count == 0) {
+            std::move(jumps.begin() + 1, jumps.begin() + numJumps, jumps.begin());
+            --numJumps;
+        }
+    }
+    return position;
+}
+
+void DJAudioPlayer::ActiveTrackSource::render(const AudioSourceChannelInfo& bufferToFill) {
+    auto* track = owner.activeTrack.load();
+    if (track == nullptr) {
+        bufferToFill.clearActiveBufferRegion();
+        return;
+    }
+
+    auto* windows = getWindows(track);
+    auto* loopWindow = windows != nullptr ? windows->loop.get() : nullptr;
+    auto& buffer = *bufferToFill.buffer;
+
+    for (int done = 0; done < bufferToFill.numSamples;) {
+        auto numLeft = bufferToFill.numSamples - done;
+
+        // The stream, or a cue's window, plays up to the loop's window, which takes over from there
+        auto position = getPosition();
+        if (loopWindow != nullptr && window != loopWindow && position < loopWindow->loopEnd) {
+            if (position >= loopWindow->startSample) {
+                enterWindow(*track, *loopWindow, position);
+                continue;
+            }
+            numLeft = static_cast<int>(jmin(static_cast<int64>(numLeft), loopWindow->startSample - position));
+        }
+
+        if (window == nullptr) {
+            // The stream is held at the end rather than read past it, so the transport never stops
+            // itself, which would lock and post a change message on the audio thread
+            auto numFromStream = static_cast<int>(jlimit(static_cast<int64>(0), static_cast<int64>(numLeft),
+                                                         track->lengthInSamples - position));
+            if (numFromStream > 0)
+                track->transport.getNextAudioBlock(AudioSourceChannelInfo(&buffer, bufferToFill.startSample + done, numFromStream));
+            if (numFromStream < numLeft)
+                buffer.clear(bufferToFill.startSample + done + numFromStream, numLeft - numFromStream);
+
+            done += numLeft;
+            continue;
+        }
+
+        auto end = wrapping ? window->loopEnd : window->endSample;
+        auto numThisTime = static_cast<int>(jmin(static_cast<int64>(numLeft), end - windowPosition));
+
+        window->copyTo(buffer, bufferToFill.startSample + done, windowPosition, numThisTime, wrapping);
+        windowPosition += numThisTime;
+        done += numThisTime;
+
+        if (windowPosition == end) {
+            if (wrapping) {
+                addJump(end, window->loopStart);
+                windowPosition = window->loopStart;
+            }
+            else {
+                leaveWindow();
+            }
+        }
+    }
+}
+
+void DJAudioPlayer::ActiveTrackSource::moveTo(LoadedTrack& track, int64 position) {
+    auto* windows = getWindows(&track);
+    if (auto* found = windows != nullptr ? windows->find(position) : nullptr) {
+        enterWindow(track, *found, position);
+        return;
+    }
+
+    leaveWindow();
+    track.transport.setNextReadPosition(position);
+}
+
+void DJAudioPlayer::ActiveTrackSource::enterWindow(LoadedTrack& track, const TrackWindow& newWindow, int64 position) {
+    window = &newWindow;
+    windowPosition = position;
+    wrapping = newWindow.isLoop();
+    owner.windowInUse.store(window);
+
+    // One seek, which the read-ahead has the whole window's length to catch up with
+    if (track.transport.getNextReadPosition() != newWindow.endSample)
+        track.transport.setNextReadPosition(newWindow.endSample);
+}
+
+void DJAudioPlayer::ActiveTrackSource::leaveWindow() {
+    window = nullptr;
+    wrapping = false;
+    owner.windowInUse.store(nullptr);
+}
+
+void DJAudioPlayer::ActiveTrackSource::addJump(int64 from, int64 to) {
+    if (numJumps > 0) {
+        auto& last = jumps[static_cast<size_t>(numJumps - 1)];
+        if (last.from == from && last.to == to) {
+            ++last.count;
+            return;
+        }
+    }
+
+    // More jumps than this in the speed stages' buffers can't happen at any sensible loop length
+    if (numJumps < static_cast<int>(jumps.size()))
+        jumps[static_cast<size_t>(numJumps++)] = {from, to, 1};
+}
+
+const TrackWindowSet* DJAudioPlayer::ActiveTrackSource::getWindows(const LoadedTrack* track) const {
+    auto* windows = owner.activeWindows.load();
+    return windows != nullptr && windows->track == track ? windows : nullptr;
+}
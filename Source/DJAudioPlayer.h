@@ -13,71 +13,653 @@
 #pragma once
 
 #include "../JuceLibraryCode/JuceHeader.h"
+#include "ReadAheadAudioSource.h"
+#include "TrackLoader.h"
+#include "PlayheadClock.h"
+#include "DeckCommandQueue.h"
+#include "TimeStretchAudioSource.h"
+#include "QualityResamplingAudioSource.h"
+#include "AudioCallbackProfiler.h"
+#include "TrackAnalysis.h"
+#include "TempoSync.h"
+#include "TrackWindow.h"
 
 /**
  * @class DJAudioPlayer
  * @brief Audio player class that handles playback of audio files with transport controls
  *
  * Provides functionality for loading, playing, and manipulating audio files including
- * gain control, speed adjustment, and position control.
+ * gain control, speed adjustment, and position control. Files are streamed through a
+ * read-ahead buffer filled on a thread shared by all decks, so the audio callback never
+ * reads from disk or decodes.
+ *
+ * In memory mode the whole track is decoded once into RAM, so seeking is instant and
+ * playback costs no decoding. Decks share one memory budget and fall back to streaming
+ * when a track would not fit.
+ *
+ * Local files are decoded once into an on-disk PCM cache, and later loads of the same
+ * content memory-map the cached samples instead of decoding again.
+ *
+ * Each audio callback publishes which track sample will be heard when, after the
+ * resamplers and the device's output latency, so the UI can draw the playhead where
+ * the listener actually is.
+ *
+ * Transport changes from the UI (gain, speed, seeking, start and stop) never touch
+ * the audio sources directly. They are queued on a lock-free command queue and applied
+ * at the start of the next block, and gain and speed then ramp there sample by sample.
+ * The audio thread therefore never contends for a lock with the message thread.
+ *
+ * With key lock on, speed changes go through a WSOLA time-stretch stage instead of
+ * the resampler, so the tempo changes but the pitch does not.
+ *
+ * Tracks are opened and prepared on a worker thread and published to the audio thread
+ * with an atomic pointer swap at the start of the next block. Only the message thread
+ * deletes tracks, once the audio thread has handed them back.
+ *
+ * Each loaded track is analysed in the background for its tempo and beat grid, fed
+ * from the same decode pass and finished on the shared, low-priority analysis pool.
+ *
+ * The decode pass also measures the track's loudness, so with auto-gain on each track
+ * plays at a common loudness. The gain is worked out once, before the track reaches
+ * the audio thread or, for a streaming track whose pass is still running, as soon as
+ * the pass has measured it, and is folded into the deck's gain ramp: nothing is
+ * metered live.
+ *
+ * Loops and hot cues play from TrackWindows, spans of the track held in memory. The
+ * audio thread wraps round a loop at its exact end sample, crossfading into the loop
+ * start, and a hot cue jump crossfades into the cue at the start of the next block;
+ * neither seeks the track's stream, which only moves once, to the end of the window,
+ * while the window plays.
+ *
+ * In sync mode the deck follows the master deck's beat grid inside the audio callback:
+ * every block it sets the speed that matches the master's tempo, bent slightly to pull
+ * out any phase error, so the beats stay locked while the master's speed changes.
  */
-class DJAudioPlayer : public AudioSource {
+class DJAudioPlayer : public AudioSource,
+                      private Timer {
 public:
+    /** How newly loaded tracks are played */
+    enum class PlaybackMode {
+        streaming,  /**< Read and decode ahead of the playhead on the read-ahead thread */
+        inMemory    /**< Decode the whole track into RAM on load, budget permitting */
+    };
+
     /**
      * Constructor for DJAudioPlayer
      * @param formatManager Reference to the AudioFormatManager to use for loading audio files
      */
     DJAudioPlayer(AudioFormatManager& formatManager);
-    
+
     /** Destructor */
-    ~DJAudioPlayer();
+    ~DJAudioPlayer() override;
 
     //==========================================================================
     // AudioSource overrides
     //==========================================================================
-    
+
     /** Prepares the player for playback */
     void prepareToPlay(int samplesPerBlockExpected, double sampleRate) override;
-    
+
     /** Gets the next block of audio data */
     void getNextAudioBlock(const AudioSourceChannelInfo& bufferToFill) override;
-    
+
     /** Releases resources used by the player */
     void releaseResources() override;
 
     //==========================================================================
     // Playback control methods
     //==========================================================================
-    
-    /** Loads an audio file from a URL */
-    void loadURL(URL audioURL);
-    
+
+    /**
+     * Loads an audio file from a URL, blocking until it is ready
+     * @param audioURL The file to load
+     * @param sinks Consumers fed from the same decode pass as playback, e.g. the waveform
+     * @return true if the track loaded and will play from the next block
+     */
+    bool loadURL(URL audioURL, const Array<std::shared_ptr<DecodeSink>>& sinks = {});
+
+    /**
+     * Starts loading an audio file on a worker thread
+     * The current track keeps playing until the new one is ready to swap in.
+     * Progress and the result are reported through onLoadProgress and onLoadFinished.
+     * @param audioURL The file to load
+     * @param sinks Consumers fed from the same decode pass as playback, e.g. the waveform
+     */
+    void loadURLAsync(URL audioURL, const Array<std::shared_ptr<DecodeSink>>& sinks = {});
+
+    /** Abandons the load started by loadURLAsync, if any */
+    void cancelLoad();
+
+    /** Returns true while a load started by loadURLAsync is in progress */
+    bool isLoading() const;
+
+    /** Called on the message thread with the progress (0.0 to 1.0) of an asynchronous load */
+    std::function<void(double)> onLoadProgress;
+
+    /** Called on the message thread when an asynchronous load has finished or failed */
+    std::function<void(const URL&, bool)> onLoadFinished;
+
     /** Sets the gain (volume) level (0.0 to 1.0) */
     void setGain(double gain);
-    
+
     /** Sets the playback speed ratio (0.0 to 100.0) */
     void setSpeed(double ratio);
-    
+
     /** Sets the playback position in seconds */
     void setPosition(double posInSecs);
-    
+
     /** Sets the playback position as a proportion of the total length (0.0 to 1.0) */
     void setPositionRelative(double pos);
-    
+
     /** Starts playback */
     void start();
-    
+
     /** Stops playback */
     void stop();
 
-    /** Gets the current relative position of the playhead (0.0 to 1.0) */
-    double getPositionRelative();
+    /**
+     * Sets whether speed changes keep the pitch (time-stretch) or shift it (resample)
+     * Switching realigns the track to what is currently heard, so the playhead doesn't jump.
+     */
+    void setKeyLock(bool shouldKeepPitch);
+
+    /** Returns true if speed changes keep the pitch */
+    bool isKeyLockEnabled() const;
+
+    /**
+     * Sets the interpolation used when speed changes shift the pitch
+     * Like key lock, switching realigns the track to what is currently heard.
+     */
+    void setResamplerQuality(QualityResamplingAudioSource::Quality quality);
+
+    /** Gets the interpolation used when speed changes shift the pitch */
+    QualityResamplingAudioSource::Quality getResamplerQuality() const;
+
+    /** Gets how far the time-stretch stage reads ahead of what it outputs, in samples */
+    int getTimeStretchLatencySamples() const;
+
+    /** Gets the current relative position of the transport's read head (0.0 to 1.0) */
+    double getPositionRelative() const;
+
+    /**
+     * Gets the relative position (0.0 to 1.0) of what is being heard right now
+     * Extrapolated from the last audio callback, so it moves smoothly when called at
+     * display refresh rate. Falls back to getPositionRelative() before the first callback.
+     */
+    double getAudiblePositionRelative() const;
+
+    /** Sets the output latency of the audio device, used to time the audible position */
+    void setOutputLatencySamples(int numSamples);
+
+    /** Gets the traffic through the command queue, e.g. to check nothing was dropped */
+    DeckCommandQueue::Stats getCommandQueueStats() const;
+
+    /**
+     * Gets how often the audio thread waited for the read-ahead buffer's range lock
+     * It is the only lock the deck takes on the audio thread that another thread also
+     * holds while playing, and only the read-ahead thread does.
+     * @return Waits since the current track was loaded; 0 without read-ahead
+     */
+    int64 getReadAheadLockWaits() const;
+
+    //==========================================================================
+    // Read-ahead streaming
+    //==========================================================================
+
+    /** Default read-ahead per deck, about 0.75 seconds at 44.1kHz */
+    static constexpr int defaultReadAheadSamples = 32768;
+
+    /**
+     * Sets how many samples are read ahead of the playhead for the next loaded file
+     * @param numSamples Buffer size in samples, or 0 to read directly on the audio thread
+     */
+    void setReadAheadSamples(int numSamples);
+
+    /** Gets the read-ahead buffer size used for newly loaded files */
+    int getReadAheadSamples() const;
+
+    /** Gets the number of audio callbacks that ran out of read-ahead data */
+    int getUnderrunCount() const;
+
+    /** Gets the number of samples replaced with silence because of underruns */
+    int64 getUnderrunSamples() const;
+
+    /** Clears the underrun counters */
+    void resetUnderrunCounters();
+
+    //==========================================================================
+    // In-memory playback
+    //==========================================================================
+
+    /** Sets how the next loaded track is played */
+    void setPlaybackMode(PlaybackMode newMode);
+
+    /** Gets the mode used for newly loaded tracks */
+    PlaybackMode getPlaybackMode() const;
+
+    /** Returns true if the current track is playing from RAM */
+    bool isPlayingFromMemory() const;
+
+    /** Gets the number of bytes of decoded audio this deck currently holds */
+    size_t getMemoryUsageBytes() const;
+
+    /** Gets the memory budget shared by all decks */
+    TrackMemoryBudget& getMemoryBudget();
+
+    //==========================================================================
+    // Decoded-PCM disk cache
+    //==========================================================================
+
+    /** Sets whether newly loaded local files are served from and added to the PCM cache */
+    void setUsePcmCache(bool shouldUse);
+
+    /** Returns true if newly loaded local files use the PCM cache */
+    bool isUsingPcmCache() const;
+
+    /** Returns true if the current track was opened from the PCM cache */
+    bool isPlayingFromPcmCache() const;
+
+    /** Gets the PCM cache shared by all decks */
+    PcmCache& getPcmCache();
+
+    //==========================================================================
+    // Track analysis
+    //==========================================================================
+
+    /** Sets whether newly loaded tracks are analysed, e.g. off for benchmarks */
+    void setAnalyseOnLoad(bool shouldAnalyse);
+
+    /** Returns true if newly loaded tracks are analysed */
+    bool isAnalysingOnLoad() const;
+
+    /** Returns true while the current track's analysis is still running */
+    bool isAnalysing() const;
+
+    /** Gets the current track's analysis, or nullptr until it has finished or if it failed */
+    std::shared_ptr<const TrackAnalysis> getAnalysis() const;
+
+    /** Gets the current track's beat grid, or an invalid grid if it isn't known (yet) */
+    BeatGrid getBeatGrid() const;
+
+    /** Gets the current track's key, or an invalid key if it isn't known (yet) */
+    MusicalKey getKey() const;
+
+    /** Called on the message thread when the current track's analysis has finished or failed */
+    std::function<void()> onAnalysisFinished;
+
+    //==========================================================================
+    // Loudness
+    //==========================================================================
+
+    /** Loudness auto-gain brings tracks to, in LUFS */
+    static constexpr double autoGainTargetLufs = -14.0;
+
+    /** Highest true peak auto-gain may raise a track to, in dBTP */
+    static constexpr double autoGainMaxTruePeakDb = -1.0;
+
+    /**
+     * Sets whether each track's gain is corrected to autoGainTargetLufs
+     * A track's correction is fixed when it loads, from the loudness measured in the
+     * load's decode pass, so it needs analysis on load; tracks that weren't measured
+     * play unchanged. The gain set with setGain() applies on top.
+     */
+    void setAutoGain(bool shouldNormalise);
+
+    /** Returns true if tracks are played at a normalised loudness */
+    bool isAutoGainEnabled() const;
+
+    /** Gets the current track's loudness, or an unmeasured one if it isn't known */
+    Loudness getLoudness() const;
+
+    /** Gets the gain auto-gain applies to the current track, in dB, whether or not it is on */
+    double getAutoGainDb() const;
+
+    //==========================================================================
+    // Beat sync
+    //==========================================================================
+
+    /**
+     * Sets whether the deck locks its tempo and beat phase to the master deck's
+     * Sync takes hold once both tracks have a beat grid and the master is playing; the
+     * deck first jumps by the phase error, then only bends its speed. The speed set with
+     * setSpeed() is overridden while synced, and turning sync off keeps the synced speed.
+     */
+    void setSyncEnabled(bool shouldSync);
+
+    /** Returns true if the deck follows the master deck */
+    bool isSyncEnabled() const;
+
+    /** Makes this deck the one synced decks follow, or stops it being the master */
+    void setSyncMaster(bool shouldBeMaster);
+
+    /** Returns true if this deck is the sync master */
+    bool isSyncMaster() const;
+
+    /** Gets the speed ratio the deck is playing at, including any sync correction */
+    double getCurrentSpeed() const;
+
+    //==========================================================================
+    // Hot cues and loops
+    //==========================================================================
+
+    /** Number of hot cues per track */
+    static constexpr int numHotCues = TrackWindowSet::maxHotCues;
+
+    /** Audio held in memory after each hot cue, long enough for the stream to catch up after a jump */
+    static constexpr double hotCueWindowSeconds = 4.0;
+
+    /** Shortest and longest loops */
+    static constexpr double minLoopSeconds = 0.01;
+    static constexpr double maxLoopSeconds = 32.0;
+
+    /** A loop set behind the playhead, as loop-out does, is gone back round if it ended no longer ago than this */
+    static constexpr double loopCatchUpSeconds = 0.5;
+
+    /** Sets a hot cue at the audible position, replacing the one there was */
+    void setHotCue(int index);
+
+    /** Removes a hot cue */
+    void clearHotCue(int index);
+
+    /** Returns true if a hot cue is set */
+    bool hasHotCue(int index) const;
+
+    /**
+     * Jumps to a hot cue at the start of the next block
+     * A synced deck lands as far from the cue's beat as it was from its own, so it stays
+     * in phase with the master.
+     */
+    void jumpToHotCue(int index);
+
+    /** Marks the audible position as the start of the next loop */
+    void setLoopIn();
+
+    /** Loops from the loop-in point to the audible position, going back to the start straight away */
+    void setLoopOut();
+
+    /**
+     * Loops a number of beats from the beat nearest the audible position
+     * Inside a loop, the new loop keeps the loop's start, so it can be halved or doubled.
+     * @return false if the track has no beat grid (yet)
+     */
+    bool setBeatLoop(double numBeats);
+
+    /** Stops looping; the deck plays on past the loop end */
+    void exitLoop();
+
+    /** Returns true if a loop is set */
+    bool isLooping() const;
 
 private:
+    /**
+     * @class ActiveTrackSource
+     * @brief Feeds the speed stages from whichever track the audio thread currently owns
+     *
+     * Reads from the track's transport, or from a loop or hot cue window once the
+     * playhead is in one. Wraps and jumps happen here, in track samples, ahead of the
+     * speed stages, so those never need flushing for them; the jumps are recorded so
+     * the audible position can follow once the buffered samples have played.
+     */
+    class ActiveTrackSource : public AudioSource {
+    public:
+        explicit ActiveTrackSource(DJAudioPlayer& owner);
+
+        void prepareToPlay(int samplesPerBlockExpected, double sampleRate) override;
+        void getNextAudioBlock(const AudioSourceChannelInfo& bufferToFill) override;
+        void releaseResources() override;
+
+        /** Gets the track sample the next block starts at (audio thread) */
+        int64 getPosition() const;
+
+        /** Moves to a track sample, from a window if one holds it; audio already buffered should be flushed (audio thread) */
+        void setPosition(int64 position);
+
+        /** Jumps to a track sample, crossfading from where the source was, without flushing (audio thread) */
+        void jumpTo(int64 position);
+
+        /** Forgets the window being played, e.g. when the track changes (audio thread) */
+        void reset();
+
+        /** Starts playing from a new set of windows, leaving any window it doesn't hold at its end (audio thread) */
+        void adoptWindows(const TrackWindowSet& incoming, const TrackWindow* previousLoop);
+
+        /** Moves a position that has played through the speed stages past any wrap or jump behind it (audio thread) */
+        double followJumps(double position);
+
+    private:
+        /** A discontinuity in the stream of samples, which the audible position follows once it gets there */
+        struct Jump {
+            int64 from = 0;
+            int64 to = 0;
+            int count = 0;
+        };
+
+        /** Reads on through the track, wrapping round the loop if there is one */
+        void render(const AudioSourceChannelInfo& bufferToFill);
+
+        /** Goes to a track sample, in a window if one holds it or else in the stream */
+        void moveTo(LoadedTrack& track, int64 position);
+
+        /** Plays on from a window, moving the stream to the window's end to wait there */
+        void enterWindow(LoadedTrack& track, const TrackWindow& newWindow, int64 position);
+
+        /** Goes back to reading the stream, which is waiting where the window ended */
+        void leaveWindow();
+
+        /** Records a jump, merging repeated wraps round the same loop */
+        void addJump(int64 from, int64 to);
+
+        /** Gets the active windows if they belong to the active track */
+        const TrackWindowSet* getWindows(const LoadedTrack* track) const;
+
+        DJAudioPlayer& owner;
+
+        const TrackWindow* window = nullptr;
+        int64 windowPosition = 0;
+        bool wrapping = false;
+
+        AudioBuffer<float> fadeBuffer{2, TrackWindow::maxCrossfadeSamples};
+        int fadeLength = 0;
+        int fadeRemaining = 0;
+
+        std::array<Jump, 16> jumps;
+        int numJumps = 0;
+    };
+
+    /** Timer override - reports load and analysis progress, collects windows and frees what the audio thread has released */
+    void timerCallback() override;
+
+    /** Snapshot of the settings new tracks should be prepared with */
+    TrackLoadSettings getLoadSettings() const;
+
+    /** Hands a prepared track to the audio thread */
+    void publishTrack(std::unique_ptr<LoadedTrack> track);
+
+    /** Swaps in a pending track if the audio thread is free to take it (audio thread) */
+    void swapInPendingTrack();
+
+    /** Deletes the track the audio thread has swapped out, if any */
+    void collectRetiredTrack();
+
+    /** Gets the track sample being heard, for setting cues and loops */
+    int64 getAudibleSample() const;
+
+    /** Sets a loop in track samples, reading its window */
+    void setLoop(int64 start, int64 end);
+
+    /** Fills a window, straight away for a track in memory or else on the loader pool */
+    void requestWindow(std::unique_ptr<TrackWindow> window);
+
+    /** Puts a filled window into the set if its cue or loop is still wanted */
+    void addWindow(std::unique_ptr<TrackWindow> window);
+
+    /** Hands a copy of the current windows to the audio thread */
+    void publishWindows();
+
+    /** Swaps in pending windows if the audio thread is free to take them (audio thread) */
+    void swapInPendingWindows(LoadedTrack* track);
+
+    /** Takes finished windows, and deletes window sets the audio thread has let go of */
+    void collectWindows();
+
+    /** Called when the current load job has left the pool */
+    void finishLoad();
+
+    /** Starts an analyser for a load if analysis is on, adding it to the load's sinks */
+    Array<std::shared_ptr<DecodeSink>> beginAnalysis(const URL& audioURL, const Array<std::shared_ptr<DecodeSink>>& sinks);
+
+    /** Makes the pending analyser the current track's, or drops it if the load failed */
+    void finishAnalysis(bool loaded);
+
+    /** Fixes the gain that normalises a track's loudness, before it is published */
+    void setTrackAutoGain(LoadedTrack& track) const;
+
+    /** Sets a streaming track's auto-gain once its decode pass has measured it (message thread) */
+    void applyMeasuredAutoGain();
+
+    /** Gets the gain the gain ramp heads for: the deck's gain, times the track's auto-gain if on (audio thread) */
+    float getTargetGain(const LoadedTrack* track) const noexcept;
+
+    /** Queues a command for the audio thread, reporting it if the queue is full */
+    void sendCommand(DeckCommand::Type type, double value = 0.0);
+
+    /** Applies one queued command to the active track (audio thread) */
+    void applyCommand(const DeckCommand& command, LoadedTrack* track);
+
+    /**
+     * Pulls a block through the resampler or time-stretcher, stepping the ratio while it ramps (audio thread)
+     * @return the number of file samples the block covers
+     */
+    double renderAtSpeed(const AudioSourceChannelInfo& bufferToFill);
+
+    /**
+     * Renders one step at a fixed speed through whichever speed stage is active (audio thread)
+     * @return file samples consumed per output sample, after any clamping by the time-stretcher
+     */
+    double renderStep(const AudioSourceChannelInfo& step, double speed);
+
+    /** Moves the transport back to the audible position and empties both speed stages (audio thread) */
+    void realignSpeedStages(LoadedTrack* track);
+
+    /** Empties every speed stage, e.g. after the transport has moved (audio thread) */
+    void flushSpeedStages();
+
+    /** Applies the gain and start/stop ramps to a rendered block (audio thread) */
+    void applyGainRamps(const AudioSourceChannelInfo& bufferToFill);
+
+    /** Re-reads the audible position from the transport after a track swap (audio thread) */
+    void syncPlayheadClock(LoadedTrack* track);
+
+    /** Publishes the block just rendered and advances the audible position past it (audio thread) */
+    void publishPlayheadClock(LoadedTrack* track, bool wasRunning, double samplesConsumed, double callbackTimeMs);
+
+    /** Gets the file samples consumed per output sample at the end of the last block (audio thread) */
+    double getFileSamplesPerOutputSample() const;
+
+    /** Gets the track's beat grid once its analysis has finished, or nullptr (audio thread) */
+    static const BeatGrid* getFinishedBeatGrid(const LoadedTrack* track) noexcept;
+
+    /** Sets the speed, and on first locking the position, that puts the deck's beats on the master's (audio thread) */
+    void followMaster(LoadedTrack* track, const BeatGrid& grid, int64 timelineSample);
+
+    /** Publishes where the deck's beats fall on the output timeline, for decks synced to it (audio thread) */
+    void publishMasterTempo(LoadedTrack* track, const BeatGrid& grid, int64 timelineSample);
+
+    /** Ramp times for parameter changes, long enough to avoid zipper noise */
+    static constexpr double gainRampSeconds = 0.02;
+    static constexpr double speedRampSeconds = 0.05;
+    static constexpr double playRampSeconds = 0.005;
+
+    /** Limits on the auto-gain correction, in dB, so a near-silent or broken measurement can't blow up the level */
+    static constexpr double minAutoGainDb = -24.0;
+    static constexpr double maxAutoGainDb = 12.0;
+
+    /** Samples per speed ratio step while the speed is ramping */
+    static constexpr int speedRampStepSamples = 16;
+
+    /** Time a synced deck takes to pull out a phase error, and the most it bends the tempo doing so */
+    static constexpr double syncCorrectionSeconds = 0.5;
+    static constexpr double maxSyncCorrection = 0.02;
+
+    /** A master that hasn't published for this long, e.g. because it stopped, is no longer followed */
+    static constexpr double maxMasterAgeSeconds = 0.25;
+
     AudioFormatManager& formatManager;
-    std::unique_ptr<AudioFormatReaderSource> readerSource;
-    AudioTransportSource transportSource; 
-    ResamplingAudioSource resampleSource{&transportSource, false, 2};
+    int readAheadSamples = defaultReadAheadSamples;
+    PlaybackMode playbackMode = PlaybackMode::streaming;
+    bool usePcmCache = true;
+    bool analyseOnLoad = true;
+    bool keyLock = false;
+    bool syncEnabled = false;
+    bool autoGain = false;
+    QualityResamplingAudioSource::Quality resamplerQuality = QualityResamplingAudioSource::Quality::fast;
+
+    std::atomic<double> currentSampleRate{0.0};
+    std::atomic<int> currentBlockSize{0};
+    std::atomic<int> outputLatencySamples{0};
+
+    // UI changes waiting for the audio thread, and their ramps (audio thread only)
+    DeckCommandQueue commandQueue;
+    SmoothedValue<float> gainRamp{1.0f};
+    SmoothedValue<double> speedRamp{1.0};
+    SmoothedValue<float> playRamp{0.0f};
+    float userGain = 1.0f;
+    bool autoGainActive = false;
+    bool keyLockActive = false;
+    double fileRateRatio = 1.0;
+
+    // Beat sync (audio thread only, apart from the published speed)
+    bool syncActive = false;
+    bool syncLocked = false;
+    std::atomic<double> currentSpeed{1.0};
+
+    // Audible position, kept by the audio thread and published through playheadClock
+    PlayheadClock playheadClock;
+    LoadedTrack* clockTrack = nullptr;
+    double audiblePosition = 0.0;
+
+    SharedResourcePointer<TrackMemoryBudget> memoryBudget;
+    SharedResourcePointer<PcmCache> pcmCache;
+    SharedResourcePointer<TrackLoaderPool> loaderPool;
+    SharedResourcePointer<AnalysisPool> analysisPool;
+    SharedResourcePointer<AudioCallbackProfiler> profiler;
+    SharedResourcePointer<TempoSync> tempoSync;
+    std::unique_ptr<TrackLoadJob> loadJob;
+    OwnedArray<TrackLoadJob> cancelledJobs;
+
+    // Analysis of the track being loaded, and of the current track until its result is reported
+    std::shared_ptr<TrackAnalyser> pendingAnalyser;
+    std::shared_ptr<TrackAnalyser> trackAnalyser;
+    bool analysisReported = true;
+
+    std::atomic<LoadedTrack*> pendingTrack{nullptr};
+    std::atomic<LoadedTrack*> activeTrack{nullptr};
+    std::atomic<LoadedTrack*> retiredTrack{nullptr};
+
+    // Published track whose loudness is still being measured; cleared before it is deleted (message thread)
+    LoadedTrack* trackAwaitingLoudness = nullptr;
+
+    // Hot cues and the loop in track samples, or -1, with their windows (message thread)
+    std::array<int64, numHotCues> hotCues;
+    int64 loopIn = -1;
+    Range<int64> loop;
+    TrackWindowSet windows;
+    OwnedArray<TrackWindowJob> windowJobs;
+    std::shared_ptr<const TrackWindow> lingeringWindow;
+
+    std::atomic<TrackWindowSet*> pendingWindows{nullptr};
+    std::atomic<TrackWindowSet*> activeWindows{nullptr};
+    std::atomic<TrackWindowSet*> retiredWindows{nullptr};
+
+    // The window the audio thread is playing, kept alive after its set is retired until it has finished with it
+    std::atomic<const TrackWindow*> windowInUse{nullptr};
+
+    ActiveTrackSource activeTrackSource{*this};
+    // Without key lock one resampler does speed and rate conversion together; with it the
+    // rate is converted first and the stretcher then changes the tempo at the device rate
+    QualityResamplingAudioSource resampleSource{&activeTrackSource, 2};
+    QualityResamplingAudioSource rateSource{&activeTrackSource, 2};
+    TimeStretchAudioSource stretchSource{&rateSource, 2};
 };
 
 
@@ -0,0 +1,35 @@
+/*
+  ==============================================================================
+
+    DeckCommandQueue.cpp
+    Created: 16 Oct 2026 9:48:03pm
+
+  ==============================================================================
+*/
+
+#include "DeckCommandQueue.h"
+
+DeckCommandQueue::DeckCommandQueue() {
+}
+
+bool DeckCommandQueue::push(const DeckCommand& command) noexcept {
+    const auto scope = fifo.write(1);
+
+    if (scope.blockSize1 + scope.blockSize2 == 0) {
+        dropped.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    commands[static_cast<size_t>(scope.blockSize1 > 0 ? scope.startIndex1 : scope.startIndex2)] = command;
+    pushed.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+DeckCommandQueue::Stats DeckCommandQueue::getStats() const noexcept {
+    Stats stats;
+    stats.pushed = pushed.load(std::memory_order_relaxed);
+    stats.dropped = dropped.load(std::memory_order_relaxed);
+    stats.applied = applied.load(std::memory_order_relaxed);
+    stats.maxBacklog = maxBacklog.load(std::memory_order_relaxed);
+    return stats;
+}
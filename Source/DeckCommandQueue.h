@@ -0,0 +1,102 @@
+/*
+  ==============================================================================
+
+    DeckCommandQueue.h
+    Created: 16 Oct 2026 9:48:03pm
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "../JuceLibraryCode/JuceHeader.h"
+
+/**
+ * @struct DeckCommand
+ * @brief A change to a deck's playback, sent from the UI to the audio thread
+ */
+struct DeckCommand {
+    enum class Type {
+        setGain,                /**< value is the target gain (0.0 to 1.0) */
+        setSpeed,               /**< value is the target speed ratio */
+        setPosition,            /**< value is the position in seconds */
+        setPositionRelative,    /**< value is the position as a proportion of the track */
+        jumpToCue,              /**< value is the hot cue's position in track samples */
+        setKeyLock,             /**< value is non-zero to keep the pitch when the speed changes */
+        setResamplerQuality,    /**< value is a QualityResamplingAudioSource::Quality */
+        setSync,                /**< value is non-zero to follow the master deck's tempo and beats */
+        setAutoGain,            /**< value is non-zero to play each track at its normalised loudness */
+        start,
+        stop
+    };
+
+    Type type = Type::stop;
+    double value = 0.0;
+};
+
+/**
+ * @class DeckCommandQueue
+ * @brief Fixed-size lock-free queue from the message thread to the audio thread
+ *
+ * There is one producer (the message thread) and one consumer (the audio callback),
+ * so an AbstractFifo over a preallocated array is enough: neither side ever locks or
+ * allocates. The counters let callers check that every change made it across.
+ */
+class DeckCommandQueue {
+public:
+    /** Maximum number of commands waiting at once */
+    static constexpr int capacity = 256;
+
+    /** Traffic through the queue since construction */
+    struct Stats {
+        int64 pushed = 0;       /**< Commands accepted by push */
+        int64 dropped = 0;      /**< Commands rejected because the queue was full */
+        int64 applied = 0;      /**< Commands drained by the audio thread */
+        int maxBacklog = 0;     /**< Most commands seen waiting at the start of a block */
+    };
+
+    DeckCommandQueue();
+
+    /**
+     * Queues a command (message thread)
+     * @return false if the queue was full and the command was dropped
+     */
+    bool push(const DeckCommand& command) noexcept;
+
+    /**
+     * Hands every waiting command to a handler, oldest first (audio thread)
+     * @return the number of commands handled
+     */
+    template <typename Handler>
+    int drain(Handler&& handler) noexcept {
+        auto numReady = fifo.getNumReady();
+        if (numReady == 0)
+            return 0;
+
+        if (numReady > maxBacklog.load(std::memory_order_relaxed))
+            maxBacklog.store(numReady, std::memory_order_relaxed);
+
+        const auto scope = fifo.read(numReady);
+        for (int i = 0; i < scope.blockSize1; ++i)
+            handler(commands[static_cast<size_t>(scope.startIndex1 + i)]);
+        for (int i = 0; i < scope.blockSize2; ++i)
+            handler(commands[static_cast<size_t>(scope.startIndex2 + i)]);
+
+        applied.fetch_add(numReady, std::memory_order_relaxed);
+        return numReady;
+    }
+
+    /** Gets the traffic counters */
+    Stats getStats() const noexcept;
+
+private:
+    AbstractFifo fifo{capacity};
+    std::array<DeckCommand, capacity> commands;
+
+    std::atomic<int64> pushed{0};
+    std::atomic<int64> dropped{0};
+    std::atomic<int64> applied{0};
+    std::atomic<int> maxBacklog{0};
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(DeckCommandQueue)
+};
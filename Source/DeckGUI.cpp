@@ -19,23 +19,42 @@ I’ve updated most of the files by renaming, adding new features, refactoring t
 
 //==============================================================================
 DeckGUI::DeckGUI(DJAudioPlayer* player, 
-                AudioFormatManager& formatManagerToUse,
-                AudioThumbnailCache& cacheToUse) 
+                WaveformCache& cacheToUse) 
     : player(player), 
-      waveformDisplay(formatManagerToUse, cacheToUse) {
+      waveformDisplay(cacheToUse) {
     addAndMakeVisible(playButton);
     addAndMakeVisible(stopButton);
     addAndMakeVisible(loadButton);
+    addAndMakeVisible(ramToggle);
+    addAndMakeVisible(keyLockToggle);
+    addAndMakeVisible(syncToggle);
+    addAndMakeVisible(masterToggle);
+    addAndMakeVisible(autoGainToggle);
+    addAndMakeVisible(loopInButton);
+    addAndMakeVisible(loopOutButton);
+    addAndMakeVisible(beatLoopButton);
+    addAndMakeVisible(exitLoopButton);
+    addAndMakeVisible(qualityBox);
     
     addAndMakeVisible(volSlider);
     addAndMakeVisible(speedSlider);
     addAndMakeVisible(posSlider);
 
     addAndMakeVisible(waveformDisplay);
+    addChildComponent(loadProgressBar);
 
     playButton.addListener(this);
     stopButton.addListener(this);
     loadButton.addListener(this);
+    ramToggle.addListener(this);
+    keyLockToggle.addListener(this);
+    syncToggle.addListener(this);
+    masterToggle.addListener(this);
+    autoGainToggle.addListener(this);
+    loopInButton.addListener(this);
+    loopOutButton.addListener(this);
+    beatLoopButton.addListener(this);
+    exitLoopButton.addListener(this);
 
     volSlider.addListener(this);
     speedSlider.addListener(this);
@@ -56,6 +75,50 @@ DeckGUI::DeckGUI(DJAudioPlayer* player,
     loadButton.setColour(TextButton::buttonOnColourId, Colour(0, 130, 210));
     loadButton.setTooltip("Load a new audio file");
 
+    ramToggle.setColour(ToggleButton::textColourId, Colours::white);
+    ramToggle.setColour(ToggleButton::tickColourId, Colours::orange);
+    ramToggle.setTooltip("Decode the next loaded track into memory for instant seeking");
+
+    keyLockToggle.setColour(ToggleButton::textColourId, Colours::white);
+    keyLockToggle.setColour(ToggleButton::tickColourId, Colours::orange);
+    keyLockToggle.setTooltip("Keep the pitch when changing speed");
+
+    syncToggle.setColour(ToggleButton::textColourId, Colours::white);
+    syncToggle.setColour(ToggleButton::tickColourId, Colours::lightblue);
+    syncToggle.setTooltip("Lock tempo and beats to the master deck");
+
+    masterToggle.setColour(ToggleButton::textColourId, Colours::white);
+    masterToggle.setColour(ToggleButton::tickColourId, Colours::lightblue);
+    masterToggle.setTooltip("Make this the deck synced decks follow");
+
+    autoGainToggle.setColour(ToggleButton::textColourId, Colours::white);
+    autoGainToggle.setColour(ToggleButton::tickColourId, Colours::orange);
+    autoGainToggle.setTooltip("Play every track at the same loudness, measured when it loads");
+
+    for (int i = 0; i < DJAudioPlayer::numHotCues; ++i) {
+        auto* cueButton = hotCueButtons.add(new TextButton(String(i + 1)));
+        cueButton->setColour(TextButton::textColourOffId, Colours::white);
+        cueButton->setTooltip("Jump to hot cue " + String(i + 1) + ", or set it if it is empty. Shift-click to clear it");
+        cueButton->addListener(this);
+        addAndMakeVisible(cueButton);
+    }
+
+    loopInButton.setTooltip("Mark the start of a loop");
+    loopOutButton.setTooltip("Loop from the marked start to here");
+    beatLoopButton.setTooltip("Loop four beats from the nearest beat, once the track has been analysed");
+    exitLoopButton.setTooltip("Stop looping and play on");
+    updateCueDisplay();
+
+    using Quality = QualityResamplingAudioSource::Quality;
+    for (auto quality : { Quality::fast, Quality::sinc, Quality::highQuality })
+        qualityBox.addItem(QualityResamplingAudioSource::getQualityName(quality), static_cast<int>(quality) + 1);
+
+    qualityBox.setSelectedId(static_cast<int>(player->getResamplerQuality()) + 1, dontSendNotification);
+    qualityBox.setTooltip("Resampling quality when speed changes shift the pitch");
+    qualityBox.onChange = [this, player] {
+        player->setResamplerQuality(static_cast<QualityResamplingAudioSource::Quality>(qualityBox.getSelectedId() - 1));
+    };
+
     volSlider.setRange(0.0, 1.0);
     volSlider.setTextBoxStyle(Slider::TextBoxBelow, false, 60, 15);
     volSlider.setSliderStyle(Slider::SliderStyle::Rotary);
@@ -89,11 +152,27 @@ DeckGUI::DeckGUI(DJAudioPlayer* player,
         posSlider.setValue(pos, dontSendNotification);
     };
 
+    player->onLoadProgress = [this](double progress) {
+        loadProgress = progress;
+    };
+
+    player->onLoadFinished = [this](const URL& fileURL, bool loaded) {
+        loadFinished(fileURL, loaded);
+    };
+
+    player->onAnalysisFinished = [this] {
+        updateTempoDisplay();
+        storeAnalysis();
+    };
+
     startTimer(100);
 }
 
 DeckGUI::~DeckGUI() {
     stopTimer();
+    player->onLoadProgress = nullptr;
+    player->onLoadFinished = nullptr;
+    player->onAnalysisFinished = nullptr;
 }
 
 void DeckGUI::paint(Graphics& g) {
@@ -110,6 +189,11 @@ void DeckGUI::paint(Graphics& g) {
     g.setFont(16.0f);
     g.setColour(Colours::white);
     g.drawText("DECK", getLocalBounds().removeFromTop(25), Justification::centred, false);
+
+    g.setFont(13.0f);
+    g.setColour(Colours::lightgrey);
+    g.drawText(tempoText, getTempoArea(), Justification::centredRight, false);
+    g.drawText(keyText, getKeyArea(), Justification::centredLeft, false);
 }
 
 void DeckGUI::resized() {
@@ -119,6 +203,7 @@ void DeckGUI::resized() {
     
     auto waveformHeight = area.getHeight() * 0.35;
     waveformDisplay.setBounds(area.removeFromTop(waveformHeight));
+    loadProgressBar.setBounds(waveformDisplay.getBounds().removeFromBottom(20).reduced(6, 2));
     
     auto posHeight = 20;
     posSlider.setBounds(area.removeFromTop(posHeight).reduced(5, 0));
@@ -144,6 +229,29 @@ void DeckGUI::resized() {
     stopButton.setBounds(buttonArea.removeFromLeft(buttonWidth).reduced(5));
     buttonArea.removeFromLeft(10);
     loadButton.setBounds(buttonArea.reduced(5));
+
+    auto toggleArea = area.removeFromTop(24);
+    auto toggleWidth = toggleArea.getWidth() / 3;
+    ramToggle.setBounds(toggleArea.removeFromLeft(toggleWidth).reduced(5, 0));
+    keyLockToggle.setBounds(toggleArea.removeFromLeft(toggleWidth).reduced(5, 0));
+    qualityBox.setBounds(toggleArea.reduced(5, 1));
+
+    auto syncArea = area.removeFromTop(24);
+    syncToggle.setBounds(syncArea.removeFromLeft(toggleWidth).reduced(5, 0));
+    masterToggle.setBounds(syncArea.removeFromLeft(toggleWidth).reduced(5, 0));
+    autoGainToggle.setBounds(syncArea.reduced(5, 0));
+
+    auto cueArea = area.removeFromTop(26);
+    auto cueWidth = cueArea.getWidth() / DJAudioPlayer::numHotCues;
+    for (auto* cueButton : hotCueButtons)
+        cueButton->setBounds(cueArea.removeFromLeft(cueWidth).reduced(3, 1));
+
+    auto loopArea = area.removeFromTop(26);
+    auto loopWidth = loopArea.getWidth() / 4;
+    loopInButton.setBounds(loopArea.removeFromLeft(loopWidth).reduced(3, 1));
+    loopOutButton.setBounds(loopArea.removeFromLeft(loopWidth).reduced(3, 1));
+    beatLoopButton.setBounds(loopArea.removeFromLeft(loopWidth).reduced(3, 1));
+    exitLoopButton.setBounds(loopArea.reduced(3, 1));
 }
 
 void DeckGUI::buttonClicked(Button* button) {
@@ -155,6 +263,57 @@ void DeckGUI::buttonClicked(Button* button) {
         DBG("Stop button clicked");
         player->stop();
     }
+    else if (button == &ramToggle) {
+        player->setPlaybackMode(ramToggle.getToggleState() ? DJAudioPlayer::PlaybackMode::inMemory
+                                                           : DJAudioPlayer::PlaybackMode::streaming);
+    }
+    else if (button == &keyLockToggle) {
+        player->setKeyLock(keyLockToggle.getToggleState());
+    }
+    else if (button == &syncToggle) {
+        // The player sets the speed while synced; the slider follows it
+        player->setSyncEnabled(syncToggle.getToggleState());
+        speedSlider.setEnabled(!syncToggle.getToggleState());
+        updateSyncDisplay();
+    }
+    else if (button == &masterToggle) {
+        player->setSyncMaster(masterToggle.getToggleState());
+    }
+    else if (button == &autoGainToggle) {
+        player->setAutoGain(autoGainToggle.getToggleState());
+    }
+    else if (hotCueButtons.contains(static_cast<TextButton*>(button))) {
+        auto cue = hotCueButtons.indexOf(static_cast<TextButton*>(button));
+        if (ModifierKeys::currentModifiers.isShiftDown())
+            player->clearHotCue(cue);
+        else if (player->hasHotCue(cue))
+            player->jumpToHotCue(cue);
+        else
+            player->setHotCue(cue);
+        updateCueDisplay();
+    }
+    else if (button == &loopInButton) {
+        player->setLoopIn();
+    }
+    else if (button == &loopOutButton) {
+        player->setLoopOut();
+        updateCueDisplay();
+    }
+    else if (button == &beatLoopButton) {
+        if (!player->setBeatLoop(4.0))
+            DBG("Beat loop needs an analysed track");
+        updateCueDisplay();
+    }
+    else if (button == &exitLoopButton) {
+        player->exitLoop();
+        updateCueDisplay();
+    }
+    else if (button == &loadButton && player->isLoading()) {
+        DBG("Load cancelled");
+        player->cancelLoad();
+        waveformDisplay.cancelLoad();
+        showLoading(false);
+    }
     else if (button == &loadButton) {
         auto fileChooserFlags = FileBrowserComponent::canSelectFiles;
         
@@ -198,20 +357,136 @@ void DeckGUI::filesDropped(const StringArray& files, int x, int y) {
     }
 }
 
+bool DeckGUI::isInterestedInDragSource(const SourceDetails& dragSourceDetails) {
+    return dragSourceDetails.description.isString()
+        && File::isAbsolutePath(dragSourceDetails.description.toString());
+}
+
+void DeckGUI::itemDropped(const SourceDetails& dragSourceDetails) {
+    File file(dragSourceDetails.description.toString());
+
+    if (file.existsAsFile())
+        loadFileFromURL(URL(file));
+    else
+        DBG("DeckGUI: dropped track no longer exists: " + file.getFullPathName());
+}
+
 void DeckGUI::timerCallback() {
+    if (!waveformDisplay.isMouseButtonDown() && !posSlider.isMouseButtonDown()) {
+        posSlider.setValue(player->getAudiblePositionRelative(), dontSendNotification);
+    }
+
+    updateMemoryDisplay();
+    updateSyncDisplay();
+    updateTempoDisplay();
+}
+
+void DeckGUI::updatePlayhead() {
+    // Extrapolated from the last audio callback, so it moves every frame and matches what is heard
     if (!waveformDisplay.isMouseButtonDown()) {
-        waveformDisplay.setPositionRelative(player->getPositionRelative());
-        
-        if (!posSlider.isMouseButtonDown()) {
-            posSlider.setValue(player->getPositionRelative(), dontSendNotification);
-        }
+        waveformDisplay.setPositionRelative(player->getAudiblePositionRelative());
     }
 }
 
 void DeckGUI::loadFileFromURL(const URL& fileURL) {
     DBG("Loading file: " + fileURL.toString(false));
-    player->loadURL(fileURL);
-    waveformDisplay.loadURL(fileURL);
+    showLoading(true);
+
+    // The waveform is built from the player's decode pass instead of decoding the file again
+    player->loadURLAsync(fileURL, waveformDisplay.beginLoad());
+}
+
+void DeckGUI::loadFinished(const URL& fileURL, bool loaded) {
+    showLoading(false);
+
+    // Zooming past the pyramid reads samples from the memory-mapped PCM cache entry, if there is one
+    WaveformDisplay::FineDetailOpener openFineDetailReader;
+    if (loaded && fileURL.isLocalFile() && player->isUsingPcmCache()) {
+        openFineDetailReader = [this, file = fileURL.getLocalFile()] {
+            return player->getPcmCache().openReader(file);
+        };
+    }
+
+    waveformDisplay.finishLoad(loaded, std::move(openFineDetailReader));
+
+    if (loaded) {
+        posSlider.setValue(0.0, dontSendNotification);
+        loadedURL = fileURL;
+    }
+
+    // A new track starts without cues or a loop
+    updateCueDisplay();
+    updateMemoryDisplay();
+}
+
+void DeckGUI::updateTempoDisplay() {
+    String text;
+    auto grid = player->getBeatGrid();
+
+    if (grid.isValid())
+        text = String(grid.bpm * (player->isSyncEnabled() ? player->getCurrentSpeed() : speedSlider.getValue()), 2) + " BPM";
+    else if (player->isAnalysing())
+        text = "Analysing...";
+
+    if (text != tempoText) {
+        tempoText = text;
+        repaint(getTempoArea());
+    }
+
+    // The key is the track's own; speed changes shift the pitch only while key lock is off
+    auto key = player->getKey();
+    auto newKeyText = key.isValid() ? key.getName() + "  " + key.getCamelotCode() : String();
+
+    if (newKeyText != keyText) {
+        keyText = newKeyText;
+        repaint(getKeyArea());
+    }
+}
+
+void DeckGUI::storeAnalysis() {
+    if (!loadedURL.isLocalFile())
+        return;
+
+    if (auto analysis = player->getAnalysis())
+        if (library->updateAnalysis({ { loadedURL.getLocalFile(), analysis } }) > 0)
+            library->save();
+}
+
+Rectangle<int> DeckGUI::getTempoArea() const {
+    return getLocalBounds().removeFromTop(25).removeFromRight(120).withTrimmedRight(10);
+}
+
+Rectangle<int> DeckGUI::getKeyArea() const {
+    return getLocalBounds().removeFromTop(25).removeFromLeft(120).withTrimmedLeft(10);
+}
+
+void DeckGUI::updateSyncDisplay() {
+    // Another deck taking over as master clears this one
+    masterToggle.setToggleState(player->isSyncMaster(), dontSendNotification);
+
+    if (player->isSyncEnabled())
+        speedSlider.setValue(player->getCurrentSpeed(), dontSendNotification);
+}
+
+void DeckGUI::updateCueDisplay() {
+    for (int i = 0; i < hotCueButtons.size(); ++i)
+        hotCueButtons[i]->setColour(TextButton::buttonColourId, player->hasHotCue(i) ? Colour(200, 120, 0) : Colour(60, 60, 80));
+
+    auto loopColour = player->isLooping() ? Colour(0, 150, 90) : Colour(60, 60, 80);
+    for (auto* loopButton : { &loopInButton, &loopOutButton, &beatLoopButton, &exitLoopButton })
+        loopButton->setColour(TextButton::buttonColourId, loopColour);
+}
+
+void DeckGUI::showLoading(bool loading) {
+    loadProgress = 0.0;
+    loadProgressBar.setVisible(loading);
+    loadButton.setButtonText(loading ? "CANCEL" : "LOAD");
+    loadButton.setTooltip(loading ? "Cancel loading" : "Load a new audio file");
+}
+
+void DeckGUI::updateMemoryDisplay() {
+    auto megabytes = static_cast<double>(player->getMemoryUsageBytes()) / (1024.0 * 1024.0);
+    ramToggle.setButtonText(megabytes > 0.0 ? "RAM (" + String(megabytes, 1) + " MB)" : "RAM");
 }
 
 
@@ -15,6 +15,7 @@
 #include "../JuceLibraryCode/JuceHeader.h"
 #include "DJAudioPlayer.h"
 #include "WaveformDisplay.h"
+#include "TrackLibrary.h"
 
 /**
  * @class DeckGUI
@@ -22,22 +23,22 @@
  * 
  * Provides user interface for controlling audio playback, including
  * transport controls, volume/speed adjustment, and waveform display.
+ * Tracks can be dropped on the deck from the file system or the library browser.
  */
 class DeckGUI : public Component,
                 public Button::Listener,
                 public Slider::Listener,
                 public FileDragAndDropTarget,
+                public DragAndDropTarget,
                 public Timer {
 public:
     /**
      * Constructor for DeckGUI
      * @param player Pointer to the DJAudioPlayer that this GUI will control
-     * @param formatManagerToUse Reference to the AudioFormatManager for audio file loading
-     * @param cacheToUse Reference to the AudioThumbnailCache for waveform display
+     * @param cacheToUse Reference to the disk cache of waveforms
      */
     DeckGUI(DJAudioPlayer* player,
-           AudioFormatManager& formatManagerToUse,
-           AudioThumbnailCache& cacheToUse);
+           WaveformCache& cacheToUse);
     
     /** Destructor */
     ~DeckGUI() override;
@@ -76,11 +77,21 @@ public:
     /** Handles dropped files */
     void filesDropped(const StringArray& files, int x, int y) override;
 
+    //==========================================================================
+    // DragAndDropTarget overrides
+    //==========================================================================
+
+    /** Accepts tracks dragged from the library browser, described by their paths */
+    bool isInterestedInDragSource(const SourceDetails& dragSourceDetails) override;
+
+    /** Loads a track dragged from the library browser */
+    void itemDropped(const SourceDetails& dragSourceDetails) override;
+
     //==========================================================================
     // Timer override
     //==========================================================================
     
-    /** Updates playhead position periodically */
+    /** Updates the position slider, memory display and sync state periodically */
     void timerCallback() override;
 
 private:
@@ -89,6 +100,36 @@ private:
      * @param fileURL URL of the audio file to load
      */
     void loadFileFromURL(const URL& fileURL);
+
+    /** Called by the player when a background load has finished or failed */
+    void loadFinished(const URL& fileURL, bool loaded);
+
+    /** Switches the load button and progress bar between idle and loading */
+    void showLoading(bool loading);
+
+    /** Shows how much decoded audio the deck holds next to the RAM toggle */
+    void updateMemoryDisplay();
+
+    /** Moves the waveform playhead to the audible position, once per display frame */
+    void updatePlayhead();
+
+    /** Shows the track's key, and its tempo at the current speed, in the header once it has been analysed */
+    void updateTempoDisplay();
+
+    /** Stores the finished analysis in the library, if the track is in it */
+    void storeAnalysis();
+
+    /** Gets the part of the header the tempo is drawn in */
+    Rectangle<int> getTempoArea() const;
+
+    /** Gets the part of the header the key is drawn in */
+    Rectangle<int> getKeyArea() const;
+
+    /** Shows the synced speed on the speed slider and which deck is master */
+    void updateSyncDisplay();
+
+    /** Lights the hot cues that are set, and the loop buttons while looping */
+    void updateCueDisplay();
     
     //==========================================================================
     // UI Components
@@ -98,6 +139,21 @@ private:
     TextButton playButton{"PLAY"};
     TextButton stopButton{"STOP"};
     TextButton loadButton{"LOAD"};
+    ToggleButton ramToggle{"RAM"};
+    ToggleButton keyLockToggle{"KEY LOCK"};
+    ToggleButton syncToggle{"SYNC"};
+    ToggleButton masterToggle{"MASTER"};
+    ToggleButton autoGainToggle{"AUTO GAIN"};
+
+    // Hot cues and loops
+    OwnedArray<TextButton> hotCueButtons;
+    TextButton loopInButton{"IN"};
+    TextButton loopOutButton{"OUT"};
+    TextButton beatLoopButton{"4 BEATS"};
+    TextButton exitLoopButton{"EXIT"};
+
+    // Resampler quality selector
+    ComboBox qualityBox;
     
     // Sliders
     Slider volSlider;
@@ -109,9 +165,24 @@ private:
     
     // Waveform display
     WaveformDisplay waveformDisplay;
+
+    // Background load progress, polled by the progress bar
+    double loadProgress = 0.0;
+    ProgressBar loadProgressBar{loadProgress};
     
     // Reference to the audio player
     DJAudioPlayer* player;
 
+    // The track last loaded, and the library its analysis is stored in
+    URL loadedURL;
+    SharedResourcePointer<TrackLibrary> library;
+
+    // Tempo shown in the header
+    String tempoText;
+    String keyText;
+
+    // Drives updatePlayhead at display refresh rate; declared last so it stops first
+    VBlankAttachment vBlankAttachment{this, [this] { updatePlayhead(); }};
+
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(DeckGUI)
 };
@@ -0,0 +1,342 @@
+/*
+  ==============================================================================
+
+    DeckMixerEngine.cpp
+    Created: 17 Oct 2026 12:52:19am
+
+  ==============================================================================
+*/
+
+#include "DeckMixerEngine.h"
+
+#if JUCE_MAC || JUCE_IOS
+ #include <dispatch/dispatch.h>
+#elif ! JUCE_WINDOWS
+ #include <semaphore.h>
+#endif
+
+namespace {
+
+/**
+ * Semaphore the audio thread can post without taking a lock
+ *
+ * The count lives in an atomic, so a post only reaches the OS when the waiter has
+ * actually blocked. Waiting spins briefly first, as the next post is often moments away.
+ * There must be at most one waiter.
+ */
+class WakeSemaphore {
+public:
+    WakeSemaphore() {
+       #if JUCE_MAC || JUCE_IOS
+        semaphore = dispatch_semaphore_create(0);
+       #elif ! JUCE_WINDOWS
+        sem_init(&semaphore, 0, 0);
+       #endif
+    }
+
+    ~WakeSemaphore() {
+       #if JUCE_MAC || JUCE_IOS
+        dispatch_release(semaphore);
+       #elif ! JUCE_WINDOWS
+        sem_destroy(&semaphore);
+       #endif
+    }
+
+    /** Lets the waiter through once (any thread) */
+    void post() noexcept {
+        if (count.fetch_add(1, std::memory_order_release) < 0) {
+           #if JUCE_MAC || JUCE_IOS
+            dispatch_semaphore_signal(semaphore);
+           #elif JUCE_WINDOWS
+            event.signal();
+           #else
+            sem_post(&semaphore);
+           #endif
+        }
+    }
+
+    /** Waits for a post, spinning for a few microseconds before blocking */
+    void wait() noexcept {
+        for (int spins = 0; spins < spinsBeforeBlocking; ++spins) {
+            auto current = count.load(std::memory_order_relaxed);
+            if (current > 0 && count.compare_exchange_weak(current, current - 1, std::memory_order_acquire))
+                return;
+        }
+
+        if (count.fetch_sub(1, std::memory_order_acquire) > 0)
+            return;
+
+       #if JUCE_MAC || JUCE_IOS
+        dispatch_semaphore_wait(semaphore, DISPATCH_TIME_FOREVER);
+       #elif JUCE_WINDOWS
+        event.wait();
+       #else
+        while (sem_wait(&semaphore) != 0 && errno == EINTR) {}
+       #endif
+    }
+
+private:
+    /** Checks of the count before blocking, a few microseconds' worth */
+    static constexpr int spinsBeforeBlocking = 2000;
+
+    std::atomic<int> count{0};
+
+   #if JUCE_MAC || JUCE_IOS
+    dispatch_semaphore_t semaphore;
+   #elif JUCE_WINDOWS
+    // With a single waiter an auto-reset event behaves as the semaphore, and it is only
+    // signalled when the waiter is blocked
+    WaitableEvent event;
+   #else
+    sem_t semaphore;
+   #endif
+
+    JUCE_DECLARE_NON_COPYABLE(WakeSemaphore)
+};
+
+} // namespace
+
+//==============================================================================
+/**
+ * A real-time thread that helps render decks whenever the audio thread wakes it
+ *
+ * The audio thread only wakes as many workers as a chunk has decks to spare, and the
+ * rest stay blocked, so idle workers never compete with the app's other threads.
+ */
+class DeckMixerEngine::Worker : public Thread {
+public:
+    Worker(DeckMixerEngine& owner, int index)
+        : Thread("Deck render " + String(index + 1)),
+          owner(owner) {
+    }
+
+    ~Worker() override {
+        stop();
+    }
+
+    void start(int blockSize, double sampleRate) {
+        if (isThreadRunning())
+            return;
+
+        auto options = Thread::RealtimeOptions{}.withApproximateAudioProcessingTime(blockSize, sampleRate);
+
+        if (!startRealtimeThread(options)) {
+            DBG("DeckMixerEngine: no real-time priority for " + getThreadName());
+            startThread(Priority::highest);
+        }
+    }
+
+    void stop() {
+        signalThreadShouldExit();
+        wakeSemaphore.post();
+        stopThread(2000);
+    }
+
+    /** Has the worker help with the chunk just published (audio thread) */
+    void wake() noexcept {
+        wakeSemaphore.post();
+    }
+
+    void run() override {
+        WorkgroupToken token;
+        owner.audioWorkgroup.join(token);
+
+        for (;;) {
+            wakeSemaphore.wait();
+
+            if (threadShouldExit())
+                return;
+
+            // A wake for a chunk the other threads have already finished finds nothing to claim
+            owner.renderAvailableDecks();
+        }
+    }
+
+private:
+    DeckMixerEngine& owner;
+    WakeSemaphore wakeSemaphore;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(Worker)
+};
+
+//==============================================================================
+DeckMixerEngine::DeckMixerEngine(int numWorkerThreads)
+    : numWorkerThreads(jlimit(0, maxDecks - 1, numWorkerThreads < 0 ? getDefaultNumWorkerThreads() : numWorkerThreads)) {
+    for (auto& deck : decks)
+        deck.store(nullptr);
+
+    for (int i = 0; i < this->numWorkerThreads; ++i)
+        workers.add(new Worker(*this, i));
+}
+
+DeckMixerEngine::~DeckMixerEngine() {
+    stopWorkers();
+}
+
+bool DeckMixerEngine::addDeck(AudioSource* deck) {
+    jassert(deck != nullptr);
+
+    auto index = numDecks.load();
+    if (index >= maxDecks) {
+        DBG("DeckMixerEngine::addDeck already mixing " + String(maxDecks) + " decks");
+        return false;
+    }
+
+    if (prepared)
+        deck->prepareToPlay(maxBlockSize, currentSampleRate);
+
+    // The slot is filled before the count that makes it visible to the audio thread
+    decks[static_cast<size_t>(index)].store(deck, std::memory_order_release);
+    numDecks.store(index + 1, std::memory_order_release);
+
+    if (prepared)
+        startWorkers();
+
+    return true;
+}
+
+int DeckMixerEngine::getNumDecks() const noexcept {
+    return numDecks.load();
+}
+
+int DeckMixerEngine::getNumWorkerThreads() const noexcept {
+    return numWorkerThreads;
+}
+
+void DeckMixerEngine::setAudioWorkgroup(const AudioWorkgroup& workgroup) {
+    audioWorkgroup = workgroup;
+}
+
+//==============================================================================
+void DeckMixerEngine::prepareToPlay(int samplesPerBlockExpected, double sampleRate) {
+    stopWorkers();
+
+    maxBlockSize = jmax(1, samplesPerBlockExpected);
+    currentSampleRate = sampleRate;
+
+    for (auto& bus : deckBuses)
+        bus.setSize(numDeckChannels, maxBlockSize);
+
+    for (int i = 0; i < numDecks.load(); ++i)
+        decks[static_cast<size_t>(i)].load()->prepareToPlay(maxBlockSize, sampleRate);
+
+    prepared = true;
+    startWorkers();
+}
+
+void DeckMixerEngine::releaseResources() {
+    stopWorkers();
+    prepared = false;
+
+    for (int i = 0; i < numDecks.load(); ++i)
+        decks[static_cast<size_t>(i)].load()->releaseResources();
+
+    for (auto& bus : deckBuses)
+        bus.setSize(numDeckChannels, 0);
+}
+
+void DeckMixerEngine::getNextAudioBlock(const AudioSourceChannelInfo& bufferToFill) {
+    if (!prepared || numDecks.load(std::memory_order_acquire) == 0) {
+        bufferToFill.clearActiveBufferRegion();
+        return;
+    }
+
+    deckTimings.fill({});
+
+    // The buses hold one prepared block, so a longer callback is rendered in pieces
+    for (int offset = 0; offset < bufferToFill.numSamples; offset += maxBlockSize) {
+        renderChunk(AudioSourceChannelInfo(bufferToFill.buffer, bufferToFill.startSample + offset,
+                                           jmin(maxBlockSize, bufferToFill.numSamples - offset)));
+    }
+}
+
+DeckMixerEngine::DeckTiming DeckMixerEngine::getDeckTiming(int deck) const noexcept {
+    return isPositiveAndBelow(deck, maxDecks) ? deckTimings[static_cast<size_t>(deck)] : DeckTiming{};
+}
+
+//==============================================================================
+void DeckMixerEngine::renderChunk(const AudioSourceChannelInfo& bufferToFill) {
+    auto decksThisChunk = numDecks.load(std::memory_order_acquire);
+
+    chunkNumSamples.store(bufferToFill.numSamples, std::memory_order_relaxed);
+    decksRemaining.store(decksThisChunk, std::memory_order_relaxed);
+    tempoSync->setTimelinePosition(samplesRendered);
+    samplesRendered += bufferToFill.numSamples;
+    claim.store(encodeClaim(++chunkNumber, decksThisChunk));
+
+    // Only as many workers as there are decks beyond the one the audio thread takes
+    for (int i = 0; i < jmin(numStartedWorkers.load(std::memory_order_acquire), decksThisChunk - 1); ++i)
+        workers.getUnchecked(i)->wake();
+
+    renderAvailableDecks();
+
+    // The audio thread has run out of decks to claim; the last few are finishing on workers
+    for (int spins = 0; decksRemaining.load(std::memory_order_acquire) > 0; ++spins) {
+        if (spins > 1000)
+            std::this_thread::yield();
+    }
+
+    auto& output = *bufferToFill.buffer;
+    auto numOutputChannels = output.getNumChannels();
+    auto numChannelsToMix = jmin(numOutputChannels, numDeckChannels);
+
+    for (int chan = 0; chan < numChannelsToMix; ++chan) {
+        output.copyFrom(chan, bufferToFill.startSample, deckBuses[0], chan, 0, bufferToFill.numSamples);
+
+        for (int deck = 1; deck < decksThisChunk; ++deck)
+            output.addFrom(chan, bufferToFill.startSample, deckBuses[static_cast<size_t>(deck)], chan, 0, bufferToFill.numSamples);
+    }
+
+    for (int chan = numChannelsToMix; chan < numOutputChannels; ++chan)
+        output.clear(chan, bufferToFill.startSample, bufferToFill.numSamples);
+}
+
+int DeckMixerEngine::renderAvailableDecks() {
+    auto numRendered = 0;
+
+    for (;;) {
+        auto claimed = claim.fetch_add(1, std::memory_order_acq_rel);
+        auto index = static_cast<int>(claimed & 0xffff);
+        auto decksInChunk = static_cast<int>((claimed >> 16) & 0xffff);
+
+        // Either every deck is taken, or this is a stale claim on a chunk that has already finished
+        if (index >= decksInChunk)
+            return numRendered;
+
+        auto numSamples = chunkNumSamples.load(std::memory_order_relaxed);
+        auto& bus = deckBuses[static_cast<size_t>(index)];
+        auto startMs = Time::getMillisecondCounterHiRes();
+
+        decks[static_cast<size_t>(index)].load(std::memory_order_relaxed)
+            ->getNextAudioBlock(AudioSourceChannelInfo(&bus, 0, numSamples));
+
+        auto& timing = deckTimings[static_cast<size_t>(index)];
+        if (timing.durationMs == 0.0)
+            timing.startMs = startMs;
+        timing.durationMs += Time::getMillisecondCounterHiRes() - startMs;
+
+        ++numRendered;
+        decksRemaining.fetch_sub(1, std::memory_order_acq_rel);
+    }
+}
+
+void DeckMixerEngine::startWorkers() {
+    // A chunk never has work for more workers than decks beyond the audio thread's own
+    auto numNeeded = jmin(workers.size(), numDecks.load() - 1);
+
+    for (int i = numStartedWorkers.load(); i < numNeeded; ++i)
+        workers.getUnchecked(i)->start(maxBlockSize, currentSampleRate);
+
+    numStartedWorkers.store(jmax(numStartedWorkers.load(), numNeeded), std::memory_order_release);
+}
+
+void DeckMixerEngine::stopWorkers() {
+    numStartedWorkers.store(0, std::memory_order_release);
+
+    for (auto* worker : workers)
+        worker->stop();
+}
+
+int DeckMixerEngine::getDefaultNumWorkerThreads() {
+    return jlimit(0, maxDecks - 1, SystemStats::getNumCpus() - 1);
+}
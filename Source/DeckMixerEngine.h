@@ -0,0 +1,156 @@
+/*
+  ==============================================================================
+
+    DeckMixerEngine.h
+    Created: 17 Oct 2026 12:52:19am
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include "TempoSync.h"
+
+/**
+ * @class DeckMixerEngine
+ * @brief Mixes up to maxDecks decks into the master bus, rendering them in parallel
+ *
+ * Each block, every deck renders into its own bus on whichever thread claims it
+ * first: the audio callback itself or one of a small pool of real-time workers.
+ * Decks are claimed from a single lock-free counter, so a thread that finishes a
+ * cheap deck just takes the next one. The callback then waits for the last deck
+ * and sums the buses, so its time follows the slowest share of the work rather
+ * than the number of decks.
+ *
+ * A deck only ever renders on one thread at a time, and every hand-over between
+ * threads goes through the claim counter, so decks need no locking of their own.
+ *
+ * On platforms with audio workgroups (macOS), the workers join the device's
+ * workgroup so the OS schedules them as part of the audio callback.
+ *
+ * The engine also keeps the output timeline for TempoSync: before each chunk is
+ * published it stamps the chunk's first sample, so synced decks rendering on any
+ * thread agree on when their blocks will be heard.
+ */
+class DeckMixerEngine : public AudioSource {
+public:
+    /** Most decks the engine can mix */
+    static constexpr int maxDecks = 16;
+
+    /** Channels in each deck's bus */
+    static constexpr int numDeckChannels = 2;
+
+    /**
+     * Constructor for DeckMixerEngine
+     * @param numWorkerThreads Most real-time helpers besides the audio thread, or -1 for one per spare core;
+     *                         only as many are started as there are decks beyond the first
+     */
+    explicit DeckMixerEngine(int numWorkerThreads = -1);
+
+    /** Destructor - stops the workers */
+    ~DeckMixerEngine() override;
+
+    //==========================================================================
+    // Decks
+    //==========================================================================
+
+    /**
+     * Adds a deck to the mix (message thread)
+     * The deck is prepared first if the engine is already playing. It isn't owned
+     * and must outlive the engine, or at least the audio device.
+     * @return false if the engine already has maxDecks decks
+     */
+    bool addDeck(AudioSource* deck);
+
+    /** Gets the number of decks being mixed */
+    int getNumDecks() const noexcept;
+
+    /** Gets the most real-time worker threads the engine will start, not counting the audio thread */
+    int getNumWorkerThreads() const noexcept;
+
+    /**
+     * Sets the workgroup the workers join when they next start
+     * Pass the device's workgroup before prepareToPlay().
+     */
+    void setAudioWorkgroup(const AudioWorkgroup& workgroup);
+
+    //==========================================================================
+    // AudioSource overrides
+    //==========================================================================
+
+    /** Prepares every deck, sizes the buses and starts the workers */
+    void prepareToPlay(int samplesPerBlockExpected, double sampleRate) override;
+
+    /** Stops the workers and releases every deck */
+    void releaseResources() override;
+
+    /** Renders all decks in parallel and sums them into the buffer */
+    void getNextAudioBlock(const AudioSourceChannelInfo& bufferToFill) override;
+
+    //==========================================================================
+    // Profiling
+    //==========================================================================
+
+    /** When a deck first started rendering in the last block and its total render time, in milliseconds */
+    struct DeckTiming {
+        double startMs = 0.0;
+        double durationMs = 0.0;
+    };
+
+    /** Gets a deck's timing for the last block (audio thread, after getNextAudioBlock) */
+    DeckTiming getDeckTiming(int deck) const noexcept;
+
+private:
+    class Worker;
+
+    /** Renders one chunk of at most the prepared block size */
+    void renderChunk(const AudioSourceChannelInfo& bufferToFill);
+
+    /**
+     * Claims and renders decks of the current chunk until none are left (any thread)
+     * @return the number of decks this thread rendered
+     */
+    int renderAvailableDecks();
+
+    /** Starts the workers the current decks need, with the current timing and workgroup */
+    void startWorkers();
+
+    /** Stops the workers */
+    void stopWorkers();
+
+    /** Gets the default worker count: one per core beyond the audio thread */
+    static int getDefaultNumWorkerThreads();
+
+    // The claim counter packs the chunk number, its deck count and the next deck to claim,
+    // so a late claim from an earlier chunk can never be mistaken for one in the current chunk
+    static constexpr uint64 encodeClaim(uint32 chunk, int numDecks) noexcept {
+        return (static_cast<uint64>(chunk) << 32) | (static_cast<uint64>(numDecks) << 16);
+    }
+
+    std::array<std::atomic<AudioSource*>, maxDecks> decks{};
+    std::atomic<int> numDecks{0};
+
+    std::array<AudioBuffer<float>, maxDecks> deckBuses;
+    int maxBlockSize = 0;
+    double currentSampleRate = 0.0;
+    bool prepared = false;
+
+    // State of the chunk being rendered; written by the audio thread before it publishes the claim counter
+    std::atomic<int> chunkNumSamples{0};
+    std::atomic<uint64> claim{0};
+    std::atomic<int> decksRemaining{0};
+    uint32 chunkNumber = 0;
+    int64 samplesRendered = 0;
+
+    // Each written only by the thread rendering that deck, and read after decksRemaining reaches zero
+    std::array<DeckTiming, maxDecks> deckTimings{};
+
+    int numWorkerThreads;
+    OwnedArray<Worker> workers;
+    std::atomic<int> numStartedWorkers{0};
+    AudioWorkgroup audioWorkgroup;
+    SharedResourcePointer<TempoSync> tempoSync;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(DeckMixerEngine)
+};
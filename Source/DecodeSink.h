@@ -0,0 +1,48 @@
+/*
+  ==============================================================================
+
+    DecodeSink.h
+    Created: 16 Oct 2026 4:35:18pm
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "../JuceLibraryCode/JuceHeader.h"
+
+/**
+ * @class DecodeSink
+ * @brief Receives the decoded audio of a track as the loader reads through it
+ *
+ * A track is decoded once per load, and every consumer of the full audio (the
+ * waveform, analysis) is fed from that one pass. All methods are called on one
+ * worker thread, the loader's or the decode pool's, in order, with blocks in
+ * ascending sample order.
+ */
+class DecodeSink {
+public:
+    virtual ~DecodeSink() = default;
+
+    /**
+     * Called once the track is opened, before any decoding
+     * @param contentHash Hash of the file's content, or empty if it isn't a local file
+     * @return false if the sink already has what it needs, so it can be skipped;
+     *         if no consumer needs the audio the decode pass is skipped altogether
+     */
+    virtual bool trackIdentified(const String& contentHash) { ignoreUnused(contentHash); return true; }
+
+    /** Called before the first block */
+    virtual void decodeStarted(int numChannels, double sampleRate, int64 lengthInSamples) = 0;
+
+    /**
+     * Called for each decoded block
+     * @param block Buffer holding the samples, starting at sample 0
+     * @param numSamples Number of valid samples in the block
+     * @param startSample Position of the block's first sample in the track
+     */
+    virtual void decodedBlock(const AudioBuffer<float>& block, int numSamples, int64 startSample) = 0;
+
+    /** Called after the last block, with completed false if the load was cancelled */
+    virtual void decodeFinished(bool completed) { ignoreUnused(completed); }
+};
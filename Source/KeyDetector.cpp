@@ -0,0 +1,239 @@
+/*
+  ==============================================================================
+
+    KeyDetector.cpp
+    Created: 17 Oct 2026 10:22:37am
+
+  ==============================================================================
+*/
+
+#include "KeyDetector.h"
+
+namespace {
+
+// 0.74 s frames every 0.37 s at the analysis rate: bins 1.35 Hz apart, narrow enough to
+// separate semitones from the bass upwards. Key needs no finer resolution in time
+constexpr int fftOrder = 13;
+constexpr int fftSize = 1 << fftOrder;
+constexpr int hopSize = fftSize / 2;
+
+/** Frequencies folded into the chromagram, in Hz; below this the Hann window blurs neighbouring semitones */
+constexpr double minFrequency = 80.0;
+constexpr double maxFrequency = 2100.0;
+
+/** Frames handed out at a time; enough chunks that threads finish together */
+constexpr int framesPerChunk = 16;
+
+/** Fewest frames worth analysing, about six seconds */
+constexpr int minFrames = 16;
+
+/** Frames whose summed magnitude is below this are silence and are skipped */
+constexpr double silenceThreshold = 1.0e-3;
+
+/** Krumhansl-Kessler key profiles, from the tonic up in semitones */
+constexpr double majorProfile[12] = { 6.35, 2.23, 3.48, 2.33, 4.38, 4.09, 2.52, 5.19, 2.39, 3.66, 2.29, 2.88 };
+constexpr double minorProfile[12] = { 6.33, 2.68, 3.52, 5.38, 2.60, 3.53, 2.54, 4.75, 3.98, 2.69, 3.34, 3.17 };
+
+const char* const pitchNames[12] = { "C", "C#", "D", "Eb", "E", "F", "F#", "G", "Ab", "A", "Bb", "B" };
+
+using Chroma = std::array<double, 12>;
+
+/**
+ * One track's chromagram, computed by several threads at once
+ * Held through a shared_ptr by every worker job, so a job that only starts once the
+ * work is done still has something to look at; it finds no chunks left and returns.
+ */
+struct ChromaWork {
+    const float* samples = nullptr;
+    int numFrames = 0;
+    int numChunks = 0;
+
+    std::vector<float> window;
+    int firstBin = 0;
+    std::vector<int> binPitchClass;
+    std::vector<float> binWeight;
+
+    std::atomic<int> nextChunk{ 0 };
+    std::atomic<int> chunksDone{ 0 };
+    std::atomic<bool> abandoned{ false };
+    WaitableEvent allDone;
+
+    CriticalSection totalLock;
+    Chroma total{};
+};
+
+/** Adds one frame's pitch-class profile to a chromagram, normalised so every frame counts the same */
+void addFrame(const ChromaWork& work, const dsp::FFT& fft, std::vector<float>& buffer, int frame, Chroma& chroma) {
+    const auto* frameStart = work.samples + static_cast<size_t>(frame) * hopSize;
+
+    FloatVectorOperations::multiply(buffer.data(), frameStart, work.window.data(), fftSize);
+    fft.performFrequencyOnlyForwardTransform(buffer.data(), true);
+
+    Chroma frameChroma{};
+    double sum = 0.0;
+
+    for (size_t i = 0; i < work.binPitchClass.size(); ++i) {
+        auto magnitude = static_cast<double>(buffer[static_cast<size_t>(work.firstBin) + i] * work.binWeight[i]);
+        frameChroma[static_cast<size_t>(work.binPitchClass[i])] += magnitude;
+        sum += magnitude;
+    }
+
+    if (sum < silenceThreshold)
+        return;
+
+    for (size_t pitchClass = 0; pitchClass < 12; ++pitchClass)
+        chroma[pitchClass] += frameChroma[pitchClass] / sum;
+}
+
+/** Claims chunks of frames until there are none left; run by the caller, which passes shouldExit, and every worker */
+void processChunks(ChromaWork& work, const std::function<bool()>& shouldExit = {}) {
+    dsp::FFT fft(fftOrder);
+    std::vector<float> buffer(static_cast<size_t>(fftSize) * 2);
+
+    for (;;) {
+        auto chunk = work.nextChunk.fetch_add(1);
+        if (chunk >= work.numChunks)
+            return;
+
+        if (shouldExit && shouldExit())
+            work.abandoned = true;
+
+        if (!work.abandoned.load()) {
+            Chroma chroma{};
+            auto endFrame = jmin(work.numFrames, (chunk + 1) * framesPerChunk);
+
+            for (auto frame = chunk * framesPerChunk; frame < endFrame; ++frame)
+                addFrame(work, fft, buffer, frame, chroma);
+
+            const ScopedLock sl(work.totalLock);
+            for (size_t pitchClass = 0; pitchClass < 12; ++pitchClass)
+                work.total[pitchClass] += chroma[pitchClass];
+        }
+
+        // Counted after the chunk is in the total, so the caller never reads it half added
+        if (work.chunksDone.fetch_add(1) + 1 == work.numChunks)
+            work.allDone.signal();
+    }
+}
+
+/** Correlates a chromagram with a key profile rotated to a tonic */
+double correlate(const Chroma& chroma, const double* profile, int tonic) {
+    double chromaMean = 0.0, profileMean = 0.0;
+    for (int i = 0; i < 12; ++i) {
+        chromaMean += chroma[static_cast<size_t>((i + tonic) % 12)];
+        profileMean += profile[i];
+    }
+    chromaMean /= 12.0;
+    profileMean /= 12.0;
+
+    double covariance = 0.0, chromaVariance = 0.0, profileVariance = 0.0;
+    for (int i = 0; i < 12; ++i) {
+        auto c = chroma[static_cast<size_t>((i + tonic) % 12)] - chromaMean;
+        auto p = profile[i] - profileMean;
+        covariance += c * p;
+        chromaVariance += c * c;
+        profileVariance += p * p;
+    }
+
+    auto denominator = std::sqrt(chromaVariance * profileVariance);
+    return denominator > 0.0 ? covariance / denominator : 0.0;
+}
+
+} // namespace
+
+//==============================================================================
+String MusicalKey::getName() const {
+    if (!isValid())
+        return {};
+
+    return String(pitchNames[tonic]) + (minor ? "m" : "");
+}
+
+String MusicalKey::getCamelotCode() const {
+    if (!isValid())
+        return {};
+
+    // The wheel goes round in fifths, with 8B on C major and each minor key sharing its relative major's number
+    auto relativeMajor = minor ? (tonic + 3) % 12 : tonic;
+    auto number = (relativeMajor * 7 + 7) % 12 + 1;
+    return String(number) + (minor ? "A" : "B");
+}
+
+MusicalKey MusicalKey::fromCode(int code) noexcept {
+    MusicalKey key;
+
+    if (code >= 1 && code <= 24) {
+        key.tonic = (code - 1) % 12;
+        key.minor = code > 12;
+    }
+
+    return key;
+}
+
+//==============================================================================
+MusicalKey KeyDetector::analyse(const float* samples, int numSamples, double sampleRate,
+                                ThreadPool* workers, const std::function<bool()>& shouldExit) {
+    auto numFrames = numSamples >= fftSize ? 1 + (numSamples - fftSize) / hopSize : 0;
+    if (numFrames < minFrames || sampleRate <= 0.0)
+        return {};
+
+    auto work = std::make_shared<ChromaWork>();
+    work->samples = samples;
+    work->numFrames = numFrames;
+    work->numChunks = (numFrames + framesPerChunk - 1) / framesPerChunk;
+
+    work->window.resize(static_cast<size_t>(fftSize));
+    dsp::WindowingFunction<float>::fillWindowingTables(work->window.data(), fftSize,
+                                                       dsp::WindowingFunction<float>::hann, false);
+
+    // Each bin goes to its nearest semitone, weighted down towards the quarter tones in between
+    auto binHz = sampleRate / fftSize;
+    work->firstBin = jmax(1, static_cast<int>(std::ceil(minFrequency / binHz)));
+    auto lastBin = jmin(fftSize / 2 - 1, static_cast<int>(maxFrequency / binHz));
+
+    for (auto bin = work->firstBin; bin <= lastBin; ++bin) {
+        auto midiNote = 69.0 + 12.0 * std::log2(bin * binHz / 440.0);
+        auto nearest = std::round(midiNote);
+        auto closeness = std::cos(MathConstants<double>::pi * (midiNote - nearest));
+
+        work->binPitchClass.push_back((static_cast<int>(nearest) % 12 + 12) % 12);
+        work->binWeight.push_back(static_cast<float>(closeness * closeness));
+    }
+
+    if (workers != nullptr) {
+        auto numJobs = jmin(workers->getNumThreads(), work->numChunks - 1);
+        for (int i = 0; i < numJobs; ++i)
+            workers->addJob([work] { processChunks(*work); });
+    }
+
+    // The caller takes chunks too, so the analysis finishes even if every worker is busy
+    processChunks(*work, shouldExit);
+
+    while (work->chunksDone.load() < work->numChunks) {
+        if (shouldExit && shouldExit())
+            work->abandoned = true;
+
+        work->allDone.wait(50);
+    }
+
+    if (work->abandoned.load() || (shouldExit && shouldExit()))
+        return {};
+
+    MusicalKey key;
+    double bestCorrelation = 0.0;
+
+    for (int tonic = 0; tonic < 12; ++tonic) {
+        for (auto minor : { false, true }) {
+            auto correlation = correlate(work->total, minor ? minorProfile : majorProfile, tonic);
+
+            if (correlation > bestCorrelation) {
+                bestCorrelation = correlation;
+                key.tonic = tonic;
+                key.minor = minor;
+            }
+        }
+    }
+
+    key.confidence = static_cast<float>(jlimit(0.0, 1.0, bestCorrelation));
+    return key;
+}
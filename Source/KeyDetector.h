@@ -0,0 +1,68 @@
+/*
+  ==============================================================================
+
+    KeyDetector.h
+    Created: 17 Oct 2026 10:22:37am
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "../JuceLibraryCode/JuceHeader.h"
+
+/**
+ * @struct MusicalKey
+ * @brief The key a track is in, as a tonic and a mode
+ */
+struct MusicalKey {
+    int tonic = -1;             /**< Pitch class of the tonic, 0 for C up to 11 for B, or -1 if unknown */
+    bool minor = false;         /**< True for a minor key, false for major */
+    float confidence = 0.0f;    /**< How closely the track's pitch content fits the key, 0 to 1 */
+
+    /** Returns true if the key is known */
+    bool isValid() const noexcept { return isPositiveAndBelow(tonic, 12); }
+
+    /** Gets the key's name, e.g. "F#" or "Am" */
+    String getName() const;
+
+    /** Gets the key's Camelot wheel code, e.g. "8A" for A minor; keys a step apart mix well */
+    String getCamelotCode() const;
+
+    /** Packs the key into a number for storing: 0 if unknown, 1 to 12 for major keys, 13 to 24 for minor */
+    int getCode() const noexcept { return isValid() ? 1 + tonic + (minor ? 12 : 0) : 0; }
+
+    /** Unpacks a key stored with getCode(); the confidence isn't stored */
+    static MusicalKey fromCode(int code) noexcept;
+};
+
+/**
+ * @struct KeyDetector
+ * @brief Finds the key of a track from its chromagram
+ *
+ * The mono signal is cut into overlapping frames, transformed with dsp::FFT, and
+ * each bin's magnitude is added to the pitch class nearest its frequency, weighted
+ * by how close it is. Every frame counts equally, so loud passages don't outweigh
+ * quiet ones. The pitch-class profile of the whole track is then compared with
+ * the Krumhansl-Kessler profiles of all 24 keys and the best match wins.
+ *
+ * Frames are independent, so they are shared out in chunks between the calling
+ * thread and a pool of workers, and a track takes a fraction of a second.
+ *
+ * Tuned for a signal downsampled to around BeatDetector::analysisSampleRate, which
+ * keeps everything up to the seventh octave.
+ */
+struct KeyDetector {
+    /**
+     * Analyses a whole track
+     * @param samples Mono samples of the track
+     * @param numSamples Number of samples
+     * @param sampleRate Rate of the samples
+     * @param workers Pool to share the frames with, or nullptr to analyse them all on the calling thread;
+     *                its jobs must never wait on this call, or it could wait on itself
+     * @param shouldExit Polled now and then; returning true abandons the analysis
+     * @return The key, or an invalid key if the track is too short, has no pitched content or was abandoned
+     */
+    static MusicalKey analyse(const float* samples, int numSamples, double sampleRate,
+                              ThreadPool* workers = nullptr, const std::function<bool()>& shouldExit = {});
+};
@@ -0,0 +1,405 @@
+/*
+  ==============================================================================
+
+    LibraryComponent.cpp
+    Created: 17 Oct 2026 7:48:26am
+
+  ==============================================================================
+*/
+
+#include "LibraryComponent.h"
+
+namespace {
+
+constexpr int headingHeight = 18;
+constexpr int rowHeight = 22;
+
+String formatLength(double seconds) {
+    auto totalSeconds = roundToInt(seconds);
+    return String(totalSeconds / 60) + ":" + String(totalSeconds % 60).paddedLeft('0', 2);
+}
+
+} // namespace
+
+//==============================================================================
+LibraryComponent::LibraryComponent(AudioFormatManager& formatManager)
+    : formatManager(formatManager),
+      index(library->getIndex()) {
+    addAndMakeVisible(searchBox);
+    addAndMakeVisible(addButton);
+    addAndMakeVisible(folderButton);
+    addAndMakeVisible(rescanButton);
+    addAndMakeVisible(analyseButton);
+    addAndMakeVisible(statusLabel);
+    addAndMakeVisible(trackList);
+
+    searchBox.setTextToShowWhenEmpty("Search title, artist, album or file name", Colours::grey);
+    searchBox.setColour(TextEditor::backgroundColourId, Colour(20, 20, 40));
+    searchBox.setColour(TextEditor::textColourId, Colours::white);
+    searchBox.setColour(TextEditor::outlineColourId, Colours::white.withAlpha(0.3f));
+    searchBox.onTextChange = [this] { updateResults(); };
+    searchBox.onEscapeKey = [this] { searchBox.clear(); updateResults(); };
+
+    addButton.addListener(this);
+    addButton.setColour(TextButton::buttonColourId, Colour(0, 90, 160));
+    addButton.setColour(TextButton::textColourOffId, Colours::white);
+    addButton.setTooltip("Add audio files to the library");
+
+    for (auto* button : { &folderButton, &rescanButton, &analyseButton }) {
+        button->addListener(this);
+        button->setColour(TextButton::buttonColourId, Colour(0, 90, 160));
+        button->setColour(TextButton::textColourOffId, Colours::white);
+    }
+    folderButton.setTooltip("Add a folder to the library and scan it");
+    rescanButton.setTooltip("Look for new, changed and removed files in the library's folders");
+    analyseButton.setTooltip("Find the tempo, key and loudness of the listed tracks that haven't been analysed");
+
+    statusLabel.setColour(Label::textColourId, Colours::lightgrey);
+    statusLabel.setJustificationType(Justification::centredRight);
+
+    trackList.setRowHeight(rowHeight);
+    trackList.setMultipleSelectionEnabled(false);
+    trackList.setColour(ListBox::backgroundColourId, Colour(20, 20, 40));
+    trackList.setColour(ListBox::outlineColourId, Colours::white.withAlpha(0.3f));
+    trackList.setOutlineThickness(1);
+
+    library->addChangeListener(this);
+    updateResults();
+
+    // Picks up whatever changed in the folders while the app wasn't running
+    if (!library->getFolders().isEmpty())
+        rescan();
+}
+
+LibraryComponent::~LibraryComponent() {
+    stopTimer();
+    stopBatchAnalysis();
+    library->removeChangeListener(this);
+    addButton.removeListener(this);
+    folderButton.removeListener(this);
+    rescanButton.removeListener(this);
+    analyseButton.removeListener(this);
+}
+
+//==============================================================================
+void LibraryComponent::paint(Graphics& g) {
+    g.setColour(Colours::white.withAlpha(0.3f));
+    g.drawRect(getLocalBounds(), 1);
+
+    auto headings = trackList.getBounds().withHeight(headingHeight).translated(0, -headingHeight).reduced(1, 0);
+    auto columns = getColumns(headings);
+
+    g.setFont(12.0f);
+    g.setColour(Colours::lightgrey);
+    g.drawText("ARTIST", columns[0], Justification::centredLeft, true);
+    g.drawText("TITLE", columns[1], Justification::centredLeft, true);
+    g.drawText("KEY", columns[2], Justification::centredRight, true);
+    g.drawText("BPM", columns[3], Justification::centredRight, true);
+    g.drawText("TIME", columns[4], Justification::centredRight, true);
+}
+
+void LibraryComponent::resized() {
+    auto area = getLocalBounds().reduced(8);
+
+    auto topRow = area.removeFromTop(26);
+    addButton.setBounds(topRow.removeFromRight(70));
+    topRow.removeFromRight(8);
+    folderButton.setBounds(topRow.removeFromRight(70));
+    topRow.removeFromRight(8);
+    rescanButton.setBounds(topRow.removeFromRight(70));
+    topRow.removeFromRight(8);
+    analyseButton.setBounds(topRow.removeFromRight(70));
+    topRow.removeFromRight(8);
+    statusLabel.setBounds(topRow.removeFromRight(140));
+    topRow.removeFromRight(8);
+    searchBox.setBounds(topRow);
+
+    area.removeFromTop(4 + headingHeight);
+    trackList.setBounds(area);
+}
+
+//==============================================================================
+int LibraryComponent::getNumRows() {
+    return showingAll ? index->getNumTracks() : static_cast<int>(results.size());
+}
+
+void LibraryComponent::paintListBoxItem(int rowNumber, Graphics& g, int width, int height, bool rowIsSelected) {
+    auto trackIndex = getTrackForRow(rowNumber);
+    if (trackIndex < 0)
+        return;
+
+    if (rowIsSelected)
+        g.fillAll(Colour(0, 90, 160).withAlpha(0.6f));
+    else if (rowNumber % 2 != 0)
+        g.fillAll(Colours::white.withAlpha(0.03f));
+
+    // Only the strings of rows on screen are ever decoded
+    const auto& record = index->getRecord(trackIndex);
+    auto columns = getColumns({ 0, 0, width, height });
+
+    g.setFont(13.0f);
+    g.setColour(Colours::white);
+    g.drawText(index->getString(record.artist), columns[0], Justification::centredLeft, true);
+    g.drawText(index->getString(record.title), columns[1], Justification::centredLeft, true);
+
+    g.setColour(Colours::lightgrey);
+    g.drawText(MusicalKey::fromCode(static_cast<int>(record.key)).getCamelotCode(), columns[2],
+               Justification::centredRight, false);
+    if (record.bpm > 0.0f)
+        g.drawText(String(record.bpm, 1), columns[3], Justification::centredRight, false);
+    g.drawText(formatLength(record.lengthSeconds), columns[4], Justification::centredRight, false);
+}
+
+var LibraryComponent::getDragSourceDescription(const SparseSet<int>& rowsToDescribe) {
+    if (rowsToDescribe.isEmpty())
+        return {};
+
+    auto trackIndex = getTrackForRow(rowsToDescribe[0]);
+    return trackIndex >= 0 ? var(index->getString(index->getRecord(trackIndex).path)) : var();
+}
+
+String LibraryComponent::getTooltipForRow(int row) {
+    auto trackIndex = getTrackForRow(row);
+    return trackIndex >= 0 ? index->getString(index->getRecord(trackIndex).path) : String();
+}
+
+//==============================================================================
+void LibraryComponent::buttonClicked(Button* button) {
+    if (button == &analyseButton) {
+        if (runningAnalyses.empty())
+            analyseListedTracks();
+        else
+            stopBatchAnalysis();
+
+        timerCallback();
+        return;
+    }
+
+    if (button == &rescanButton) {
+        if (scanner.isScanning())
+            scanner.cancel();
+        else
+            rescan();
+
+        timerCallback();
+        return;
+    }
+
+    if (button == &folderButton) {
+        fileChooser = std::make_unique<FileChooser>("Add a folder to the library...", File());
+
+        auto flags = FileBrowserComponent::openMode | FileBrowserComponent::canSelectDirectories;
+
+        fileChooser->launchAsync(flags, [this](const FileChooser& chooser) {
+            auto folder = chooser.getResult();
+            if (folder == File())
+                return;
+
+            // Folders already in the library are only listed again, so rescanning them all is cheap
+            library->addFolder(folder);
+            rescan();
+        });
+        return;
+    }
+
+    fileChooser = std::make_unique<FileChooser>("Add audio files to the library...", File(),
+                                                formatManager.getWildcardForAllFormats());
+
+    auto flags = FileBrowserComponent::openMode | FileBrowserComponent::canSelectFiles
+               | FileBrowserComponent::canSelectMultipleItems;
+
+    fileChooser->launchAsync(flags, [this](const FileChooser& chooser) {
+        addFiles(chooser.getResults());
+    });
+}
+
+bool LibraryComponent::isInterestedInFileDrag(const StringArray& files) {
+    for (const auto& file : files) {
+        if (formatManager.findFormatForFileExtension(File(file).getFileExtension()) != nullptr)
+            return true;
+    }
+    return false;
+}
+
+void LibraryComponent::filesDropped(const StringArray& files, int x, int y) {
+    ignoreUnused(x, y);
+
+    Array<File> dropped;
+    for (const auto& file : files)
+        dropped.add(File(file));
+
+    addFiles(dropped);
+}
+
+//==============================================================================
+void LibraryComponent::changeListenerCallback(ChangeBroadcaster* source) {
+    ignoreUnused(source);
+    updateResults();
+}
+
+void LibraryComponent::timerCallback() {
+    updateBatchAnalysis();
+    updateStatus();
+
+    if (!scanner.isScanning())
+        rescanButton.setButtonText("RESCAN");
+
+    if (runningAnalyses.empty())
+        analyseButton.setButtonText("ANALYSE");
+
+    if (!scanner.isScanning() && runningAnalyses.empty())
+        stopTimer();
+}
+
+void LibraryComponent::rescan() {
+    scanner.scan(library->getFolders());
+
+    if (scanner.isScanning()) {
+        rescanButton.setButtonText("STOP");
+        startTimerHz(10);
+    }
+
+    updateStatus();
+}
+
+void LibraryComponent::analyseListedTracks() {
+    stopBatchAnalysis();
+
+    for (int row = 0; row < getNumRows(); ++row) {
+        const auto& record = index->getRecord(getTrackForRow(row));
+        if (!record.isAnalysed())
+            analysisQueue.add(File(index->getString(record.path)));
+    }
+
+    batchAnalysed = 0;
+    batchSize = analysisQueue.size();
+    updateBatchAnalysis();
+
+    if (!runningAnalyses.empty()) {
+        analyseButton.setButtonText("STOP");
+        startTimerHz(10);
+    }
+}
+
+void LibraryComponent::updateBatchAnalysis() {
+    std::vector<TrackLibrary::AnalysisUpdate> finished;
+
+    for (auto it = runningAnalyses.begin(); it != runningAnalyses.end();) {
+        if (!it->second->isFinished()) {
+            ++it;
+            continue;
+        }
+
+        if (auto analysis = it->second->getResult())
+            finished.emplace_back(it->first, std::move(analysis));
+
+        ++batchAnalysed;
+        it = runningAnalyses.erase(it);
+    }
+
+    library->updateAnalysis(finished);
+
+    while (static_cast<int>(runningAnalyses.size()) < maxBatchAnalyses && !analysisQueue.isEmpty()) {
+        auto file = analysisQueue.removeAndReturn(0);
+        runningAnalyses.emplace_back(file, TrackAnalyser::analyseFile(*analysisPool, formatManager, file));
+    }
+
+    // Written once the batch is done rather than after every track
+    if (runningAnalyses.empty())
+        library->save();
+}
+
+void LibraryComponent::stopBatchAnalysis() {
+    analysisQueue.clear();
+
+    for (auto& running : runningAnalyses)
+        running.second->cancel();
+
+    runningAnalyses.clear();
+    library->save();
+}
+
+void LibraryComponent::updateStatus() {
+    if (scanner.isScanning()) {
+        statusLabel.setText("Scanning " + String(scanner.getProgress().filesFound) + " files", dontSendNotification);
+        return;
+    }
+
+    if (!runningAnalyses.empty()) {
+        statusLabel.setText("Analysed " + String(batchAnalysed) + " of " + String(batchSize), dontSendNotification);
+        return;
+    }
+
+    auto numTracks = index->getNumTracks();
+    statusLabel.setText(showingAll ? String(numTracks) + " tracks"
+                                   : String(results.size()) + " of " + String(numTracks),
+                        dontSendNotification);
+}
+
+void LibraryComponent::updateResults() {
+    // Rows move as the library changes, so the selection is followed by the track's path
+    auto selectedTrack = getTrackForRow(trackList.getSelectedRow());
+    auto selectedPath = selectedTrack >= 0 ? index->getString(index->getRecord(selectedTrack).path) : String();
+
+    index = library->getIndex();
+
+    auto query = searchBox.getText().trim();
+    showingAll = query.isEmpty();
+    results.clear();
+
+    if (!showingAll)
+        results = index->search(query);
+
+    trackList.updateContent();
+
+    auto selectedRow = selectedPath.isNotEmpty() ? getRowForTrack(index->find(selectedPath)) : -1;
+    if (selectedRow >= 0)
+        trackList.selectRow(selectedRow, true);
+    else
+        trackList.deselectAllRows();
+
+    trackList.repaint();
+
+    updateStatus();
+}
+
+void LibraryComponent::addFiles(const Array<File>& files) {
+    std::vector<LibraryTrack> tracks;
+
+    for (const auto& file : files) {
+        LibraryTrack track;
+        if (file.existsAsFile() && TrackLibrary::readTrackInfo(file, formatManager, track))
+            tracks.push_back(std::move(track));
+        else
+            DBG("LibraryComponent: could not read " + file.getFullPathName());
+    }
+
+    library->addOrUpdate(tracks);
+    library->save();
+}
+
+int LibraryComponent::getTrackForRow(int row) const {
+    if (showingAll)
+        return isPositiveAndBelow(row, index->getNumTracks()) ? row : -1;
+
+    return isPositiveAndBelow(row, static_cast<int>(results.size())) ? results[static_cast<size_t>(row)] : -1;
+}
+
+int LibraryComponent::getRowForTrack(int trackIndex) const {
+    if (trackIndex < 0 || showingAll)
+        return trackIndex;
+
+    auto found = std::find(results.begin(), results.end(), trackIndex);
+    return found != results.end() ? static_cast<int>(found - results.begin()) : -1;
+}
+
+std::array<Rectangle<int>, 5> LibraryComponent::getColumns(Rectangle<int> row) {
+    row = row.reduced(6, 0);
+
+    auto length = row.removeFromRight(50);
+    auto bpm = row.removeFromRight(60);
+    auto key = row.removeFromRight(40);
+    auto artist = row.removeFromLeft(row.getWidth() * 2 / 5);
+
+    return { artist.withTrimmedRight(8), row, key, bpm, length };
+}
@@ -0,0 +1,160 @@
+/*
+  ==============================================================================
+
+    LibraryComponent.h
+    Created: 17 Oct 2026 7:48:26am
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include "TrackLibrary.h"
+#include "LibraryScanner.h"
+
+/**
+ * @class LibraryComponent
+ * @brief Searchable browser over the track library
+ *
+ * The list is a virtualised ListBox over the current LibraryIndex snapshot: it only
+ * reads the records of the rows on screen, so opening and scrolling a library of tens
+ * of thousands of tracks costs the same as a small one. Typing in the search box runs
+ * a search on the snapshot straight away and shows its results in place.
+ *
+ * Rows are dragged onto a deck to load them. Audio files dropped on the browser, or
+ * picked with the ADD button, are added to the library.
+ *
+ * Folders picked with the FOLDER button are scanned into the library and remembered.
+ * They are rescanned on startup and with RESCAN, which only reads files that have
+ * changed; the status shows the scan's progress.
+ *
+ * ANALYSE finds the tempo and key of every listed track that hasn't been analysed,
+ * a few tracks at a time on the analysis pool, storing each result as it finishes.
+ */
+class LibraryComponent : public Component,
+                         public ListBoxModel,
+                         public Button::Listener,
+                         public FileDragAndDropTarget,
+                         private ChangeListener,
+                         private Timer {
+public:
+    /**
+     * Constructor for LibraryComponent
+     * @param formatManager Used to read the metadata of files added to the library
+     */
+    explicit LibraryComponent(AudioFormatManager& formatManager);
+
+    /** Destructor */
+    ~LibraryComponent() override;
+
+    //==========================================================================
+    // Component overrides
+    //==========================================================================
+
+    /** Draws the background and column headings */
+    void paint(Graphics& g) override;
+
+    /** Lays out the search box, buttons and list */
+    void resized() override;
+
+    //==========================================================================
+    // ListBoxModel overrides
+    //==========================================================================
+
+    /** Gets the number of tracks shown, all of them or the search results */
+    int getNumRows() override;
+
+    /** Draws one track's row */
+    void paintListBoxItem(int rowNumber, Graphics& g, int width, int height, bool rowIsSelected) override;
+
+    /** Describes dragged rows by their file paths, which decks accept as drops */
+    var getDragSourceDescription(const SparseSet<int>& rowsToDescribe) override;
+
+    /** Shows a track's full path */
+    String getTooltipForRow(int row) override;
+
+    //==========================================================================
+    // Button::Listener override
+    //==========================================================================
+
+    /** Handles the ADD, FOLDER, RESCAN and ANALYSE buttons */
+    void buttonClicked(Button* button) override;
+
+    //==========================================================================
+    // FileDragAndDropTarget overrides
+    //==========================================================================
+
+    /** Accepts audio files */
+    bool isInterestedInFileDrag(const StringArray& files) override;
+
+    /** Adds dropped audio files to the library */
+    void filesDropped(const StringArray& files, int x, int y) override;
+
+private:
+    /** Picks up a new index from the library and searches it again */
+    void changeListenerCallback(ChangeBroadcaster* source) override;
+
+    /** Shows the progress of a scan or batch analysis, and keeps the analysis going */
+    void timerCallback() override;
+
+    /** Rescans every library folder */
+    void rescan();
+
+    /** Queues every listed track that hasn't been analysed */
+    void analyseListedTracks();
+
+    /** Stores finished analyses and starts queued ones, up to maxBatchAnalyses at once */
+    void updateBatchAnalysis();
+
+    /** Drops the queue and cancels the analyses running */
+    void stopBatchAnalysis();
+
+    /** Shows the number of tracks, or the progress of a scan or batch analysis */
+    void updateStatus();
+
+    /** Runs the current query on the current index and refreshes the list */
+    void updateResults();
+
+    /** Reads files' metadata and adds them to the library */
+    void addFiles(const Array<File>& files);
+
+    /** Gets the index of the track shown on a row, or -1 */
+    int getTrackForRow(int row) const;
+
+    /** Gets the row a track is shown on, or -1 if it isn't listed */
+    int getRowForTrack(int trackIndex) const;
+
+    /** Splits a row into its columns: artist, title, key, BPM and length */
+    static std::array<Rectangle<int>, 5> getColumns(Rectangle<int> row);
+
+    /** Tracks analysed at once; each holds a downsampled copy of its audio until it finishes */
+    static constexpr int maxBatchAnalyses = 4;
+
+    AudioFormatManager& formatManager;
+    SharedResourcePointer<TrackLibrary> library;
+    LibraryScanner scanner{ formatManager, *library };
+    SharedResourcePointer<AnalysisPool> analysisPool;
+
+    // Batch analysis: files waiting their turn, and the analyses running
+    Array<File> analysisQueue;
+    std::vector<std::pair<File, std::shared_ptr<TrackAnalyser>>> runningAnalyses;
+    int batchAnalysed = 0;
+    int batchSize = 0;
+
+    // The snapshot on screen, and the search results in it; showingAll skips listing every track
+    std::shared_ptr<const LibraryIndex> index;
+    std::vector<int> results;
+    bool showingAll = true;
+
+    TextEditor searchBox;
+    TextButton addButton{"ADD"};
+    TextButton folderButton{"FOLDER"};
+    TextButton rescanButton{"RESCAN"};
+    TextButton analyseButton{"ANALYSE"};
+    Label statusLabel;
+    ListBox trackList{"Tracks", this};
+    std::unique_ptr<FileChooser> fileChooser;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(LibraryComponent)
+};
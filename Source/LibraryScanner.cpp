@@ -0,0 +1,293 @@
+/*
+  ==============================================================================
+
+    LibraryScanner.cpp
+    Created: 17 Oct 2026 9:06:52am
+
+  ==============================================================================
+*/
+
+#include "LibraryScanner.h"
+
+namespace {
+
+/** Gets a folder's path with every link in it resolved, so a folder has one name however it is reached */
+File getCanonicalFolder(const File& folder) {
+   #if JUCE_WINDOWS
+    return folder.getLinkedTarget();
+   #else
+    std::unique_ptr<char, decltype(&std::free)> resolved(realpath(folder.getFullPathName().toRawUTF8(), nullptr), &std::free);
+    return resolved != nullptr ? File(String::fromUTF8(resolved.get())) : folder;
+   #endif
+}
+
+} // namespace
+
+//==============================================================================
+LibraryScanner::LibraryScanner(AudioFormatManager& formatManager, TrackLibrary& library)
+    : formatManager(formatManager),
+      library(library) {
+    for (auto* format : formatManager)
+        for (const auto& extension : format->getFileExtensions())
+            audioExtensions.addIfNotAlreadyThere(extension.toLowerCase());
+}
+
+LibraryScanner::~LibraryScanner() {
+    cancel();
+}
+
+void LibraryScanner::scan(const Array<File>& folders, int concurrency) {
+    cancel();
+
+    // A folder that can't be listed, such as an unmounted share, is left out rather than
+    // treated as empty, which would remove every track in it
+    scanFolders.clear();
+    for (const auto& folder : folders) {
+        if (!folder.isDirectory()) {
+            DBG("LibraryScanner: skipping " + folder.getFullPathName() + ", it can't be listed");
+            continue;
+        }
+
+        auto covered = false;
+        for (const auto& other : folders)
+            covered = covered || (folder.isAChildOf(other) && other.isDirectory());
+
+        if (!covered)
+            scanFolders.addIfNotAlreadyThere(folder);
+    }
+
+    if (scanFolders.isEmpty())
+        return;
+
+    if (concurrency <= 0) {
+        for (const auto& folder : scanFolders)
+            concurrency = jmax(concurrency, getConcurrency(detectStorage(folder)));
+    }
+
+    coveredFolders.clear();
+    unlistedFolders.clear();
+    for (const auto& folder : scanFolders)
+        coveredFolders.add(getCanonicalFolder(folder));
+
+    previous = library.getIndex();
+    seen.reset(new std::atomic<bool>[static_cast<size_t>(previous->getNumTracks())]());
+    readTracks.clear();
+    lastFlushTime = Time::getMillisecondCounter();
+
+    for (auto* count : { &foldersScanned, &filesFound, &filesUnchanged, &filesRead, &filesFailed, &filesRemoved })
+        count->store(0);
+
+    jobsOutstanding = 0;
+    cancelled = false;
+    scanning = true;
+
+    pool = std::make_unique<ThreadPool>(ThreadPoolOptions{}.withThreadName("Library scan")
+                                                           .withNumberOfThreads(concurrency)
+                                                           .withDesiredThreadPriority(Thread::Priority::low));
+
+    // The roots are queued from a job of their own, so the count can't reach zero before they all are
+    addJob([this] {
+        for (const auto& folder : scanFolders)
+            addJob([this, folder] { scanFolder(folder); });
+    });
+}
+
+void LibraryScanner::cancel() {
+    if (pool == nullptr)
+        return;
+
+    cancelled = true;
+    pool->removeAllJobs(true, 10000);
+    pool.reset();
+
+    if (scanning.exchange(false)) {
+        flushTracks(true);
+        library.save();
+    }
+}
+
+bool LibraryScanner::isScanning() const noexcept {
+    return scanning.load();
+}
+
+LibraryScanner::Progress LibraryScanner::getProgress() const noexcept {
+    Progress progress;
+    progress.foldersScanned = foldersScanned.load();
+    progress.filesFound = filesFound.load();
+    progress.filesUnchanged = filesUnchanged.load();
+    progress.filesRead = filesRead.load();
+    progress.filesFailed = filesFailed.load();
+    progress.filesRemoved = filesRemoved.load();
+    progress.scanning = scanning.load();
+    return progress;
+}
+
+LibraryScanner::Storage LibraryScanner::detectStorage(const File& folder) {
+    return folder.isOnHardDisk() ? Storage::localDisk : Storage::networkMount;
+}
+
+int LibraryScanner::getConcurrency(Storage storage) {
+    return storage == Storage::networkMount ? networkConcurrency : jmax(1, SystemStats::getNumCpus());
+}
+
+//==============================================================================
+void LibraryScanner::scanFolder(const File& folder) {
+    // The listing can't tell an unreadable folder from an empty one, so it is checked first
+    if (!folder.isDirectory() || !folder.hasReadAccess()) {
+        DBG("LibraryScanner: can't list " + folder.getFullPathName() + ", keeping its tracks");
+
+        const ScopedLock sl(foldersLock);
+        unlistedFolders.add(folder);
+        return;
+    }
+
+    std::vector<File> toRead;
+
+    auto queueRead = [this, &toRead] {
+        addJob([this, files = toRead] { readFiles(files); });
+        toRead.clear();
+    };
+
+    for (const auto& entry : RangedDirectoryIterator(folder, false, "*", File::findFilesAndDirectories)) {
+        if (cancelled)
+            return;
+
+        auto file = entry.getFile();
+
+        if (entry.isDirectory()) {
+            if (!file.isSymbolicLink() || claimLinkedFolder(file))
+                addJob([this, file] { scanFolder(file); });
+            continue;
+        }
+
+        if (!isAudioFile(file))
+            continue;
+
+        ++filesFound;
+
+        // The listing carries the size and time, so an unchanged file is never opened
+        auto trackIndex = previous->find(file.getFullPathName());
+        if (trackIndex >= 0) {
+            const auto& record = previous->getRecord(trackIndex);
+
+            if (record.fileSize == entry.getFileSize()
+                && record.modificationTime == entry.getModificationTime().toMilliseconds()) {
+                seen[static_cast<size_t>(trackIndex)] = true;
+                ++filesUnchanged;
+                continue;
+            }
+        }
+
+        toRead.push_back(file);
+        if (static_cast<int>(toRead.size()) == filesPerJob)
+            queueRead();
+    }
+
+    if (!toRead.empty())
+        queueRead();
+
+    ++foldersScanned;
+}
+
+bool LibraryScanner::claimLinkedFolder(const File& link) {
+    // A link into a folder already covered would list it twice, or loop back up the tree forever
+    auto target = getCanonicalFolder(link);
+
+    const ScopedLock sl(foldersLock);
+
+    for (const auto& covered : coveredFolders)
+        if (target == covered || target.isAChildOf(covered))
+            return false;
+
+    coveredFolders.add(target);
+    return true;
+}
+
+void LibraryScanner::readFiles(const std::vector<File>& files) {
+    for (const auto& file : files) {
+        if (cancelled)
+            return;
+
+        LibraryTrack track;
+        if (!TrackLibrary::readTrackInfo(file, formatManager, track)) {
+            // Left unseen, so a track that could be read before is removed
+            ++filesFailed;
+            continue;
+        }
+
+        auto trackIndex = previous->find(track.path);
+        if (trackIndex >= 0)
+            seen[static_cast<size_t>(trackIndex)] = true;
+
+        ++filesRead;
+
+        const ScopedLock sl(tracksLock);
+        readTracks.push_back(std::move(track));
+    }
+
+    flushTracks(false);
+}
+
+void LibraryScanner::addJob(std::function<void()> job) {
+    ++jobsOutstanding;
+
+    pool->addJob([this, job = std::move(job)] {
+        if (!cancelled)
+            job();
+
+        if (--jobsOutstanding == 0)
+            finishScan();
+    });
+}
+
+void LibraryScanner::flushTracks(bool force) {
+    std::vector<LibraryTrack> batch;
+    {
+        const ScopedLock sl(tracksLock);
+        auto now = Time::getMillisecondCounter();
+
+        if (readTracks.empty() || (!force && now - lastFlushTime < flushIntervalMs))
+            return;
+
+        lastFlushTime = now;
+        batch.swap(readTracks);
+    }
+
+    // Outside the lock, the other jobs carry on reading while the index is rebuilt
+    library.addOrUpdate(batch);
+}
+
+void LibraryScanner::finishScan() {
+    flushTracks(true);
+
+    if (!cancelled) {
+        StringArray missing;
+
+        auto isIn = [](const File& file, const Array<File>& folders) {
+            for (const auto& folder : folders)
+                if (file.isAChildOf(folder))
+                    return true;
+            return false;
+        };
+
+        // Tracks in folders that couldn't be listed weren't looked for, so they aren't missing
+        for (int i = 0; i < previous->getNumTracks(); ++i) {
+            if (seen[static_cast<size_t>(i)])
+                continue;
+
+            File file(previous->getString(previous->getRecord(i).path));
+            if (isIn(file, scanFolders) && !isIn(file, unlistedFolders))
+                missing.add(file.getFullPathName());
+        }
+
+        filesRemoved = missing.size();
+        library.remove(missing);
+    }
+
+    library.save();
+    scanning = false;
+}
+
+bool LibraryScanner::isAudioFile(const File& file) const {
+    return audioExtensions.contains(file.getFileExtension().toLowerCase());
+}
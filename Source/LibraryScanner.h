@@ -0,0 +1,148 @@
+/*
+  ==============================================================================
+
+    LibraryScanner.h
+    Created: 17 Oct 2026 9:06:52am
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include "TrackLibrary.h"
+
+/**
+ * @class LibraryScanner
+ * @brief Fills the track library from folders, reading many files at once
+ *
+ * Each folder is listed by its own job, which queues jobs for its subfolders and for
+ * batches of the audio files in it, so a scan spreads over every pool thread however
+ * the collection is laid out. Files are read with AudioFormatManager readers, which
+ * only parse headers and tags. Linked folders are followed, unless they lead into a
+ * folder the scan already covers.
+ *
+ * Rescans are incremental: a file whose size and modification time, taken from the
+ * folder listing, match its library record is not opened again, and tracks under the
+ * scanned folders whose files have gone are removed, except in folders that couldn't
+ * be listed. Rescanning a collection that hasn't changed is then just listing its
+ * folders.
+ *
+ * How many files are read at once depends on the storage: a local disk gets a reader
+ * per core, as parsing is as costly as reading there, while a network mount gets
+ * more, so requests overlap each other's round trips.
+ *
+ * Tracks reach the library in batches as the scan goes, and it is saved at the end.
+ */
+class LibraryScanner {
+public:
+    /** What scanned folders are stored on */
+    enum class Storage {
+        localDisk,      /**< SSDs and other local drives */
+        networkMount    /**< Network shares, where each request waits on a round trip */
+    };
+
+    /** How far a scan has got; the counts are of audio files */
+    struct Progress {
+        int foldersScanned = 0;
+        int filesFound = 0;
+        int filesUnchanged = 0;
+        int filesRead = 0;
+        int filesFailed = 0;
+        int filesRemoved = 0;
+        bool scanning = false;
+    };
+
+    /**
+     * Constructor for LibraryScanner
+     * @param formatManager Decides which files are audio files, and reads them
+     * @param library The library to fill; both must outlive the scanner
+     */
+    LibraryScanner(AudioFormatManager& formatManager, TrackLibrary& library);
+
+    /** Destructor, stops any scan in progress */
+    ~LibraryScanner();
+
+    /**
+     * Starts scanning folders in the background, stopping any scan already running
+     * @param folders Folders to scan, with everything below them
+     * @param concurrency Files read at once, or 0 to choose from the storage the folders are on
+     */
+    void scan(const Array<File>& folders, int concurrency = 0);
+
+    /** Stops the scan, keeping what it has added so far */
+    void cancel();
+
+    /** Checks whether a scan is running */
+    bool isScanning() const noexcept;
+
+    /** Gets the progress of the current or last scan, e.g. to show it */
+    Progress getProgress() const noexcept;
+
+    /** Guesses what a folder is stored on; drives that aren't local disks are treated as network mounts */
+    static Storage detectStorage(const File& folder);
+
+    /** Gets the number of files to read at once from a kind of storage */
+    static int getConcurrency(Storage storage);
+
+private:
+    /** Lists a folder, queueing its subfolders and the files that need reading */
+    void scanFolder(const File& folder);
+
+    /** Checks whether a linked folder leads somewhere not yet covered, and covers it if so */
+    bool claimLinkedFolder(const File& link);
+
+    /** Reads a batch of files' metadata */
+    void readFiles(const std::vector<File>& files);
+
+    /** Queues a job, counting it until it has run */
+    void addJob(std::function<void()> job);
+
+    /** Passes the tracks read so far to the library, if it is time to or force is set */
+    void flushTracks(bool force);
+
+    /** Removes tracks whose files have gone and saves the library, once every job has run */
+    void finishScan();
+
+    /** Checks whether a file is one the format manager can read */
+    bool isAudioFile(const File& file) const;
+
+    AudioFormatManager& formatManager;
+    TrackLibrary& library;
+    StringArray audioExtensions;
+
+    std::unique_ptr<ThreadPool> pool;
+    std::atomic<bool> cancelled{ false };
+    std::atomic<int> jobsOutstanding{ 0 };
+
+    // The library as it was when the scan started, and which of its tracks have been seen on disk
+    Array<File> scanFolders;
+    std::shared_ptr<const LibraryIndex> previous;
+    std::unique_ptr<std::atomic<bool>[]> seen;
+
+    // Canonical paths of the folders being scanned and of the linked ones followed outside them,
+    // and the folders that couldn't be listed
+    CriticalSection foldersLock;
+    Array<File> coveredFolders;
+    Array<File> unlistedFolders;
+
+    // Tracks read but not yet in the library
+    CriticalSection tracksLock;
+    std::vector<LibraryTrack> readTracks;
+    uint32 lastFlushTime = 0;
+
+    std::atomic<int> foldersScanned{ 0 }, filesFound{ 0 }, filesUnchanged{ 0 },
+                     filesRead{ 0 }, filesFailed{ 0 }, filesRemoved{ 0 };
+    std::atomic<bool> scanning{ false };
+
+    /** Files read by one job; small enough that a large folder spreads over the pool */
+    static constexpr int filesPerJob = 16;
+
+    /** How often read tracks are passed to the library, each time rebuilding its index */
+    static constexpr uint32 flushIntervalMs = 1000;
+
+    /** Readers for a network mount, which spend most of their time waiting */
+    static constexpr int networkConcurrency = 16;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(LibraryScanner)
+};
@@ -0,0 +1,183 @@
+/*
+  ==============================================================================
+
+    LoudnessMeter.cpp
+    Created: 17 Oct 2026 11:05:19am
+
+  ==============================================================================
+*/
+
+#include "LoudnessMeter.h"
+
+namespace {
+
+/** Length of the steps the power is summed over, and the number of steps in a gating block */
+constexpr double stepSeconds = 0.1;
+constexpr size_t stepsPerBlock = 4;
+
+/** Blocks quieter than this are left out altogether, and those this far under the mean of the rest too */
+constexpr double absoluteGateLufs = -70.0;
+constexpr double relativeGateLu = -10.0;
+
+/** What a silent or unmeasured true peak reads as, in dBTP */
+constexpr float truePeakFloorDb = -100.0f;
+
+/** Converts a mean power to loudness, as BS.1770 defines it */
+double powerToLufs(double power) {
+    return -0.691 + 10.0 * std::log10(jmax(power, 1.0e-20));
+}
+
+} // namespace
+
+//==============================================================================
+LoudnessMeter::LoudnessMeter() {
+    // Hann-windowed sinc interpolating four times; every phase has a gain of one at DC
+    constexpr int numTaps = tapsPerPhase * oversampling;
+    constexpr double centre = (numTaps - 1) / 2.0;
+
+    for (int n = 0; n < numTaps; ++n) {
+        auto t = (n - centre) / oversampling;
+        auto sinc = t == 0.0 ? 1.0 : std::sin(MathConstants<double>::pi * t) / (MathConstants<double>::pi * t);
+        auto window = 0.5 - 0.5 * std::cos(MathConstants<double>::twoPi * (n + 0.5) / numTaps);
+        truePeakFilter[n / oversampling][n % oversampling] = static_cast<float>(sinc * window);
+    }
+}
+
+void LoudnessMeter::reset(int numChannels, double sampleRate) {
+    // The K-weighting shelf and high-pass of BS.1770, with the analogue prototypes
+    // mapped to this sample rate rather than the 48 kHz coefficients in the standard
+    Biquad shelf;
+    {
+        constexpr double frequency = 1681.974450955533, gainDb = 3.999843853973347, q = 0.7071752369554196;
+        auto k = std::tan(MathConstants<double>::pi * frequency / sampleRate);
+        auto vh = std::pow(10.0, gainDb / 20.0);
+        auto vb = std::pow(vh, 0.4996667741545416);
+        auto a0 = 1.0 + k / q + k * k;
+
+        shelf.b0 = (vh + vb * k / q + k * k) / a0;
+        shelf.b1 = 2.0 * (k * k - vh) / a0;
+        shelf.b2 = (vh - vb * k / q + k * k) / a0;
+        shelf.a1 = 2.0 * (k * k - 1.0) / a0;
+        shelf.a2 = (1.0 - k / q + k * k) / a0;
+    }
+
+    Biquad highPass;
+    {
+        constexpr double frequency = 38.13547087602444, q = 0.5003270373238773;
+        auto k = std::tan(MathConstants<double>::pi * frequency / sampleRate);
+        auto a0 = 1.0 + k / q + k * k;
+
+        highPass.b0 = 1.0;
+        highPass.b1 = -2.0;
+        highPass.b2 = 1.0;
+        highPass.a1 = 2.0 * (k * k - 1.0) / a0;
+        highPass.a2 = (1.0 - k / q + k * k) / a0;
+    }
+
+    channels.assign(static_cast<size_t>(jmax(0, numChannels)), Channel());
+
+    for (size_t i = 0; i < channels.size(); ++i) {
+        auto& channel = channels[i];
+        channel.shelf = shelf;
+        channel.highPass = highPass;
+        channel.history.assign(tapsPerPhase - 1, 0.0f);
+
+        // In 5.1 the LFE channel doesn't count and the surrounds count more
+        if (channels.size() == 6)
+            channel.weight = i == 3 ? 0.0 : (i >= 4 ? 1.41 : 1.0);
+    }
+
+    stepPowers.clear();
+    pendingPower = 0.0;
+    pendingSamples = 0;
+    stepLength = jmax(1, roundToInt(sampleRate * stepSeconds));
+    truePeak = 0.0f;
+}
+
+void LoudnessMeter::process(const AudioBuffer<float>& block, int numSamples) {
+    auto numChannels = jmin(static_cast<int>(channels.size()), block.getNumChannels());
+    blockPower.assign(static_cast<size_t>(numSamples), 0.0);
+
+    for (int chan = 0; chan < numChannels; ++chan) {
+        auto& channel = channels[static_cast<size_t>(chan)];
+        const auto* samples = block.getReadPointer(chan);
+
+        for (int i = 0; i < numSamples; ++i) {
+            auto weighted = channel.highPass.process(channel.shelf.process(samples[i]));
+            blockPower[static_cast<size_t>(i)] += channel.weight * weighted * weighted;
+        }
+
+        truePeak = jmax(truePeak, findTruePeak(channel, samples, numSamples));
+    }
+
+    for (auto power : blockPower) {
+        pendingPower += power;
+
+        if (++pendingSamples == stepLength) {
+            stepPowers.push_back(pendingPower / stepLength);
+            pendingPower = 0.0;
+            pendingSamples = 0;
+        }
+    }
+}
+
+Loudness LoudnessMeter::getLoudness() const {
+    Loudness loudness;
+    loudness.truePeakDb = Decibels::gainToDecibels(truePeak, truePeakFloorDb);
+
+    // 400 ms blocks, starting every 100 ms step
+    std::vector<double> blockPowers;
+    for (size_t step = stepsPerBlock - 1; step < stepPowers.size(); ++step) {
+        auto sum = 0.0;
+        for (size_t i = 0; i < stepsPerBlock; ++i)
+            sum += stepPowers[step - i];
+        blockPowers.push_back(sum / stepsPerBlock);
+    }
+
+    auto gatedMean = [&blockPowers](double gateLufs) {
+        auto sum = 0.0;
+        auto count = 0;
+        for (auto power : blockPowers) {
+            if (powerToLufs(power) > gateLufs) {
+                sum += power;
+                ++count;
+            }
+        }
+        return std::make_pair(count > 0 ? sum / count : 0.0, count);
+    };
+
+    auto [ungatedPower, numLoudBlocks] = gatedMean(absoluteGateLufs);
+    if (numLoudBlocks == 0)
+        return loudness;
+
+    auto relativeGate = jmax(absoluteGateLufs, powerToLufs(ungatedPower) + relativeGateLu);
+    loudness.integratedLufs = powerToLufs(gatedMean(relativeGate).first);
+    loudness.measured = true;
+    return loudness;
+}
+
+float LoudnessMeter::findTruePeak(Channel& channel, const float* samples, int numSamples) {
+    // The channel's last samples go in front, so the filter runs on across blocks
+    constexpr int historyLength = tapsPerPhase - 1;
+    extended.resize(static_cast<size_t>(historyLength + numSamples));
+    upsampled.resize(static_cast<size_t>(numSamples));
+
+    std::copy(channel.history.begin(), channel.history.end(), extended.begin());
+    FloatVectorOperations::copy(extended.data() + historyLength, samples, numSamples);
+
+    // Each phase is a whole-block multiply-add per tap, which vectorises where a per-sample loop wouldn't
+    auto peak = 0.0f;
+    for (int phase = 0; phase < oversampling; ++phase) {
+        FloatVectorOperations::clear(upsampled.data(), numSamples);
+
+        for (int tap = 0; tap < tapsPerPhase; ++tap)
+            FloatVectorOperations::addWithMultiply(upsampled.data(), extended.data() + historyLength - tap,
+                                                   truePeakFilter[tap][phase], numSamples);
+
+        auto range = FloatVectorOperations::findMinAndMax(upsampled.data(), numSamples);
+        peak = jmax(peak, -range.getStart(), range.getEnd());
+    }
+
+    std::copy(extended.end() - historyLength, extended.end(), channel.history.begin());
+    return peak;
+}
@@ -0,0 +1,108 @@
+/*
+  ==============================================================================
+
+    LoudnessMeter.h
+    Created: 17 Oct 2026 11:05:19am
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "../JuceLibraryCode/JuceHeader.h"
+
+/**
+ * @struct Loudness
+ * @brief How loud a whole track is, by EBU R128
+ */
+struct Loudness {
+    double integratedLufs = 0.0;    /**< Gated loudness of the whole track, in LUFS */
+    double truePeakDb = 0.0;        /**< Highest peak between samples, in dBTP */
+    bool measured = false;          /**< False until the whole track has been measured, or if it is silent */
+
+    /** Returns true if the track has been measured */
+    bool isValid() const noexcept { return measured; }
+
+    /**
+     * Gets the gain that brings the track to a target loudness
+     * The gain is held down so the track's true peak stays under a ceiling, as nothing
+     * after it limits the signal.
+     * @return Gain in dB, or 0 if the track hasn't been measured
+     */
+    double getNormalisationGainDb(double targetLufs, double maxTruePeakDb) const noexcept {
+        return measured ? jmin(targetLufs - integratedLufs, maxTruePeakDb - truePeakDb) : 0.0;
+    }
+};
+
+/**
+ * @class LoudnessMeter
+ * @brief Measures a track's integrated loudness and true peak as it is decoded
+ *
+ * Follows ITU-R BS.1770-4: each channel is K-weighted, the power is summed over
+ * channels in 100 ms steps, and the integrated loudness is the gated mean of the
+ * overlapping 400 ms blocks. Only the power of each step is kept, so a whole track
+ * needs a few kilobytes.
+ *
+ * The true peak is the highest sample of the signal upsampled four times by a
+ * polyphase FIR, applied a block at a time with FloatVectorOperations.
+ *
+ * Blocks must be passed in order; the meter is meant for a decode pass, not real time.
+ */
+class LoudnessMeter {
+public:
+    LoudnessMeter();
+
+    /** Starts measuring a new track */
+    void reset(int numChannels, double sampleRate);
+
+    /** Measures the next block of the track */
+    void process(const AudioBuffer<float>& block, int numSamples);
+
+    /** Gets the loudness of everything processed since reset() */
+    Loudness getLoudness() const;
+
+private:
+    /** One second-order section, in double precision so the 38 Hz high-pass stays stable */
+    struct Biquad {
+        double b0 = 1.0, b1 = 0.0, b2 = 0.0, a1 = 0.0, a2 = 0.0;
+        double z1 = 0.0, z2 = 0.0;
+
+        double process(double x) noexcept {
+            auto y = b0 * x + z1;
+            z1 = b1 * x - a1 * y + z2;
+            z2 = b2 * x - a2 * y;
+            return y;
+        }
+    };
+
+    /** Oversampling for the true peak, and taps of each phase of its filter */
+    static constexpr int oversampling = 4;
+    static constexpr int tapsPerPhase = 12;
+
+    /** Per-channel filter state */
+    struct Channel {
+        Biquad shelf;
+        Biquad highPass;
+        double weight = 1.0;
+        std::vector<float> history;     // The last tapsPerPhase - 1 samples, for the true-peak filter
+    };
+
+    /** Finds the highest upsampled peak of one channel's block */
+    float findTruePeak(Channel& channel, const float* samples, int numSamples);
+
+    std::vector<Channel> channels;
+    float truePeakFilter[tapsPerPhase][oversampling];
+
+    // Power of each 100 ms step, and of the step being summed
+    std::vector<double> stepPowers;
+    double pendingPower = 0.0;
+    int pendingSamples = 0;
+    int stepLength = 0;
+
+    float truePeak = 0.0f;
+    std::vector<double> blockPower;
+    std::vector<float> extended;
+    std::vector<float> upsampled;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(LoudnessMeter)
+};
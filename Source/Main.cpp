@@ -26,7 +26,13 @@ public:
     {
         // This method is where you should put your application's initialisation code..
 
-        mainWindow.reset (new MainWindow (getApplicationName()));
+        // e.g. --decks=4 for a four deck set
+        auto numDecks = MainComponent::defaultNumDecks;
+        for (auto& argument : getCommandLineParameterArray())
+            if (argument.startsWith ("--decks="))
+                numDecks = argument.fromFirstOccurrenceOf ("=", false, false).getIntValue();
+
+        mainWindow.reset (new MainWindow (getApplicationName(), numDecks));
     }
 
     void shutdown() override
@@ -59,13 +65,13 @@ public:
     class MainWindow    : public DocumentWindow
     {
     public:
-        MainWindow (String name)  : DocumentWindow (name,
+        MainWindow (String name, int numDecks)  : DocumentWindow (name,
                                                     Desktop::getInstance().getDefaultLookAndFeel()
                                                                           .findColour (ResizableWindow::backgroundColourId),
                                                     DocumentWindow::allButtons)
         {
             setUsingNativeTitleBar (true);
-            setContentOwned (new MainComponent(), true);
+            setContentOwned (new MainComponent (numDecks), true);
 
            #if JUCE_IOS || JUCE_ANDROID
             setFullScreen (true);
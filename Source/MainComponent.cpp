@@ -11,8 +11,19 @@
 #include "MainComponent.h"
 
 //==============================================================================
-MainComponent::MainComponent() {
-    setSize(1000, 600);
+MainComponent::MainComponent(int numDecks) {
+    numDecks = jlimit(1, DeckMixerEngine::maxDecks, numDecks);
+
+    for (int i = 0; i < numDecks; ++i) {
+        auto* player = players.add(new DJAudioPlayer(formatManager));
+        addAndMakeVisible(deckGUIs.add(new DeckGUI(player, waveformCache)));
+        mixer.addDeck(player);
+    }
+
+    // Two decks side by side, more in rows of up to four
+    auto columns = jmin(numDecks, 4);
+    auto rows = (numDecks + columns - 1) / columns;
+    setSize(jmax(1000, columns * 500), 600 + (rows - 1) * 480 + libraryHeight);
 
     if (RuntimePermissions::isRequired(RuntimePermissions::recordAudio)
         && !RuntimePermissions::isGranted(RuntimePermissions::recordAudio)) {
@@ -26,9 +37,6 @@ MainComponent::MainComponent() {
         setAudioChannels(0, 2);
     }  
 
-    addAndMakeVisible(deckGUI1); 
-    addAndMakeVisible(deckGUI2);
-    
     addAndMakeVisible(titleLabel);
     titleLabel.setText("OtoDecks DJ Studio", dontSendNotification);
     titleLabel.setFont(Font(28.0f, Font::bold));
@@ -36,6 +44,9 @@ MainComponent::MainComponent() {
     titleLabel.setColour(Label::textColourId, Colours::white);
     titleLabel.setColour(Label::backgroundColourId, Colours::transparentBlack);
 
+    addAndMakeVisible(cpuMeter);
+    addAndMakeVisible(library);
+
     formatManager.registerBasicFormats();
 }
 
@@ -45,23 +56,38 @@ MainComponent::~MainComponent() {
 
 //==============================================================================
 void MainComponent::prepareToPlay(int samplesPerBlockExpected, double sampleRate) {
-    player1.prepareToPlay(samplesPerBlockExpected, sampleRate);
-    player2.prepareToPlay(samplesPerBlockExpected, sampleRate);
-    
-    mixerSource.prepareToPlay(samplesPerBlockExpected, sampleRate);
+    // Lets each deck time its playhead to when its audio actually leaves the speakers
+    auto outputLatency = 0;
+    if (auto* device = deviceManager.getCurrentAudioDevice())
+        outputLatency = device->getOutputLatencyInSamples();
+
+    for (auto* player : players)
+        player->setOutputLatencySamples(outputLatency);
 
-    mixerSource.addInputSource(&player1, false);
-    mixerSource.addInputSource(&player2, false);
+    // Prepares every deck and starts the render workers in the device's workgroup
+    mixer.setAudioWorkgroup(deviceManager.getDeviceAudioWorkgroup());
+    mixer.prepareToPlay(samplesPerBlockExpected, sampleRate);
+
+    currentSampleRate = sampleRate;
+    profiler->addMarker("Audio started: " + String(samplesPerBlockExpected) + " samples at " + String(sampleRate) + " Hz");
 }
 
 void MainComponent::getNextAudioBlock(const AudioSourceChannelInfo& bufferToFill) {
-    mixerSource.getNextAudioBlock(bufferToFill);
+    auto startMs = profiler->beginCallback();
+
+    mixer.getNextAudioBlock(bufferToFill);
+
+    auto numDecks = mixer.getNumDecks();
+    for (int i = 0; i < numDecks; ++i) {
+        auto timing = mixer.getDeckTiming(i);
+        profiler->setDeckTiming(i, timing.startMs, timing.durationMs);
+    }
+
+    profiler->endCallback(startMs, bufferToFill.numSamples, currentSampleRate, numDecks);
 }
 
 void MainComponent::releaseResources() {
-    player1.releaseResources();
-    player2.releaseResources();
-    mixerSource.releaseResources();
+    mixer.releaseResources();
 }
 
 //==============================================================================
@@ -91,14 +117,27 @@ void MainComponent::paint(Graphics& g) {
 void MainComponent::resized() {
     auto area = getLocalBounds().reduced(15);
     
-    titleLabel.setBounds(area.removeFromTop(40));
+    auto titleArea = area.removeFromTop(40);
+    cpuMeter.setBounds(titleArea.removeFromRight(300).reduced(0, 6));
+    titleLabel.setBounds(titleArea.withTrimmedLeft(300));
     
     area.removeFromTop(20);
-    
-    auto leftDeckArea = area.removeFromLeft(area.getWidth() / 2 - 10);
-    auto rightDeckArea = area.removeFromRight(area.getWidth() - 10);
-    
-    deckGUI1.setBounds(leftDeckArea);
-    deckGUI2.setBounds(rightDeckArea);
+
+    constexpr int gap = 20;
+    library.setBounds(area.removeFromBottom(libraryHeight - gap));
+    area.removeFromBottom(gap);
+
+    auto columns = jmin(deckGUIs.size(), 4);
+    auto rows = (deckGUIs.size() + columns - 1) / columns;
+    auto deckWidth = (area.getWidth() - gap * (columns - 1)) / columns;
+    auto deckHeight = (area.getHeight() - gap * (rows - 1)) / rows;
+
+    for (int i = 0; i < deckGUIs.size(); ++i) {
+        auto column = i % columns;
+        auto row = i / columns;
+        deckGUIs.getUnchecked(i)->setBounds(area.getX() + column * (deckWidth + gap),
+                                            area.getY() + row * (deckHeight + gap),
+                                            deckWidth, deckHeight);
+    }
 }
 
@@ -13,22 +13,35 @@
 #include "../JuceLibraryCode/JuceHeader.h"
 #include "DJAudioPlayer.h"
 #include "DeckGUI.h"
+#include "WaveformCache.h"
+#include "DeckMixerEngine.h"
+#include "AudioCallbackProfiler.h"
+#include "CpuMeterComponent.h"
+#include "LibraryComponent.h"
 
 /**
  * @class MainComponent
  * @brief Main application component for the OtoDecks DJ application
  * 
- * Provides the main application layout with two DJ decks for mixing audio.
- * Handles audio processing and routing between decks.
+ * Provides the main application layout with a row or grid of DJ decks, two by
+ * default and up to DeckMixerEngine::maxDecks, mixed in parallel by the engine,
+ * above the library browser that tracks are dragged from onto the decks.
  */
-class MainComponent : public AudioAppComponent {
+class MainComponent : public AudioAppComponent,
+                      public DragAndDropContainer {
 public:
     //==========================================================================
     // Construction and destruction
     //==========================================================================
     
-    /** Constructor */
-    MainComponent();
+    /** Default number of decks */
+    static constexpr int defaultNumDecks = 2;
+
+    /**
+     * Constructor
+     * @param numDecks Number of decks to create, clamped to 1..DeckMixerEngine::maxDecks
+     */
+    explicit MainComponent(int numDecks = defaultNumDecks);
     
     /** Destructor */
     ~MainComponent() override;
@@ -57,30 +70,34 @@ public:
     void resized() override;
 
 private:
+    /** Height of the library browser below the decks */
+    static constexpr int libraryHeight = 260;
+
     //==========================================================================
     // UI Components
     //==========================================================================
     Label titleLabel;
+    CpuMeterComponent cpuMeter{deviceManager};
     
     //==========================================================================
     // Audio format management
     //==========================================================================
     AudioFormatManager formatManager;
-    AudioThumbnailCache thumbCache{100};
+    WaveformCache waveformCache;
 
     //==========================================================================
     // Audio players and decks
     //==========================================================================
-    DJAudioPlayer player1{formatManager};
-    DeckGUI deckGUI1{&player1, formatManager, thumbCache};
-
-    DJAudioPlayer player2{formatManager};
-    DeckGUI deckGUI2{&player2, formatManager, thumbCache};
+    OwnedArray<DJAudioPlayer> players;
+    OwnedArray<DeckGUI> deckGUIs;
+    LibraryComponent library{formatManager};
 
     //==========================================================================
     // Audio mixing
     //==========================================================================
-    MixerAudioSource mixerSource;
+    DeckMixerEngine mixer;
+    SharedResourcePointer<AudioCallbackProfiler> profiler;
+    double currentSampleRate = 0.0;
     
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(MainComponent)
 };
@@ -0,0 +1,167 @@
+/*
+  ==============================================================================
+
+    PcmCache.cpp
+    Created: 16 Oct 2026 3:10:55pm
+
+  ==============================================================================
+*/
+
+#include "PcmCache.h"
+
+//==============================================================================
+PcmCache::EntryWriter::EntryWriter(PcmCache& cache, const File& entryFile, const File& tempFile,
+                                   std::unique_ptr<AudioFormatWriter> writer)
+    : cache(cache), entryFile(entryFile), tempFile(tempFile), writer(std::move(writer)) {
+}
+
+PcmCache::EntryWriter::~EntryWriter() {
+    writer.reset();
+    tempFile.deleteFile();
+}
+
+bool PcmCache::EntryWriter::write(const AudioBuffer<float>& block, int numSamples) {
+    return writer != nullptr && writer->writeFromAudioSampleBuffer(block, 0, numSamples);
+}
+
+bool PcmCache::EntryWriter::commit() {
+    if (writer == nullptr)
+        return false;
+
+    // Closing the writer patches the WAV header with the final length
+    writer.reset();
+
+    if (!tempFile.moveFileTo(entryFile))
+        return false;
+
+    cache.trim();
+    return true;
+}
+
+//==============================================================================
+PcmCache::PcmCache()
+    : directory(File::getSpecialLocation(File::userApplicationDataDirectory)
+                    .getChildFile("OtoDecks")
+                    .getChildFile("PcmCache")) {
+    directory.createDirectory();
+}
+
+PcmCache::~PcmCache() {
+}
+
+std::unique_ptr<AudioFormatReader> PcmCache::openReader(const File& source) {
+    auto hash = getHashFor(source);
+    if (hash.isEmpty())
+        return nullptr;
+
+    auto entry = getEntryFile(hash);
+    if (!entry.existsAsFile())
+        return nullptr;
+
+    std::unique_ptr<MemoryMappedAudioFormatReader> reader(WavAudioFormat().createMemoryMappedReader(entry));
+
+    if (reader == nullptr || !reader->mapEntireFile()) {
+        DBG("PcmCache: dropping unreadable entry " + entry.getFileName());
+        entry.deleteFile();
+        return nullptr;
+    }
+
+    // The access time is what the LRU eviction goes by
+    entry.setLastAccessTime(Time::getCurrentTime());
+    return reader;
+}
+
+std::unique_ptr<PcmCache::EntryWriter> PcmCache::createEntryWriter(const File& source,
+                                                                    const AudioFormatReader& reader) {
+    auto hash = getHashFor(source);
+    if (hash.isEmpty())
+        return nullptr;
+
+    // Two decks may load the same file at once, so each writer gets its own temporary file
+    auto tempFile = directory.getNonexistentChildFile(hash, ".tmp", false);
+
+    auto* stream = new FileOutputStream(tempFile);
+    if (stream->failedToOpen()) {
+        delete stream;
+        return nullptr;
+    }
+
+    // 32-bit WAV is written as float, so the mapped reader hands back the exact decoded samples
+    std::unique_ptr<AudioFormatWriter> writer(WavAudioFormat().createWriterFor(stream, reader.sampleRate,
+                                                                               reader.numChannels, 32, {}, 0));
+    if (writer == nullptr) {
+        delete stream;
+        tempFile.deleteFile();
+        return nullptr;
+    }
+
+    return std::unique_ptr<EntryWriter>(new EntryWriter(*this, getEntryFile(hash), tempFile, std::move(writer)));
+}
+
+void PcmCache::invalidate(const File& source) {
+    auto hash = getHashFor(source);
+
+    if (hash.isNotEmpty())
+        getEntryFile(hash).deleteFile();
+
+    hashes->forget(source);
+}
+
+void PcmCache::setMaxSizeBytes(int64 newMaxSize) {
+    maxSizeBytes = newMaxSize;
+    trim();
+}
+
+int64 PcmCache::getMaxSizeBytes() const noexcept {
+    return maxSizeBytes.load();
+}
+
+int64 PcmCache::getSizeBytes() const {
+    int64 total = 0;
+
+    for (const auto& entry : RangedDirectoryIterator(directory, false, "*.wav"))
+        total += entry.getFileSize();
+
+    return total;
+}
+
+void PcmCache::trim() {
+    auto entries = directory.findChildFiles(File::findFiles, false, "*.wav");
+
+    int64 total = 0;
+    for (const auto& entry : entries)
+        total += entry.getSize();
+
+    if (total <= maxSizeBytes.load())
+        return;
+
+    std::sort(entries.begin(), entries.end(), [](const File& a, const File& b) {
+        return a.getLastAccessTime() < b.getLastAccessTime();
+    });
+
+    for (const auto& entry : entries) {
+        if (total <= maxSizeBytes.load())
+            break;
+
+        auto size = entry.getSize();
+        if (entry.deleteFile())
+            total -= size;
+    }
+}
+
+//==============================================================================
+File PcmCache::getEntryFile(const String& hash) const {
+    return directory.getChildFile(hash + ".wav");
+}
+
+String PcmCache::getHashFor(const File& source) {
+    String previousHash;
+    auto hash = hashes->getHash(source, &previousHash);
+
+    if (previousHash.isNotEmpty() && previousHash != hash) {
+        DBG("PcmCache: " + source.getFileName() + " has changed, dropping its old entry");
+        getEntryFile(previousHash).deleteFile();
+    }
+
+    return hash;
+}
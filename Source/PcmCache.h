@@ -0,0 +1,107 @@
+/*
+  ==============================================================================
+
+    PcmCache.h
+    Created: 16 Oct 2026 3:10:55pm
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include "ContentHashIndex.h"
+
+/**
+ * @class PcmCache
+ * @brief On-disk cache of decoded audio that is memory-mapped on reload
+ *
+ * Each entry is the whole track decoded to 32-bit float WAV and named after the
+ * source file's content hash. That layout is raw sample data behind a small header,
+ * so a cached track is opened with a memory-mapped reader and never decoded again.
+ *
+ * Entries are written by the loader's decode pass the first time a file is loaded,
+ * through an EntryWriter. The cache is kept under a size limit by deleting the least recently used entries, and
+ * an entry is dropped as soon as its source file's modification time changes.
+ * Hold it through a SharedResourcePointer.
+ */
+class PcmCache {
+public:
+    /** Default size limit of the cache folder */
+    static constexpr int64 defaultMaxSizeBytes = static_cast<int64>(4) * 1024 * 1024 * 1024;
+
+    /**
+     * @class EntryWriter
+     * @brief Writes one new entry; it only becomes visible once committed
+     */
+    class EntryWriter {
+    public:
+        /** Destructor - deletes the partly written entry unless it was committed */
+        ~EntryWriter();
+
+        /** Appends decoded samples, returns false if the write failed */
+        bool write(const AudioBuffer<float>& block, int numSamples);
+
+        /** Finishes the entry and makes it available to openReader */
+        bool commit();
+
+    private:
+        friend class PcmCache;
+
+        EntryWriter(PcmCache& cache, const File& entryFile, const File& tempFile,
+                    std::unique_ptr<AudioFormatWriter> writer);
+
+        PcmCache& cache;
+        File entryFile;
+        File tempFile;
+        std::unique_ptr<AudioFormatWriter> writer;
+
+        JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(EntryWriter)
+    };
+
+    PcmCache();
+    ~PcmCache();
+
+    /**
+     * Opens the cached decode of a file
+     * @param source The original audio file
+     * @return A memory-mapped reader over the cached audio, or nullptr on a cache miss
+     */
+    std::unique_ptr<AudioFormatReader> openReader(const File& source);
+
+    /**
+     * Starts a new entry for a file that missed the cache
+     * @param source The original audio file
+     * @param reader Reader for the source, giving the channel count and sample rate
+     * @return A writer to feed the decoded audio to, or nullptr if the entry can't be created
+     */
+    std::unique_ptr<EntryWriter> createEntryWriter(const File& source, const AudioFormatReader& reader);
+
+    /** Removes the cached decode of a file */
+    void invalidate(const File& source);
+
+    /** Sets the size limit and evicts entries if the cache is now over it */
+    void setMaxSizeBytes(int64 newMaxSize);
+
+    /** Gets the size limit */
+    int64 getMaxSizeBytes() const noexcept;
+
+    /** Gets the total size of all entries on disk */
+    int64 getSizeBytes() const;
+
+    /** Deletes least recently used entries until the cache fits its size limit */
+    void trim();
+
+private:
+    /** Gets the file an entry with this hash is stored in */
+    File getEntryFile(const String& hash) const;
+
+    /** Gets the hash of a source file, dropping the stale entry if the file has changed */
+    String getHashFor(const File& source);
+
+    File directory;
+    std::atomic<int64> maxSizeBytes{defaultMaxSizeBytes};
+    SharedResourcePointer<ContentHashIndex> hashes;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(PcmCache)
+};
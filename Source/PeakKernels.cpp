@@ -0,0 +1,193 @@
+/*
+  ==============================================================================
+
+    PeakKernels.cpp
+    Created: 16 Oct 2026 8:02:51pm
+
+  ==============================================================================
+*/
+
+#include "PeakKernels.h"
+#include "SimdTargets.h"
+
+namespace {
+
+//==============================================================================
+PeakKernels::Stats analyseRangeScalar(const float* samples, int numSamples) {
+    PeakKernels::Stats stats;
+    if (numSamples <= 0)
+        return stats;
+
+    stats.min = samples[0];
+    stats.max = samples[0];
+
+    for (int i = 0; i < numSamples; ++i) {
+        stats.min = jmin(stats.min, samples[i]);
+        stats.max = jmax(stats.max, samples[i]);
+        stats.sumOfSquares += samples[i] * samples[i];
+    }
+
+    return stats;
+}
+
+/** Folds per-lane partial results and the samples left over after the vector loop */
+PeakKernels::Stats reduceLanes(const float* lanesMin, const float* lanesMax, const float* lanesSquares,
+                               int numLanes, const float* tail, int numTail) {
+    PeakKernels::Stats stats;
+    stats.min = lanesMin[0];
+    stats.max = lanesMax[0];
+
+    for (int i = 0; i < numLanes; ++i) {
+        stats.min = jmin(stats.min, lanesMin[i]);
+        stats.max = jmax(stats.max, lanesMax[i]);
+        stats.sumOfSquares += lanesSquares[i];
+    }
+
+    for (int i = 0; i < numTail; ++i) {
+        stats.min = jmin(stats.min, tail[i]);
+        stats.max = jmax(stats.max, tail[i]);
+        stats.sumOfSquares += tail[i] * tail[i];
+    }
+
+    return stats;
+}
+
+void analyseBinsScalar(const float* samples, int numBins, int binSize, PeakKernels::Stats* results) {
+    for (int bin = 0; bin < numBins; ++bin)
+        results[bin] = analyseRangeScalar(samples + static_cast<size_t>(bin) * binSize, binSize);
+}
+
+//==============================================================================
+#if JUCE_USE_SSE_INTRINSICS
+PeakKernels::Stats analyseRangeSSE(const float* samples, int numSamples) {
+    if (numSamples < 4)
+        return analyseRangeScalar(samples, numSamples);
+
+    auto first = _mm_loadu_ps(samples);
+    auto vMin = first;
+    auto vMax = first;
+    auto vSquares = _mm_mul_ps(first, first);
+
+    int i = 4;
+    for (; i + 4 <= numSamples; i += 4) {
+        auto v = _mm_loadu_ps(samples + i);
+        vMin = _mm_min_ps(vMin, v);
+        vMax = _mm_max_ps(vMax, v);
+        vSquares = _mm_add_ps(vSquares, _mm_mul_ps(v, v));
+    }
+
+    alignas(16) float lanesMin[4], lanesMax[4], lanesSquares[4];
+    _mm_store_ps(lanesMin, vMin);
+    _mm_store_ps(lanesMax, vMax);
+    _mm_store_ps(lanesSquares, vSquares);
+
+    return reduceLanes(lanesMin, lanesMax, lanesSquares, 4, samples + i, numSamples - i);
+}
+
+void analyseBinsSSE(const float* samples, int numBins, int binSize, PeakKernels::Stats* results) {
+    for (int bin = 0; bin < numBins; ++bin)
+        results[bin] = analyseRangeSSE(samples + static_cast<size_t>(bin) * binSize, binSize);
+}
+
+OTODECKS_TARGET_AVX2
+PeakKernels::Stats analyseRangeAVX2(const float* samples, int numSamples) {
+    if (numSamples < 8)
+        return analyseRangeSSE(samples, numSamples);
+
+    auto first = _mm256_loadu_ps(samples);
+    auto vMin = first;
+    auto vMax = first;
+    auto vSquares = _mm256_mul_ps(first, first);
+
+    int i = 8;
+    for (; i + 8 <= numSamples; i += 8) {
+        auto v = _mm256_loadu_ps(samples + i);
+        vMin = _mm256_min_ps(vMin, v);
+        vMax = _mm256_max_ps(vMax, v);
+        vSquares = _mm256_fmadd_ps(v, v, vSquares);
+    }
+
+    alignas(32) float lanesMin[8], lanesMax[8], lanesSquares[8];
+    _mm256_store_ps(lanesMin, vMin);
+    _mm256_store_ps(lanesMax, vMax);
+    _mm256_store_ps(lanesSquares, vSquares);
+
+    return reduceLanes(lanesMin, lanesMax, lanesSquares, 8, samples + i, numSamples - i);
+}
+
+OTODECKS_TARGET_AVX2
+void analyseBinsAVX2(const float* samples, int numBins, int binSize, PeakKernels::Stats* results) {
+    for (int bin = 0; bin < numBins; ++bin)
+        results[bin] = analyseRangeAVX2(samples + static_cast<size_t>(bin) * binSize, binSize);
+}
+#endif
+
+//==============================================================================
+#if JUCE_USE_ARM_NEON
+PeakKernels::Stats analyseRangeNEON(const float* samples, int numSamples) {
+    if (numSamples < 4)
+        return analyseRangeScalar(samples, numSamples);
+
+    auto first = vld1q_f32(samples);
+    auto vMin = first;
+    auto vMax = first;
+    auto vSquares = vmulq_f32(first, first);
+
+    int i = 4;
+    for (; i + 4 <= numSamples; i += 4) {
+        auto v = vld1q_f32(samples + i);
+        vMin = vminq_f32(vMin, v);
+        vMax = vmaxq_f32(vMax, v);
+        vSquares = vmlaq_f32(vSquares, v, v);
+    }
+
+    float lanesMin[4], lanesMax[4], lanesSquares[4];
+    vst1q_f32(lanesMin, vMin);
+    vst1q_f32(lanesMax, vMax);
+    vst1q_f32(lanesSquares, vSquares);
+
+    return reduceLanes(lanesMin, lanesMax, lanesSquares, 4, samples + i, numSamples - i);
+}
+
+void analyseBinsNEON(const float* samples, int numBins, int binSize, PeakKernels::Stats* results) {
+    for (int bin = 0; bin < numBins; ++bin)
+        results[bin] = analyseRangeNEON(samples + static_cast<size_t>(bin) * binSize, binSize);
+}
+#endif
+
+} // namespace
+
+//==============================================================================
+PeakKernels::Stats PeakKernels::analyse(const float* samples, int numSamples) {
+    Stats stats;
+    if (numSamples > 0)
+        getBestImplementation().analyseBins(samples, 1, numSamples, &stats);
+    return stats;
+}
+
+void PeakKernels::analyseBins(const float* samples, int numBins, int binSize, Stats* results) {
+    jassert(binSize > 0);
+    getBestImplementation().analyseBins(samples, numBins, binSize, results);
+}
+
+const PeakKernels::Implementation& PeakKernels::getBestImplementation() {
+    static const Implementation best = getAvailableImplementations().back();
+    return best;
+}
+
+std::vector<PeakKernels::Implementation> PeakKernels::getAvailableImplementations() {
+    std::vector<Implementation> implementations { { "scalar", analyseBinsScalar } };
+
+   #if JUCE_USE_SSE_INTRINSICS
+    implementations.push_back({ "sse", analyseBinsSSE });
+
+    if (canUseAVX2())
+        implementations.push_back({ "avx2", analyseBinsAVX2 });
+   #endif
+
+   #if JUCE_USE_ARM_NEON
+    implementations.push_back({ "neon", analyseBinsNEON });
+   #endif
+
+    return implementations;
+}
@@ -0,0 +1,57 @@
+/*
+  ==============================================================================
+
+    PeakKernels.h
+    Created: 16 Oct 2026 8:02:51pm
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "../JuceLibraryCode/JuceHeader.h"
+
+/**
+ * @struct PeakKernels
+ * @brief Vectorised min/max/sum-of-squares reductions for waveform analysis
+ *
+ * Each kernel reduces runs of equal-sized bins of one channel in a single call, so
+ * the per-call overhead is paid once per decoded block rather than once per bin.
+ * Kernels exist for SSE and AVX2 on x86 and NEON on ARM, plus a scalar fallback;
+ * the fastest one the CPU supports is picked the first time it is needed.
+ */
+struct PeakKernels {
+    /** Reduction of one bin of samples */
+    struct Stats {
+        float min = 0.0f;
+        float max = 0.0f;
+        float sumOfSquares = 0.0f;
+    };
+
+    /**
+     * Signature shared by all kernels
+     * @param samples numBins * binSize contiguous samples
+     * @param numBins Number of bins to reduce
+     * @param binSize Samples per bin, at least 1
+     * @param results Receives numBins reductions
+     */
+    using AnalyseBinsFunction = void (*)(const float* samples, int numBins, int binSize, Stats* results);
+
+    /** A kernel and the instruction set it uses */
+    struct Implementation {
+        const char* name;
+        AnalyseBinsFunction analyseBins;
+    };
+
+    /** Reduces a single run of samples with the best kernel */
+    static Stats analyse(const float* samples, int numSamples);
+
+    /** Reduces numBins consecutive bins of binSize samples with the best kernel */
+    static void analyseBins(const float* samples, int numBins, int binSize, Stats* results);
+
+    /** Gets the fastest kernel supported by this CPU */
+    static const Implementation& getBestImplementation();
+
+    /** Gets every kernel this CPU can run, slowest (scalar) first */
+    static std::vector<Implementation> getAvailableImplementations();
+};
@@ -0,0 +1,54 @@
+/*
+  ==============================================================================
+
+    PlayheadClock.cpp
+    Created: 16 Oct 2026 9:12:40pm
+
+  ==============================================================================
+*/
+
+#include "PlayheadClock.h"
+
+void PlayheadClock::publish(const Snapshot& snapshot) noexcept {
+    // An odd sequence number marks a publish in progress
+    auto seq = sequence.load(std::memory_order_relaxed);
+    sequence.store(seq + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    samplePosition.store(snapshot.samplePosition, std::memory_order_relaxed);
+    timeMs.store(snapshot.timeMs, std::memory_order_relaxed);
+    samplesPerMs.store(snapshot.samplesPerMs, std::memory_order_relaxed);
+    lengthInSamples.store(snapshot.lengthInSamples, std::memory_order_relaxed);
+
+    sequence.store(seq + 2, std::memory_order_release);
+}
+
+PlayheadClock::Snapshot PlayheadClock::read() const noexcept {
+    Snapshot snapshot;
+
+    for (;;) {
+        auto before = sequence.load(std::memory_order_acquire);
+
+        if ((before & 1) == 0) {
+            snapshot.samplePosition = samplePosition.load(std::memory_order_relaxed);
+            snapshot.timeMs = timeMs.load(std::memory_order_relaxed);
+            snapshot.samplesPerMs = samplesPerMs.load(std::memory_order_relaxed);
+            snapshot.lengthInSamples = lengthInSamples.load(std::memory_order_relaxed);
+
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (sequence.load(std::memory_order_relaxed) == before)
+                return snapshot;
+        }
+    }
+}
+
+bool PlayheadClock::hasPublished() const noexcept {
+    return read().timeMs > 0.0;
+}
+
+double PlayheadClock::getSamplePositionAt(double time) const noexcept {
+    auto snapshot = read();
+    auto position = snapshot.samplePosition + (time - snapshot.timeMs) * snapshot.samplesPerMs;
+
+    return jlimit(0.0, static_cast<double>(snapshot.lengthInSamples), position);
+}
@@ -0,0 +1,62 @@
+/*
+  ==============================================================================
+
+    PlayheadClock.h
+    Created: 16 Oct 2026 9:12:40pm
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "../JuceLibraryCode/JuceHeader.h"
+
+/**
+ * @class PlayheadClock
+ * @brief Hands the audible playback position from the audio thread to the UI
+ *
+ * The audio thread publishes, once per callback, which track sample will be heard
+ * at what time and how fast the position is moving. Readers extrapolate from that
+ * to any moment, so the UI can follow the playhead at display refresh rate
+ * without polling the transport.
+ *
+ * Publishing is wait-free. The fields are guarded by a sequence counter, so a
+ * reader that overlaps a publish simply retries and never sees a torn snapshot.
+ */
+class PlayheadClock {
+public:
+    /** One published position */
+    struct Snapshot {
+        double samplePosition = 0.0;    /**< Track sample heard at timeMs */
+        double timeMs = 0.0;            /**< On the Time::getMillisecondCounterHiRes() timebase */
+        double samplesPerMs = 0.0;      /**< Track samples per millisecond, 0 when stopped */
+        int64 lengthInSamples = 0;      /**< Length of the track being played */
+    };
+
+    PlayheadClock() = default;
+
+    /** Publishes a new position (audio thread, single writer) */
+    void publish(const Snapshot& snapshot) noexcept;
+
+    /** Reads the most recently published position */
+    Snapshot read() const noexcept;
+
+    /** Returns true once anything has been published */
+    bool hasPublished() const noexcept;
+
+    /**
+     * Extrapolates the audible position to the given time
+     * @param timeMs Time on the Time::getMillisecondCounterHiRes() timebase
+     * @return Position in track samples, clamped to the track
+     */
+    double getSamplePositionAt(double timeMs) const noexcept;
+
+private:
+    std::atomic<uint32> sequence{0};
+    std::atomic<double> samplePosition{0.0};
+    std::atomic<double> timeMs{0.0};
+    std::atomic<double> samplesPerMs{0.0};
+    std::atomic<int64> lengthInSamples{0};
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(PlayheadClock)
+};
@@ -0,0 +1,360 @@
+/*
+  ==============================================================================
+
+    QualityResamplingAudioSource.cpp
+    Created: 16 Oct 2026 11:34:52pm
+
+  ==============================================================================
+*/
+
+#include "QualityResamplingAudioSource.h"
+#include "SimdTargets.h"
+
+namespace {
+
+//==============================================================================
+// Dot products of a run of input samples with a run of filter taps
+
+float dotScalar(const float* a, const float* b, int n) noexcept {
+    float sum = 0.0f;
+    for (int i = 0; i < n; ++i)
+        sum += a[i] * b[i];
+    return sum;
+}
+
+#if JUCE_USE_SSE_INTRINSICS
+float dotSSE(const float* a, const float* b, int n) noexcept {
+    auto acc = _mm_setzero_ps();
+    int i = 0;
+    for (; i + 4 <= n; i += 4)
+        acc = _mm_add_ps(acc, _mm_mul_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i)));
+
+    alignas(16) float lanes[4];
+    _mm_store_ps(lanes, acc);
+    return lanes[0] + lanes[1] + lanes[2] + lanes[3] + dotScalar(a + i, b + i, n - i);
+}
+
+OTODECKS_TARGET_AVX2
+float dotAVX2(const float* a, const float* b, int n) noexcept {
+    auto acc = _mm256_setzero_ps();
+    int i = 0;
+    for (; i + 8 <= n; i += 8)
+        acc = _mm256_fmadd_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i), acc);
+
+    alignas(32) float lanes[8];
+    _mm256_store_ps(lanes, acc);
+
+    float sum = 0.0f;
+    for (auto lane : lanes)
+        sum += lane;
+    return sum + dotScalar(a + i, b + i, n - i);
+}
+#endif
+
+#if JUCE_USE_ARM_NEON
+float dotNEON(const float* a, const float* b, int n) noexcept {
+    auto acc = vdupq_n_f32(0.0f);
+    int i = 0;
+    for (; i + 4 <= n; i += 4)
+        acc = vmlaq_f32(acc, vld1q_f32(a + i), vld1q_f32(b + i));
+
+    float lanes[4];
+    vst1q_f32(lanes, acc);
+    return lanes[0] + lanes[1] + lanes[2] + lanes[3] + dotScalar(a + i, b + i, n - i);
+}
+#endif
+
+using DotFunction = float (*)(const float*, const float*, int) noexcept;
+
+DotFunction getBestDot() {
+   #if JUCE_USE_SSE_INTRINSICS
+    if (canUseAVX2())
+        return dotAVX2;
+    return dotSSE;
+   #elif JUCE_USE_ARM_NEON
+    return dotNEON;
+   #else
+    return dotScalar;
+   #endif
+}
+
+const DotFunction dotProduct = getBestDot();
+
+/** Zeroth-order modified Bessel function of the first kind, for the Kaiser window */
+double besselI0(double x) {
+    double sum = 1.0;
+    double term = 1.0;
+
+    for (int k = 1; k < 50; ++k) {
+        term *= (x / (2.0 * k)) * (x / (2.0 * k));
+        sum += term;
+        if (term < sum * 1.0e-12)
+            break;
+    }
+
+    return sum;
+}
+
+} // namespace
+
+//==============================================================================
+struct QualityResamplingAudioSource::SincKernel {
+    /**
+     * @param zeroCrossingsToUse Half-width of the prototype in zero crossings
+     * @param cutoffToUse Passband edge relative to the input Nyquist frequency
+     * @param kaiserBeta Window shape; higher trades a wider transition for lower sidelobes
+     * @param numPhasesToUse Rows in the polyphase table
+     */
+    SincKernel(int zeroCrossingsToUse, float cutoffToUse, double kaiserBeta, int numPhasesToUse)
+        : zeroCrossings(zeroCrossingsToUse),
+          cutoff(cutoffToUse),
+          numPhases(numPhasesToUse) {
+        // Prototype g(u) = sinc(u) * kaiser(u / Z), sampled finely over u in [0, Z]
+        prototype.resize(static_cast<size_t>(zeroCrossings * prototypeResolution + 2));
+        auto i0Beta = besselI0(kaiserBeta);
+
+        for (size_t i = 0; i < prototype.size(); ++i) {
+            auto u = static_cast<double>(i) / prototypeResolution;
+            auto x = u / zeroCrossings;
+            auto window = x < 1.0 ? besselI0(kaiserBeta * std::sqrt(1.0 - x * x)) / i0Beta : 0.0;
+            auto sinc = u == 0.0 ? 1.0 : std::sin(MathConstants<double>::pi * u) / (MathConstants<double>::pi * u);
+            prototype[i] = static_cast<float>(sinc * window);
+        }
+
+        // At ratios up to 1 the kernel is fixed, so every fractional phase is tabulated
+        halfTaps = getHalfTaps(1.0);
+        numTaps = halfTaps * 2;
+        phaseTable.resize(static_cast<size_t>((numPhases + 1) * numTaps));
+
+        for (int phase = 0; phase <= numPhases; ++phase) {
+            auto fraction = static_cast<float>(phase) / static_cast<float>(numPhases);
+            fillTaps(phaseTable.data() + phase * numTaps, fraction, cutoff, halfTaps);
+        }
+    }
+
+    /** Gets the number of taps each side of the read position at a given ratio */
+    int getHalfTaps(double ratio) const noexcept {
+        return static_cast<int>(std::ceil(zeroCrossings * jmax(1.0, ratio) / cutoff)) + 1;
+    }
+
+    /** Evaluates the scaled kernel c * g(c * x) */
+    float evaluate(float x, float scaledCutoff) const noexcept {
+        auto u = std::abs(x * scaledCutoff) * static_cast<float>(prototypeResolution);
+        auto index = static_cast<int>(u);
+        if (index >= static_cast<int>(prototype.size()) - 1)
+            return 0.0f;
+
+        auto t = u - static_cast<float>(index);
+        return scaledCutoff * (prototype[static_cast<size_t>(index)] * (1.0f - t) + prototype[static_cast<size_t>(index) + 1] * t);
+    }
+
+    /** Fills 2 * half taps for input samples -(half - 1)..half around the read position */
+    void fillTaps(float* taps, float fraction, float scaledCutoff, int half) const noexcept {
+        for (int j = 0; j < half * 2; ++j)
+            taps[j] = evaluate(static_cast<float>(j - half + 1) - fraction, scaledCutoff);
+    }
+
+    static constexpr int prototypeResolution = 512;
+
+    int zeroCrossings;
+    float cutoff;
+    int numPhases;
+    int halfTaps = 0;
+    int numTaps = 0;
+
+    std::vector<float> prototype;
+    std::vector<float> phaseTable;
+};
+
+//==============================================================================
+QualityResamplingAudioSource::QualityResamplingAudioSource(AudioSource* input, int numberOfChannels)
+    : input(input),
+      numChannels(numberOfChannels),
+      fastResampler(input, false, numberOfChannels) {
+    jassert(input != nullptr);
+}
+
+QualityResamplingAudioSource::~QualityResamplingAudioSource() {
+}
+
+void QualityResamplingAudioSource::prepareToPlay(int samplesPerBlockExpected, double sampleRate) {
+    // Also prepares the input
+    fastResampler.prepareToPlay(samplesPerBlockExpected, sampleRate);
+
+    maxPullSize = jmax(1, samplesPerBlockExpected);
+
+    // Enough history for the widest kernel at the highest ratio, plus one block of input at that ratio
+    historyPadding = getKernel(Quality::highQuality).getHalfTaps(maxSincRatio);
+    auto capacity = historyPadding * 2 + static_cast<int>(std::ceil(maxSincRatio * maxPullSize)) + maxPullSize + 2;
+    history.setSize(numChannels, capacity);
+    coefficients.allocate(static_cast<size_t>(historyPadding * 2), true);
+
+    flushBuffers();
+}
+
+void QualityResamplingAudioSource::releaseResources() {
+    fastResampler.releaseResources();
+
+    history.setSize(numChannels, 0);
+    coefficients.free();
+    historyLength = 0;
+}
+
+void QualityResamplingAudioSource::getNextAudioBlock(const AudioSourceChannelInfo& bufferToFill) {
+    if (quality.load() == Quality::fast) {
+        fastResampler.setResamplingRatio(ratio.load());
+        fastResampler.getNextAudioBlock(bufferToFill);
+        return;
+    }
+
+    if (history.getNumSamples() == 0) {
+        bufferToFill.clearActiveBufferRegion();
+        return;
+    }
+
+    // Longer blocks than the device's are split so the history never overflows
+    for (int offset = 0; offset < bufferToFill.numSamples; offset += maxPullSize) {
+        renderSinc(AudioSourceChannelInfo(bufferToFill.buffer, bufferToFill.startSample + offset,
+                                          jmin(maxPullSize, bufferToFill.numSamples - offset)));
+    }
+}
+
+//==============================================================================
+void QualityResamplingAudioSource::setQuality(Quality newQuality) {
+    if (quality.exchange(newQuality) != newQuality)
+        flushBuffers();
+}
+
+QualityResamplingAudioSource::Quality QualityResamplingAudioSource::getQuality() const noexcept {
+    return quality.load();
+}
+
+void QualityResamplingAudioSource::setResamplingRatio(double samplesInPerOutputSample) {
+    jassert(samplesInPerOutputSample > 0.0);
+    ratio = jmax(0.0, samplesInPerOutputSample);
+}
+
+double QualityResamplingAudioSource::getResamplingRatio() const noexcept {
+    return ratio.load();
+}
+
+void QualityResamplingAudioSource::flushBuffers() {
+    fastResampler.flushBuffers();
+
+    // Zeros stand in for the input before the first sample, so output starts exactly on it
+    history.clear();
+    historyLength = historyPadding;
+    readPosition = static_cast<double>(historyPadding);
+}
+
+int QualityResamplingAudioSource::getLatencySamples() const noexcept {
+    auto currentQuality = quality.load();
+    if (currentQuality == Quality::fast)
+        return 0;
+
+    return getKernel(currentQuality).getHalfTaps(jmin(maxSincRatio, ratio.load()));
+}
+
+String QualityResamplingAudioSource::getQualityName(Quality qualityToName) {
+    switch (qualityToName) {
+        case Quality::fast:         return "Fast";
+        case Quality::sinc:         return "Sinc";
+        case Quality::highQuality:  return "HQ";
+    }
+
+    return {};
+}
+
+//==============================================================================
+const QualityResamplingAudioSource::SincKernel& QualityResamplingAudioSource::getKernel(Quality kernelQuality) {
+    static const SincKernel sincKernel(8, 0.90f, 6.0, 256);
+    static const SincKernel highQualityKernel(32, 0.96f, 10.0, 512);
+
+    return kernelQuality == Quality::highQuality ? highQualityKernel : sincKernel;
+}
+
+void QualityResamplingAudioSource::renderSinc(const AudioSourceChannelInfo& bufferToFill) {
+    const auto& kernel = getKernel(quality.load());
+    auto currentRatio = jlimit(0.0, maxSincRatio, ratio.load());
+
+    // Above a ratio of 1 the cutoff drops with the output Nyquist frequency and the kernel widens to match
+    auto widened = currentRatio > 1.0;
+    auto scaledCutoff = widened ? kernel.cutoff / static_cast<float>(currentRatio) : kernel.cutoff;
+    auto half = widened ? kernel.getHalfTaps(currentRatio) : kernel.halfTaps;
+    auto numTaps = half * 2;
+
+    auto lastPosition = readPosition + currentRatio * (bufferToFill.numSamples - 1);
+    ensureHistory(static_cast<int>(lastPosition) + half + 1);
+
+    auto channelsToFill = jmin(numChannels, bufferToFill.buffer->getNumChannels());
+
+    // At exactly 1:1 on a whole sample, e.g. a file at the device rate, the input passes straight through
+    auto passThrough = currentRatio == 1.0 && readPosition == std::floor(readPosition);
+
+    if (passThrough) {
+        for (int chan = 0; chan < channelsToFill; ++chan)
+            bufferToFill.buffer->copyFrom(chan, bufferToFill.startSample, history,
+                                          chan, static_cast<int>(readPosition), bufferToFill.numSamples);
+
+        readPosition += bufferToFill.numSamples;
+    }
+    else {
+        for (int i = 0; i < bufferToFill.numSamples; ++i) {
+            auto index = static_cast<int>(readPosition);
+            auto fraction = static_cast<float>(readPosition - index);
+
+            if (widened) {
+                kernel.fillTaps(coefficients, fraction, scaledCutoff, half);
+            }
+            else {
+                // Interpolate between the two nearest tabulated phases
+                auto phasePosition = fraction * static_cast<float>(kernel.numPhases);
+                auto phase = jmin(kernel.numPhases - 1, static_cast<int>(phasePosition));
+                auto t = phasePosition - static_cast<float>(phase);
+                const auto* row = kernel.phaseTable.data() + phase * numTaps;
+
+                FloatVectorOperations::copyWithMultiply(coefficients, row, 1.0f - t, numTaps);
+                FloatVectorOperations::addWithMultiply(coefficients, row + numTaps, t, numTaps);
+            }
+
+            auto windowStart = index - half + 1;
+
+            for (int chan = 0; chan < channelsToFill; ++chan)
+                bufferToFill.buffer->setSample(chan, bufferToFill.startSample + i,
+                                               dotProduct(history.getReadPointer(chan, windowStart), coefficients, numTaps));
+
+            readPosition += currentRatio;
+        }
+    }
+
+    for (int chan = channelsToFill; chan < bufferToFill.buffer->getNumChannels(); ++chan)
+        bufferToFill.buffer->clear(chan, bufferToFill.startSample, bufferToFill.numSamples);
+
+    // Keep just enough history behind the read position for the widest kernel
+    auto numToDiscard = static_cast<int>(readPosition) - historyPadding;
+    if (numToDiscard > 0) {
+        auto numToKeep = historyLength - numToDiscard;
+
+        for (int chan = 0; chan < numChannels; ++chan) {
+            auto* samples = history.getWritePointer(chan);
+            std::memmove(samples, samples + numToDiscard, sizeof(float) * static_cast<size_t>(jmax(0, numToKeep)));
+        }
+
+        historyLength = jmax(0, numToKeep);
+        readPosition -= numToDiscard;
+    }
+}
+
+void QualityResamplingAudioSource::ensureHistory(int numSamplesNeeded) {
+    while (historyLength < numSamplesNeeded) {
+        auto numToPull = jmin(maxPullSize, numSamplesNeeded - historyLength, history.getNumSamples() - historyLength);
+
+        if (numToPull <= 0) {
+            jassertfalse; // the history is too small for this ratio and block size
+            return;
+        }
+
+        input->getNextAudioBlock(AudioSourceChannelInfo(&history, historyLength, numToPull));
+        historyLength += numToPull;
+    }
+}
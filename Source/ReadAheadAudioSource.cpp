@@ -0,0 +1,255 @@
+/*
+  ==============================================================================
+
+    ReadAheadAudioSource.cpp
+    Created: 16 Oct 2026 9:40:12am
+
+  ==============================================================================
+*/
+
+#include "ReadAheadAudioSource.h"
+
+//==============================================================================
+ReadAheadThread::ReadAheadThread()
+    : TimeSliceThread("DJ read-ahead") {
+    startThread(Thread::Priority::high);
+}
+
+ReadAheadThread::~ReadAheadThread() {
+    stopThread(2000);
+}
+
+//==============================================================================
+ReadAheadAudioSource::ReadAheadAudioSource(PositionableAudioSource* source,
+                                           TimeSliceThread& thread,
+                                           int bufferSizeSamples,
+                                           int numberOfChannels)
+    : source(source),
+      backgroundThread(thread),
+      bufferSize(jmax(1024, bufferSizeSamples)),
+      numChannels(numberOfChannels) {
+    jassert(source != nullptr);
+}
+
+ReadAheadAudioSource::~ReadAheadAudioSource() {
+    releaseResources();
+}
+
+void ReadAheadAudioSource::prepareToPlay(int samplesPerBlockExpected, double sampleRate) {
+    auto bufferSizeNeeded = jmax(samplesPerBlockExpected * 2, bufferSize);
+
+    if (!isPrepared || bufferSizeNeeded != buffer.getNumSamples()) {
+        // Stop the reader before touching the buffer it writes into
+        backgroundThread.removeTimeSliceClient(this);
+
+        buffer.setSize(numChannels, bufferSizeNeeded);
+        source->prepareToPlay(samplesPerBlockExpected, sampleRate);
+
+        {
+            const ScopedLock sl(bufferRangeLock);
+            bufferValidStart = 0;
+            bufferValidEnd = 0;
+        }
+
+        // Prefill a quarter of a second (or half the buffer) so playback can start straight away
+        auto prefillTarget = jmin(static_cast<int64>(sampleRate / 4), static_cast<int64>(bufferSizeNeeded / 2));
+        while (bufferValidEnd - bufferValidStart < prefillTarget && readNextBufferChunk()) {
+        }
+
+        isPrepared = true;
+        backgroundThread.addTimeSliceClient(this);
+    }
+}
+
+void ReadAheadAudioSource::releaseResources() {
+    isPrepared = false;
+    backgroundThread.removeTimeSliceClient(this);
+
+    buffer.setSize(numChannels, 0);
+    source->releaseResources();
+}
+
+void ReadAheadAudioSource::getNextAudioBlock(const AudioSourceChannelInfo& bufferToFill) {
+    // The read-ahead thread only holds the lock to move the range, never while reading, so a
+    // wait is short; it is still counted, so any contention shows up
+    const ScopedTryLock tryLock(bufferRangeLock);
+    if (!tryLock.isLocked())
+        rangeLockWaits.fetch_add(1, std::memory_order_relaxed);
+
+    // The lock is recursive, so this only waits if the try failed
+    const ScopedLock sl(bufferRangeLock);
+
+    auto pos = nextPlayPos.load();
+    auto validStart = static_cast<int>(jlimit(bufferValidStart, bufferValidEnd, pos) - pos);
+    auto validEnd = static_cast<int>(jlimit(bufferValidStart, bufferValidEnd, pos + bufferToFill.numSamples) - pos);
+
+    // Only samples that exist in the source count as missing; the tail after the end is silence anyway
+    auto wanted = static_cast<int>(jlimit(static_cast<int64>(0), static_cast<int64>(bufferToFill.numSamples),
+                                          source->getTotalLength() - pos));
+    auto missing = wanted - jmin(wanted, validEnd - validStart);
+
+    if (missing > 0) {
+        underrunCount.fetch_add(1, std::memory_order_relaxed);
+        underrunSamples.fetch_add(missing, std::memory_order_relaxed);
+    }
+
+    if (validStart == validEnd) {
+        bufferToFill.clearActiveBufferRegion();
+    }
+    else {
+        if (validStart > 0)
+            bufferToFill.buffer->clear(bufferToFill.startSample, validStart);
+
+        if (validEnd < bufferToFill.numSamples)
+            bufferToFill.buffer->clear(bufferToFill.startSample + validEnd, bufferToFill.numSamples - validEnd);
+
+        auto ringSize = buffer.getNumSamples();
+        auto ringStart = static_cast<int>((pos + validStart) % ringSize);
+        auto ringEnd = static_cast<int>((pos + validEnd) % ringSize);
+
+        for (int chan = jmin(numChannels, bufferToFill.buffer->getNumChannels()); --chan >= 0;) {
+            if (ringStart < ringEnd) {
+                bufferToFill.buffer->copyFrom(chan, bufferToFill.startSample + validStart,
+                                              buffer, chan, ringStart, ringEnd - ringStart);
+            }
+            else {
+                auto initialSize = ringSize - ringStart;
+                bufferToFill.buffer->copyFrom(chan, bufferToFill.startSample + validStart,
+                                              buffer, chan, ringStart, initialSize);
+                bufferToFill.buffer->copyFrom(chan, bufferToFill.startSample + validStart + initialSize,
+                                              buffer, chan, 0, (validEnd - validStart) - initialSize);
+            }
+        }
+
+        // A mono source plays on every output channel, as AudioFormatReaderSource plays it; other extra channels are silent
+        for (int chan = numChannels; chan < bufferToFill.buffer->getNumChannels(); ++chan) {
+            if (numChannels == 1)
+                bufferToFill.buffer->copyFrom(chan, bufferToFill.startSample + validStart,
+                                              *bufferToFill.buffer, 0, bufferToFill.startSample + validStart, validEnd - validStart);
+            else
+                bufferToFill.buffer->clear(chan, bufferToFill.startSample + validStart, validEnd - validStart);
+        }
+    }
+
+    nextPlayPos += bufferToFill.numSamples;
+}
+
+//==============================================================================
+void ReadAheadAudioSource::setNextReadPosition(int64 newPosition) {
+    bool needsRefill;
+
+    {
+        const ScopedLock sl(bufferRangeLock);
+        nextPlayPos = newPosition;
+        needsRefill = newPosition < bufferValidStart || newPosition >= bufferValidEnd;
+    }
+
+    if (needsRefill)
+        backgroundThread.moveToFrontOfQueue(this);
+}
+
+int64 ReadAheadAudioSource::getNextReadPosition() const {
+    return nextPlayPos.load();
+}
+
+int64 ReadAheadAudioSource::getTotalLength() const {
+    return source->getTotalLength();
+}
+
+bool ReadAheadAudioSource::isLooping() const {
+    return false;
+}
+
+//==============================================================================
+int ReadAheadAudioSource::getUnderrunCount() const noexcept {
+    return underrunCount.load(std::memory_order_relaxed);
+}
+
+int64 ReadAheadAudioSource::getUnderrunSamples() const noexcept {
+    return underrunSamples.load(std::memory_order_relaxed);
+}
+
+void ReadAheadAudioSource::resetUnderrunCounters() noexcept {
+    underrunCount = 0;
+    underrunSamples = 0;
+}
+
+int64 ReadAheadAudioSource::getRangeLockWaits() const noexcept {
+    return rangeLockWaits.load(std::memory_order_relaxed);
+}
+
+int ReadAheadAudioSource::getBufferSize() const noexcept {
+    return bufferSize;
+}
+
+//==============================================================================
+int ReadAheadAudioSource::useTimeSlice() {
+    return readNextBufferChunk() ? 1 : 100;
+}
+
+bool ReadAheadAudioSource::readNextBufferChunk() {
+    constexpr int maxChunkSize = 2048;
+
+    int64 newBVS, newBVE, sectionToReadStart, sectionToReadEnd;
+
+    {
+        const ScopedLock sl(bufferRangeLock);
+
+        newBVS = jmax(static_cast<int64>(0), nextPlayPos.load());
+        newBVE = jmin(newBVS + buffer.getNumSamples() - 4, source->getTotalLength());
+        sectionToReadStart = 0;
+        sectionToReadEnd = 0;
+
+        if (newBVS < bufferValidStart || newBVS >= bufferValidEnd) {
+            // The play position jumped outside the buffer: start again from there
+            newBVE = jmin(newBVE, newBVS + maxChunkSize);
+            sectionToReadStart = newBVS;
+            sectionToReadEnd = newBVE;
+            bufferValidStart = 0;
+            bufferValidEnd = 0;
+        }
+        else if (newBVS - bufferValidStart > 512 || newBVE - bufferValidEnd > 512) {
+            newBVE = jmin(newBVE, bufferValidEnd + maxChunkSize);
+            sectionToReadStart = bufferValidEnd;
+            sectionToReadEnd = newBVE;
+            bufferValidStart = newBVS;
+            bufferValidEnd = jmin(bufferValidEnd, newBVE);
+        }
+    }
+
+    if (sectionToReadStart >= sectionToReadEnd)
+        return false;
+
+    auto ringSize = buffer.getNumSamples();
+    auto ringStart = static_cast<int>(sectionToReadStart % ringSize);
+    auto ringEnd = static_cast<int>(sectionToReadEnd % ringSize);
+    auto length = static_cast<int>(sectionToReadEnd - sectionToReadStart);
+
+    if (ringStart < ringEnd) {
+        readBufferSection(sectionToReadStart, length, ringStart);
+    }
+    else {
+        auto initialSize = ringSize - ringStart;
+        readBufferSection(sectionToReadStart, initialSize, ringStart);
+        readBufferSection(sectionToReadStart + initialSize, length - initialSize, 0);
+    }
+
+    {
+        const ScopedLock sl(bufferRangeLock);
+        bufferValidStart = newBVS;
+        bufferValidEnd = newBVE;
+    }
+
+    return true;
+}
+
+void ReadAheadAudioSource::readBufferSection(int64 start, int length, int bufferOffset) {
+    if (length <= 0)
+        return;
+
+    if (source->getNextReadPosition() != start)
+        source->setNextReadPosition(start);
+
+    AudioSourceChannelInfo info(&buffer, bufferOffset, length);
+    source->getNextAudioBlock(info);
+}
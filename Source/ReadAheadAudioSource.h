@@ -0,0 +1,131 @@
+/*
+  ==============================================================================
+
+    ReadAheadAudioSource.h
+    Created: 16 Oct 2026 9:40:12am
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "../JuceLibraryCode/JuceHeader.h"
+
+/**
+ * @class ReadAheadThread
+ * @brief Background thread shared by all decks for disk reads and decoding
+ *
+ * Hold it through a SharedResourcePointer so every deck feeds from the same
+ * thread and it is started and stopped with the first and last user.
+ */
+class ReadAheadThread : public TimeSliceThread {
+public:
+    ReadAheadThread();
+    ~ReadAheadThread() override;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ReadAheadThread)
+};
+
+/**
+ * @class ReadAheadAudioSource
+ * @brief Positionable source that reads its input ahead on a TimeSliceThread
+ *
+ * The input source is only ever pulled from the background thread, so the
+ * audio callback copies from a ring buffer and never waits on I/O or decoding.
+ * When the ring buffer does not hold the samples the callback asks for, the
+ * gap is filled with silence and counted as an underrun.
+ */
+class ReadAheadAudioSource : public PositionableAudioSource,
+                             private TimeSliceClient {
+public:
+    /**
+     * Constructor for ReadAheadAudioSource
+     * @param source The source to read from; it is not owned and must outlive this object
+     * @param thread The thread that fills the read-ahead buffer
+     * @param bufferSizeSamples Size of the read-ahead buffer in samples
+     * @param numberOfChannels Number of channels to buffer
+     */
+    ReadAheadAudioSource(PositionableAudioSource* source,
+                         TimeSliceThread& thread,
+                         int bufferSizeSamples,
+                         int numberOfChannels);
+
+    /** Destructor */
+    ~ReadAheadAudioSource() override;
+
+    //==========================================================================
+    // AudioSource overrides
+    //==========================================================================
+
+    /** Allocates the ring buffer, prefills it and registers with the thread */
+    void prepareToPlay(int samplesPerBlockExpected, double sampleRate) override;
+
+    /** Unregisters from the thread and frees the ring buffer */
+    void releaseResources() override;
+
+    /** Copies the next block from the ring buffer, counting any underrun */
+    void getNextAudioBlock(const AudioSourceChannelInfo& bufferToFill) override;
+
+    //==========================================================================
+    // PositionableAudioSource overrides
+    //==========================================================================
+
+    /** Moves the play position and wakes the reader if the buffer misses it */
+    void setNextReadPosition(int64 newPosition) override;
+
+    /** Gets the position of the next sample the callback will play */
+    int64 getNextReadPosition() const override;
+
+    /** Gets the length of the input source in samples */
+    int64 getTotalLength() const override;
+
+    /** Read-ahead sources never loop */
+    bool isLooping() const override;
+
+    //==========================================================================
+    // Underrun statistics
+    //==========================================================================
+
+    /** Gets the number of callbacks that could not be served fully from the buffer */
+    int getUnderrunCount() const noexcept;
+
+    /** Gets the total number of samples replaced with silence because of underruns */
+    int64 getUnderrunSamples() const noexcept;
+
+    /** Clears the underrun counters */
+    void resetUnderrunCounters() noexcept;
+
+    /** Gets the number of callbacks that found the buffer's range locked by the read-ahead thread and waited */
+    int64 getRangeLockWaits() const noexcept;
+
+    /** Gets the size of the read-ahead buffer in samples */
+    int getBufferSize() const noexcept;
+
+private:
+    /** TimeSliceClient override - tops up the ring buffer */
+    int useTimeSlice() override;
+
+    /** Reads the next chunk of the input into the ring buffer, returns false if idle */
+    bool readNextBufferChunk();
+
+    /** Reads a contiguous section of the input into the ring buffer */
+    void readBufferSection(int64 start, int length, int bufferOffset);
+
+    PositionableAudioSource* source;
+    TimeSliceThread& backgroundThread;
+    int bufferSize;
+    int numChannels;
+
+    AudioBuffer<float> buffer;
+    CriticalSection bufferRangeLock;
+    int64 bufferValidStart = 0;
+    int64 bufferValidEnd = 0;
+    std::atomic<int64> nextPlayPos{0};
+    bool isPrepared = false;
+
+    std::atomic<int> underrunCount{0};
+    std::atomic<int64> underrunSamples{0};
+    std::atomic<int64> rangeLockWaits{0};
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ReadAheadAudioSource)
+};
@@ -0,0 +1,34 @@
+/*
+  ==============================================================================
+
+    SimdTargets.h
+    Created: 17 Oct 2026 6:12:40am
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "../JuceLibraryCode/JuceHeader.h"
+
+// Intrinsics for the hand-vectorised kernels, shared so every kernel is built and chosen the same way
+
+#if JUCE_USE_SSE_INTRINSICS
+ #include <immintrin.h>
+
+ // AVX2 kernels are compiled for AVX2 on their own and only called once canUseAVX2() allows it
+ #if JUCE_MSVC
+  #define OTODECKS_TARGET_AVX2
+ #else
+  #define OTODECKS_TARGET_AVX2 __attribute__((target("avx2,fma")))
+ #endif
+
+/** Checks the CPU can run the functions marked OTODECKS_TARGET_AVX2 */
+inline bool canUseAVX2() {
+    return SystemStats::hasAVX2() && SystemStats::hasFMA3();
+}
+#endif
+
+#if JUCE_USE_ARM_NEON
+ #include <arm_neon.h>
+#endif
@@ -0,0 +1,75 @@
+/*
+  ==============================================================================
+
+    TempoSync.cpp
+    Created: 17 Oct 2026 5:36:41am
+
+  ==============================================================================
+*/
+
+#include "TempoSync.h"
+
+TempoSync::TempoSync() {
+}
+
+TempoSync::~TempoSync() {
+}
+
+//==============================================================================
+void TempoSync::setTimelinePosition(int64 samplePosition) noexcept {
+    timelinePosition.store(samplePosition, std::memory_order_relaxed);
+}
+
+int64 TempoSync::getTimelinePosition() const noexcept {
+    return timelinePosition.load(std::memory_order_relaxed);
+}
+
+//==============================================================================
+void TempoSync::setMaster(const void* deck) noexcept {
+    master.store(deck);
+}
+
+const void* TempoSync::getMaster() const noexcept {
+    return master.load();
+}
+
+bool TempoSync::isMaster(const void* deck) const noexcept {
+    return deck != nullptr && master.load() == deck;
+}
+
+void TempoSync::publishMaster(const MasterState& state) noexcept {
+    // Decks render in parallel, so just after the master changes the old and new master can
+    // both be publishing; whoever finds a publish in progress skips this block
+    auto seq = sequence.load(std::memory_order_relaxed);
+    if ((seq & 1) != 0 || !sequence.compare_exchange_strong(seq, seq + 1, std::memory_order_relaxed))
+        return;
+
+    std::atomic_thread_fence(std::memory_order_release);
+
+    publishedMaster.store(state.master, std::memory_order_relaxed);
+    publishedTimelineSample.store(state.timelineSample, std::memory_order_relaxed);
+    publishedBeat.store(state.beat, std::memory_order_relaxed);
+    publishedBeatsPerSample.store(state.beatsPerSample, std::memory_order_relaxed);
+
+    sequence.store(seq + 2, std::memory_order_release);
+}
+
+bool TempoSync::readMaster(MasterState& state) const noexcept {
+    for (;;) {
+        auto before = sequence.load(std::memory_order_acquire);
+
+        if ((before & 1) == 0) {
+            state.master = publishedMaster.load(std::memory_order_relaxed);
+            state.timelineSample = publishedTimelineSample.load(std::memory_order_relaxed);
+            state.beat = publishedBeat.load(std::memory_order_relaxed);
+            state.beatsPerSample = publishedBeatsPerSample.load(std::memory_order_relaxed);
+
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (sequence.load(std::memory_order_relaxed) == before)
+                break;
+        }
+    }
+
+    // A state left behind by a deck that is no longer the master is of no use
+    return state.master != nullptr && state.master == master.load();
+}
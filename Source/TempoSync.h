@@ -0,0 +1,86 @@
+/*
+  ==============================================================================
+
+    TempoSync.h
+    Created: 17 Oct 2026 5:36:41am
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "../JuceLibraryCode/JuceHeader.h"
+
+/**
+ * @class TempoSync
+ * @brief Sample clock and master tempo shared by every deck, for beat sync
+ *
+ * The mixer stamps each chunk it renders with its position on a running output
+ * timeline, so every deck knows which output sample its block starts at, whichever
+ * thread renders it. The master deck publishes, after each block, which beat of
+ * its track will be heard at a given timeline sample and how fast the beats are
+ * going; a synced deck extrapolates that to the start of its own block and
+ * locks its speed and phase to it.
+ *
+ * The master state is published with a sequence lock, like the PlayheadClock, so
+ * neither side ever blocks. Shared through SharedResourcePointer, like the other
+ * app-wide services.
+ */
+class TempoSync {
+public:
+    /** Where the master deck's beats fall on the output timeline */
+    struct MasterState {
+        const void* master = nullptr;   /**< The deck that published this state */
+        int64 timelineSample = 0;       /**< Output sample the beat position refers to */
+        double beat = 0.0;              /**< Beats since the track's first beat, heard at timelineSample */
+        double beatsPerSample = 0.0;    /**< Beats per output sample */
+    };
+
+    TempoSync();
+    ~TempoSync();
+
+    //==========================================================================
+    // Output timeline (audio thread)
+    //==========================================================================
+
+    /** Sets the timeline position of the chunk about to be rendered */
+    void setTimelinePosition(int64 samplePosition) noexcept;
+
+    /** Gets the timeline position of the chunk being rendered */
+    int64 getTimelinePosition() const noexcept;
+
+    //==========================================================================
+    // Master deck
+    //==========================================================================
+
+    /** Makes a deck the master, or clears the master with nullptr */
+    void setMaster(const void* deck) noexcept;
+
+    /** Gets the master deck, or nullptr */
+    const void* getMaster() const noexcept;
+
+    /** Returns true if the deck is the master */
+    bool isMaster(const void* deck) const noexcept;
+
+    /** Publishes the master's beat position (audio thread, master deck only); skipped if another publish is in progress */
+    void publishMaster(const MasterState& state) noexcept;
+
+    /**
+     * Reads the master's last published state
+     * @return false if the current master hasn't published anything yet
+     */
+    bool readMaster(MasterState& state) const noexcept;
+
+private:
+    std::atomic<int64> timelinePosition{0};
+    std::atomic<const void*> master{nullptr};
+
+    // Master state behind a sequence lock; an odd sequence means a publish is in progress
+    std::atomic<uint32> sequence{0};
+    std::atomic<const void*> publishedMaster{nullptr};
+    std::atomic<int64> publishedTimelineSample{0};
+    std::atomic<double> publishedBeat{0.0};
+    std::atomic<double> publishedBeatsPerSample{0.0};
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(TempoSync)
+};
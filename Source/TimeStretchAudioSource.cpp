@@ -0,0 +1,231 @@
+/*
+  ==============================================================================
+
+    TimeStretchAudioSource.cpp
+    Created: 16 Oct 2026 10:26:14pm
+
+  ==============================================================================
+*/
+
+#include "TimeStretchAudioSource.h"
+
+TimeStretchAudioSource::TimeStretchAudioSource(AudioSource* input, int numberOfChannels)
+    : input(input),
+      numChannels(numberOfChannels) {
+    jassert(input != nullptr);
+}
+
+TimeStretchAudioSource::~TimeStretchAudioSource() {
+}
+
+void TimeStretchAudioSource::prepareToPlay(int samplesPerBlockExpected, double sampleRate) {
+    // About 40ms frames: long enough to hold a couple of periods of bass notes, short enough not to smear transients
+    frameSize = nextPowerOfTwo(roundToInt(sampleRate * 0.04));
+    hopSize = frameSize / 2;
+    searchRadius = frameSize / 4;
+    maxPullSize = jmax(1, samplesPerBlockExpected);
+
+    // A periodic Hann window sums to exactly one at 50% overlap
+    window.allocate(static_cast<size_t>(frameSize), false);
+    for (int i = 0; i < frameSize; ++i)
+        window[i] = 0.5f - 0.5f * std::cos(MathConstants<float>::twoPi * static_cast<float>(i) / static_cast<float>(frameSize));
+
+    // Room for the widest span one frame can need at maxTempo, plus one pull
+    inputCapacity = frameSize * 6 + searchRadius * 4 + maxPullSize;
+    inputBuffer.setSize(numChannels, inputCapacity);
+    monoBuffer.allocate(static_cast<size_t>(inputCapacity), true);
+    overlapBuffer.setSize(numChannels, frameSize);
+
+    input->prepareToPlay(samplesPerBlockExpected, sampleRate);
+    flushBuffers();
+}
+
+void TimeStretchAudioSource::releaseResources() {
+    input->releaseResources();
+
+    inputBuffer.setSize(numChannels, 0);
+    overlapBuffer.setSize(numChannels, 0);
+    monoBuffer.free();
+    window.free();
+    frameSize = 0;
+}
+
+void TimeStretchAudioSource::getNextAudioBlock(const AudioSourceChannelInfo& bufferToFill) {
+    if (frameSize == 0) {
+        bufferToFill.clearActiveBufferRegion();
+        return;
+    }
+
+    auto channelsToFill = jmin(numChannels, bufferToFill.buffer->getNumChannels());
+    int numDone = 0;
+
+    while (numDone < bufferToFill.numSamples) {
+        if (outputReadPos >= hopSize)
+            processFrame();
+
+        auto numThisTime = jmin(hopSize - outputReadPos, bufferToFill.numSamples - numDone);
+
+        for (int chan = 0; chan < channelsToFill; ++chan)
+            bufferToFill.buffer->copyFrom(chan, bufferToFill.startSample + numDone,
+                                          overlapBuffer, chan, outputReadPos, numThisTime);
+
+        outputReadPos += numThisTime;
+        numDone += numThisTime;
+    }
+
+    for (int chan = channelsToFill; chan < bufferToFill.buffer->getNumChannels(); ++chan)
+        bufferToFill.buffer->clear(chan, bufferToFill.startSample, bufferToFill.numSamples);
+}
+
+//==============================================================================
+void TimeStretchAudioSource::setTempo(double newTempo) noexcept {
+    tempo = jlimit(minTempo, maxTempo, newTempo);
+}
+
+double TimeStretchAudioSource::getTempo() const noexcept {
+    return tempo.load();
+}
+
+void TimeStretchAudioSource::flushBuffers() noexcept {
+    bufferStart = 0;
+    bufferEnd = 0;
+    nominalPosition = 0.0;
+    previousFrameStart = 0;
+    isFirstFrame = true;
+
+    overlapBuffer.clear();
+    outputReadPos = hopSize;
+}
+
+int TimeStretchAudioSource::getLatencySamples() const noexcept {
+    return frameSize + hopSize + searchRadius;
+}
+
+//==============================================================================
+void TimeStretchAudioSource::processFrame() {
+    auto nominalStart = static_cast<int64>(std::llround(nominalPosition));
+    int64 frameStart = nominalStart;
+
+    if (isFirstFrame) {
+        ensureInput(frameStart + frameSize);
+    }
+    else {
+        auto naturalStart = previousFrameStart + hopSize;
+        discardInputBefore(jmin(naturalStart, nominalStart - searchRadius));
+        ensureInput(jmax(naturalStart, nominalStart + searchRadius) + frameSize);
+        frameStart = findBestFrameStart(nominalStart, naturalStart);
+    }
+
+    auto offset = static_cast<int>(frameStart - bufferStart);
+
+    for (int chan = 0; chan < numChannels; ++chan) {
+        auto* overlap = overlapBuffer.getWritePointer(chan);
+        const auto* frame = inputBuffer.getReadPointer(chan, offset);
+
+        // The half already output is dropped; the other half waits for this frame's first half
+        std::memmove(overlap, overlap + hopSize, sizeof(float) * static_cast<size_t>(frameSize - hopSize));
+        FloatVectorOperations::clear(overlap + frameSize - hopSize, hopSize);
+
+        if (isFirstFrame) {
+            // Nothing to overlap with yet, so start at full level rather than fading in
+            FloatVectorOperations::copy(overlap, frame, hopSize);
+            FloatVectorOperations::addWithMultiply(overlap + hopSize, frame + hopSize, window + hopSize, frameSize - hopSize);
+        }
+        else {
+            FloatVectorOperations::addWithMultiply(overlap, frame, window, frameSize);
+        }
+    }
+
+    previousFrameStart = frameStart;
+    isFirstFrame = false;
+    nominalPosition += tempo.load() * hopSize;
+    outputReadPos = 0;
+}
+
+void TimeStretchAudioSource::ensureInput(int64 endPosition) {
+    while (bufferEnd < endPosition) {
+        auto offset = static_cast<int>(bufferEnd - bufferStart);
+        auto numToPull = static_cast<int>(jmin(static_cast<int64>(jmin(maxPullSize, inputCapacity - offset)),
+                                               endPosition - bufferEnd));
+
+        if (numToPull <= 0) {
+            jassertfalse; // inputCapacity is too small for the frame geometry
+            return;
+        }
+
+        input->getNextAudioBlock(AudioSourceChannelInfo(&inputBuffer, offset, numToPull));
+
+        // The frame search runs on a mono mix so all channels keep the same alignment
+        auto* mono = monoBuffer.get() + offset;
+        FloatVectorOperations::copy(mono, inputBuffer.getReadPointer(0, offset), numToPull);
+        for (int chan = 1; chan < numChannels; ++chan)
+            FloatVectorOperations::add(mono, inputBuffer.getReadPointer(chan, offset), numToPull);
+
+        bufferEnd += numToPull;
+    }
+}
+
+void TimeStretchAudioSource::discardInputBefore(int64 position) {
+    auto numToDiscard = static_cast<int>(jlimit(static_cast<int64>(0), bufferEnd - bufferStart, position - bufferStart));
+    if (numToDiscard == 0)
+        return;
+
+    auto numToKeep = static_cast<int>(bufferEnd - bufferStart) - numToDiscard;
+
+    for (int chan = 0; chan < numChannels; ++chan) {
+        auto* samples = inputBuffer.getWritePointer(chan);
+        std::memmove(samples, samples + numToDiscard, sizeof(float) * static_cast<size_t>(numToKeep));
+    }
+
+    std::memmove(monoBuffer.get(), monoBuffer.get() + numToDiscard, sizeof(float) * static_cast<size_t>(numToKeep));
+    bufferStart += numToDiscard;
+}
+
+int64 TimeStretchAudioSource::findBestFrameStart(int64 nominalStart, int64 naturalStart) const {
+    constexpr int coarseStride = 4;
+
+    auto lowest = jmax(bufferStart, nominalStart - searchRadius);
+    auto highest = nominalStart + searchRadius;
+    const auto* reference = monoBuffer.get() + (naturalStart - bufferStart);
+
+    auto scoreAt = [&](int64 candidate, int stride) {
+        return correlate(reference, monoBuffer.get() + (candidate - bufferStart), hopSize, stride);
+    };
+
+    // Coarse pass on every fourth offset and sample, then refine around the winner
+    auto best = nominalStart;
+    auto bestScore = std::numeric_limits<float>::lowest();
+
+    for (auto candidate = lowest; candidate <= highest; candidate += coarseStride) {
+        auto score = scoreAt(candidate, coarseStride);
+        if (score > bestScore) {
+            bestScore = score;
+            best = candidate;
+        }
+    }
+
+    auto coarseBest = best;
+    bestScore = std::numeric_limits<float>::lowest();
+
+    for (auto candidate = jmax(lowest, coarseBest - coarseStride + 1); candidate <= jmin(highest, coarseBest + coarseStride - 1); ++candidate) {
+        auto score = scoreAt(candidate, 1);
+        if (score > bestScore) {
+            bestScore = score;
+            best = candidate;
+        }
+    }
+
+    return best;
+}
+
+float TimeStretchAudioSource::correlate(const float* reference, const float* candidate, int numSamples, int stride) noexcept {
+    float product = 0.0f;
+    float energy = 0.0f;
+
+    for (int i = 0; i < numSamples; i += stride) {
+        product += reference[i] * candidate[i];
+        energy += candidate[i] * candidate[i];
+    }
+
+    return product / std::sqrt(energy + 1.0e-9f);
+}
@@ -0,0 +1,117 @@
+/*
+  ==============================================================================
+
+    TimeStretchAudioSource.h
+    Created: 16 Oct 2026 10:26:14pm
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "../JuceLibraryCode/JuceHeader.h"
+
+/**
+ * @class TimeStretchAudioSource
+ * @brief Changes the tempo of its input without changing the pitch (WSOLA)
+ *
+ * Output is built by overlap-adding Hann-windowed frames of the input at a fixed
+ * synthesis hop, while the analysis position advances by the hop times the tempo.
+ * Each frame is nudged within a small search window to the offset whose waveform
+ * best matches the natural continuation of the previous frame, so the overlaps add
+ * up in phase instead of smearing. The match is found on a mono mix, coarse then
+ * fine, so the search costs well under a hundred multiply-adds per output sample.
+ *
+ * Output sample n of a frame corresponds to input sample n of that frame, so the
+ * audible position is simply the nominal analysis position. The input is read ahead
+ * of that by at most getLatencySamples() samples.
+ */
+class TimeStretchAudioSource : public AudioSource {
+public:
+    /** Tempo range supported; the input read per output block grows with the tempo */
+    static constexpr double minTempo = 0.1;
+    static constexpr double maxTempo = 8.0;
+
+    /**
+     * Constructor for TimeStretchAudioSource
+     * @param input The source to read from; it is not owned and must outlive this object
+     * @param numberOfChannels Number of channels to process
+     */
+    TimeStretchAudioSource(AudioSource* input, int numberOfChannels);
+
+    /** Destructor */
+    ~TimeStretchAudioSource() override;
+
+    //==========================================================================
+    // AudioSource overrides
+    //==========================================================================
+
+    /** Sizes the frames for the sample rate and allocates all buffers */
+    void prepareToPlay(int samplesPerBlockExpected, double sampleRate) override;
+
+    /** Frees the buffers */
+    void releaseResources() override;
+
+    /** Produces the next block at the current tempo */
+    void getNextAudioBlock(const AudioSourceChannelInfo& bufferToFill) override;
+
+    //==========================================================================
+    // Tempo
+    //==========================================================================
+
+    /** Sets the tempo ratio, applied from the next frame (1.0 = unchanged) */
+    void setTempo(double newTempo) noexcept;
+
+    /** Gets the tempo ratio */
+    double getTempo() const noexcept;
+
+    /** Drops everything buffered, e.g. after the input has been repositioned */
+    void flushBuffers() noexcept;
+
+    /** Gets how many input samples are read ahead of the sample being output, at most */
+    int getLatencySamples() const noexcept;
+
+private:
+    /** Builds the next synthesis hop of output */
+    void processFrame();
+
+    /** Pulls input until the buffer reaches the given absolute position */
+    void ensureInput(int64 endPosition);
+
+    /** Discards input before the given absolute position */
+    void discardInputBefore(int64 position);
+
+    /** Finds the frame start near nominalStart whose waveform best continues the previous frame */
+    int64 findBestFrameStart(int64 nominalStart, int64 naturalStart) const;
+
+    /** Normalised cross-correlation of two runs of the mono mix */
+    static float correlate(const float* reference, const float* candidate, int numSamples, int stride) noexcept;
+
+    AudioSource* input;
+    int numChannels;
+    int maxPullSize = 0;
+
+    // Frame geometry, scaled with the sample rate
+    int frameSize = 0;
+    int hopSize = 0;
+    int searchRadius = 0;
+    HeapBlock<float> window;
+
+    // Input, in absolute positions counted from the last flush
+    AudioBuffer<float> inputBuffer;
+    HeapBlock<float> monoBuffer;
+    int inputCapacity = 0;
+    int64 bufferStart = 0;
+    int64 bufferEnd = 0;
+
+    // Overlap-add state
+    AudioBuffer<float> overlapBuffer;
+    int outputReadPos = 0;
+    double nominalPosition = 0.0;
+    int64 previousFrameStart = 0;
+    bool isFirstFrame = true;
+
+    std::atomic<double> tempo{1.0};
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(TimeStretchAudioSource)
+};
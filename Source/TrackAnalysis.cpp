@@ -0,0 +1,351 @@
+/*
+  ==============================================================================
+
+    TrackAnalysis.cpp
+    Created: 17 Oct 2026 4:20:33am
+
+  ==============================================================================
+*/
+
+#include "TrackAnalysis.h"
+#include "ContentHashIndex.h"
+#include "TrackLibrary.h"
+
+namespace {
+
+/** Taps per step of the decimation; a Blackman window this long is down 74 dB well before
+    anything above the output Nyquist frequency could fold back under 2.1 kHz, where the key is read */
+constexpr int tapsPerDecimationStep = 12;
+
+/** Cutoff of the anti-aliasing filter as a fraction of the output sample rate */
+constexpr double decimationCutoff = 0.4;
+
+/** Windowed-sinc low-pass for decimating by the given factor, with the channel mix folded into its gain */
+std::vector<float> makeDecimationFilter(int decimation, int numChannels) {
+    if (decimation <= 1)
+        return std::vector<float>(1, 1.0f / static_cast<float>(numChannels));
+
+    auto numTaps = tapsPerDecimationStep * decimation + 1;
+    auto cutoff = decimationCutoff / decimation;
+    auto centre = (numTaps - 1) / 2;
+
+    std::vector<double> taps(static_cast<size_t>(numTaps));
+    double sum = 0.0;
+
+    for (int i = 0; i < numTaps; ++i) {
+        auto x = static_cast<double>(i - centre);
+        auto sinc = i == centre ? 2.0 * cutoff : std::sin(MathConstants<double>::twoPi * cutoff * x) / (MathConstants<double>::pi * x);
+        auto phase = MathConstants<double>::twoPi * i / (numTaps - 1);
+        auto window = 0.42 - 0.5 * std::cos(phase) + 0.08 * std::cos(2.0 * phase);
+
+        taps[static_cast<size_t>(i)] = sinc * window;
+        sum += sinc * window;
+    }
+
+    std::vector<float> filter(taps.size());
+    auto gain = 1.0 / (sum * numChannels);
+
+    for (size_t i = 0; i < taps.size(); ++i)
+        filter[i] = static_cast<float>(taps[i] * gain);
+
+    return filter;
+}
+
+}
+
+//==============================================================================
+AnalysisPool::AnalysisPool()
+    : ThreadPool(ThreadPoolOptions{}.withThreadName("Track analysis")
+                                    .withNumberOfThreads(jlimit(1, 2, SystemStats::getNumCpus() / 2))
+                                    .withDesiredThreadPriority(Thread::Priority::low)),
+      frameWorkers(ThreadPoolOptions{}.withThreadName("Analysis frames")
+                                      .withNumberOfThreads(jmax(1, SystemStats::getNumCpus() - 1))
+                                      .withDesiredThreadPriority(Thread::Priority::low)) {
+}
+
+AnalysisPool::~AnalysisPool() {
+    removeAllJobs(true, 10000);
+}
+
+std::shared_ptr<const TrackAnalysis> AnalysisPool::findResult(const String& contentHash, const File& file) const {
+    {
+        const ScopedLock lock(resultsLock);
+
+        auto found = results.find(contentHash);
+        if (found != results.end())
+            return found->second;
+    }
+
+    if (file == File())
+        return nullptr;
+
+    auto index = library->getIndex();
+    auto trackIndex = index->find(file.getFullPathName());
+    if (trackIndex < 0)
+        return nullptr;
+
+    // The size and time the record was scanned with tell whether the file has been replaced since
+    const auto& record = index->getRecord(trackIndex);
+    if (!record.isAnalysed() || record.fileSize != file.getSize()
+        || record.modificationTime != file.getLastModificationTime().toMilliseconds())
+        return nullptr;
+
+    auto analysis = std::make_shared<TrackAnalysis>();
+    analysis->beatGrid.bpm = record.bpm;
+    analysis->beatGrid.firstBeatSeconds = record.firstBeatSeconds;
+    analysis->key = MusicalKey::fromCode(static_cast<int>(record.key));
+    analysis->loudness.integratedLufs = record.integratedLufs;
+    analysis->loudness.truePeakDb = record.truePeakDb;
+    analysis->loudness.measured = true;
+    return analysis;
+}
+
+void AnalysisPool::storeResult(const String& contentHash, std::shared_ptr<const TrackAnalysis> analysis) {
+    if (contentHash.isEmpty() || analysis == nullptr)
+        return;
+
+    const ScopedLock lock(resultsLock);
+
+    if (results.find(contentHash) == results.end())
+        resultOrder.add(contentHash);
+
+    results[contentHash] = std::move(analysis);
+
+    while (resultOrder.size() > maxResults) {
+        results.erase(resultOrder[0]);
+        resultOrder.remove(0);
+    }
+}
+
+ThreadPool& AnalysisPool::getFrameWorkers() noexcept {
+    return frameWorkers;
+}
+
+//==============================================================================
+/** Runs one track's analysis on the pool, keeping the analyser alive until it is done */
+class TrackAnalyser::Job : public ThreadPoolJob {
+public:
+    explicit Job(std::shared_ptr<TrackAnalyser> analyserToRun)
+        : ThreadPoolJob("Analyse track"),
+          analyser(std::move(analyserToRun)) {
+    }
+
+    JobStatus runJob() override {
+        analyser->analyse([this] { return shouldExit() || analyser->cancelled.load(); });
+        return jobHasFinished;
+    }
+
+private:
+    std::shared_ptr<TrackAnalyser> analyser;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(Job)
+};
+
+/** Decodes a file that isn't on a deck into an analyser, as the loader would */
+class TrackAnalyser::FileJob : public ThreadPoolJob {
+public:
+    FileJob(std::shared_ptr<TrackAnalyser> analyserToFeed, AudioFormatManager& formatManager, const File& file)
+        : ThreadPoolJob("Decode for analysis"),
+          analyser(std::move(analyserToFeed)),
+          formatManager(formatManager),
+          file(file) {
+    }
+
+    JobStatus runJob() override {
+        // A known track is finished as soon as it is identified, and decodeFinished() finishes the rest
+        if (!decode() && !analyser->isFinished())
+            analyser->finish(nullptr);
+
+        return jobHasFinished;
+    }
+
+private:
+    bool decode() {
+        constexpr int decodeChunkSize = 65536;
+
+        if (analyser->cancelled.load())
+            return false;
+
+        std::unique_ptr<AudioFormatReader> reader(formatManager.createReaderFor(file));
+        if (reader == nullptr || reader->lengthInSamples <= 0) {
+            DBG("TrackAnalyser: could not read " + file.getFullPathName());
+            return false;
+        }
+
+        if (!analyser->trackIdentified(contentHashes->getHash(file)))
+            return false;
+
+        auto numChannels = static_cast<int>(reader->numChannels);
+        AudioBuffer<float> chunk(numChannels, decodeChunkSize);
+
+        analyser->decodeStarted(numChannels, reader->sampleRate, reader->lengthInSamples);
+
+        for (int64 start = 0; start < reader->lengthInSamples; start += decodeChunkSize) {
+            if (shouldExit() || analyser->cancelled.load()) {
+                analyser->decodeFinished(false);
+                return true;
+            }
+
+            auto numThisTime = static_cast<int>(jmin(static_cast<int64>(decodeChunkSize), reader->lengthInSamples - start));
+            reader->read(&chunk, 0, numThisTime, start, true, true);
+            analyser->decodedBlock(chunk, numThisTime, start);
+        }
+
+        analyser->decodeFinished(true);
+        return true;
+    }
+
+    std::shared_ptr<TrackAnalyser> analyser;
+    AudioFormatManager& formatManager;
+    File file;
+    SharedResourcePointer<ContentHashIndex> contentHashes;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(FileJob)
+};
+
+//==============================================================================
+TrackAnalyser::TrackAnalyser(AnalysisPool& pool, const File& file)
+    : pool(pool),
+      file(file) {
+}
+
+TrackAnalyser::~TrackAnalyser() {
+}
+
+std::shared_ptr<TrackAnalyser> TrackAnalyser::analyseFile(AnalysisPool& pool, AudioFormatManager& formatManager,
+                                                          const File& file) {
+    auto analyser = std::make_shared<TrackAnalyser>(pool, file);
+    pool.addJob(new FileJob(analyser, formatManager, file), true);
+    return analyser;
+}
+
+bool TrackAnalyser::trackIdentified(const String& hash) {
+    contentHash = hash;
+
+    if (auto known = pool.findResult(hash, file)) {
+        finish(std::move(known));
+        return false;
+    }
+
+    return !cancelled.load();
+}
+
+void TrackAnalyser::decodeStarted(int channels, double sampleRate, int64 lengthInSamples) {
+    numChannels = jmax(1, channels);
+    decimation = jmax(1, roundToInt(sampleRate / BeatDetector::analysisSampleRate));
+    monoSampleRate = sampleRate / decimation;
+
+    monoSamples.clear();
+    monoSamples.reserve(static_cast<size_t>(lengthInSamples / decimation + 1));
+
+    // Zeros stand in for the samples before the start, and each output is centred on its input
+    // sample so onsets keep their times
+    decimationFilter = makeDecimationFilter(decimation, numChannels);
+    auto numHistory = static_cast<int>(decimationFilter.size()) - 1;
+    fullRateMono.assign(static_cast<size_t>(numHistory), 0.0f);
+    nextOutput = numHistory + numHistory / 2;
+
+    loudnessMeter.reset(numChannels, sampleRate);
+}
+
+void TrackAnalyser::decodedBlock(const AudioBuffer<float>& block, int numSamples, int64 startSample) {
+    ignoreUnused(startSample);
+
+    loudnessMeter.process(block, numSamples);
+
+    // Mixed to mono at the full rate, then low-passed before keeping every decimation'th sample,
+    // so nothing above the analysis rate's Nyquist frequency folds into the bands the detectors read
+    auto numHistory = static_cast<int>(decimationFilter.size()) - 1;
+    auto channelsToMix = jmin(numChannels, block.getNumChannels());
+
+    fullRateMono.resize(static_cast<size_t>(numHistory + numSamples));
+    auto* mono = fullRateMono.data() + numHistory;
+    FloatVectorOperations::copy(mono, block.getReadPointer(0), numSamples);
+
+    for (int chan = 1; chan < channelsToMix; ++chan)
+        FloatVectorOperations::add(mono, block.getReadPointer(chan), numSamples);
+
+    const auto* taps = decimationFilter.data();
+    auto numTaps = numHistory + 1;
+
+    for (; nextOutput < numHistory + numSamples; nextOutput += decimation) {
+        const auto* input = fullRateMono.data() + nextOutput - numHistory;
+        float sum = 0.0f;
+
+        for (int i = 0; i < numTaps; ++i)
+            sum += taps[i] * input[i];
+
+        monoSamples.push_back(sum);
+    }
+
+    // Keep the samples the next block's first outputs still reach back to
+    nextOutput -= numSamples;
+    std::copy(fullRateMono.end() - numHistory, fullRateMono.end(), fullRateMono.begin());
+    fullRateMono.resize(static_cast<size_t>(numHistory));
+}
+
+void TrackAnalyser::decodeFinished(bool completed) {
+    if (!completed || cancelled.load()) {
+        finish(nullptr);
+        return;
+    }
+
+    loudness = loudnessMeter.getLoudness();
+    loudnessMeasured.store(true, std::memory_order_release);
+
+    pool.addJob(new Job(shared_from_this()), true);
+}
+
+//==============================================================================
+bool TrackAnalyser::isFinished() const noexcept {
+    return finished.load(std::memory_order_acquire);
+}
+
+std::shared_ptr<const TrackAnalysis> TrackAnalyser::getResult() const {
+    return isFinished() ? result : nullptr;
+}
+
+const TrackAnalysis* TrackAnalyser::getFinishedResult() const noexcept {
+    return isFinished() ? result.get() : nullptr;
+}
+
+Loudness TrackAnalyser::getLoudness() const {
+    if (loudnessMeasured.load(std::memory_order_acquire))
+        return loudness;
+
+    if (auto* analysis = getFinishedResult())
+        return analysis->loudness;
+
+    return {};
+}
+
+void TrackAnalyser::cancel() noexcept {
+    cancelled.store(true);
+}
+
+void TrackAnalyser::analyse(const std::function<bool()>& shouldExit) {
+    auto analysis = std::make_shared<TrackAnalysis>();
+    analysis->beatGrid = BeatDetector::analyse(monoSamples.data(), static_cast<int>(monoSamples.size()),
+                                               monoSampleRate, shouldExit);
+    analysis->key = KeyDetector::analyse(monoSamples.data(), static_cast<int>(monoSamples.size()),
+                                         monoSampleRate, &pool.getFrameWorkers(), shouldExit);
+    analysis->loudness = loudness;
+
+    // The downsampled copy is only needed for the analysis
+    std::vector<float>().swap(monoSamples);
+    std::vector<float>().swap(fullRateMono);
+
+    if (shouldExit()) {
+        finish(nullptr);
+        return;
+    }
+
+    pool.storeResult(contentHash, analysis);
+    finish(std::move(analysis));
+}
+
+void TrackAnalyser::finish(std::shared_ptr<const TrackAnalysis> analysis) {
+    jassert(!isFinished());
+    result = std::move(analysis);
+    finished.store(true, std::memory_order_release);
+}
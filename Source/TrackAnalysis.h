@@ -0,0 +1,187 @@
+/*
+  ==============================================================================
+
+    TrackAnalysis.h
+    Created: 17 Oct 2026 4:20:33am
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include "DecodeSink.h"
+#include "BeatDetector.h"
+#include "KeyDetector.h"
+#include "LoudnessMeter.h"
+
+class TrackLibrary;
+
+/**
+ * @struct TrackAnalysis
+ * @brief What the background analysis has found out about a track
+ */
+struct TrackAnalysis {
+    BeatGrid beatGrid;
+    MusicalKey key;
+    Loudness loudness;
+};
+
+/**
+ * @class AnalysisPool
+ * @brief Bounded, low-priority worker pool shared by every deck's track analysis
+ *
+ * Analysis never competes with the audio or loader threads: the pool has at most
+ * two workers at low priority, so a burst of loads just queues up. Results are
+ * remembered by content hash, so loading a track again doesn't analyse it again,
+ * and the results stored in the track library count too, so neither does a track
+ * analysed in an earlier session.
+ *
+ * Stages that split a track into independent frames share them with a second set
+ * of low-priority frame workers, which only ever run those frames; the job takes
+ * frames too, so a track uses every core.
+ */
+class AnalysisPool : public ThreadPool {
+public:
+    AnalysisPool();
+    ~AnalysisPool() override;
+
+    /**
+     * Gets the analysis of a track seen before, or nullptr
+     * @param contentHash Hash of the track's content, looked up in the results remembered this session
+     * @param file The track's file, if it is one; its library record is used if it holds a full
+     *             analysis and the file hasn't changed since
+     */
+    std::shared_ptr<const TrackAnalysis> findResult(const String& contentHash, const File& file = {}) const;
+
+    /** Remembers the analysis of a track */
+    void storeResult(const String& contentHash, std::shared_ptr<const TrackAnalysis> analysis);
+
+    /** Gets the workers that analysis jobs share their frames with */
+    ThreadPool& getFrameWorkers() noexcept;
+
+private:
+    /** Tracks whose analysis is remembered, beyond which the oldest is forgotten */
+    static constexpr int maxResults = 1000;
+
+    CriticalSection resultsLock;
+    std::map<String, std::shared_ptr<const TrackAnalysis>> results;
+    StringArray resultOrder;
+
+    ThreadPool frameWorkers;
+    SharedResourcePointer<TrackLibrary> library;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(AnalysisPool)
+};
+
+/**
+ * @class TrackAnalyser
+ * @brief Analyses a track from the loader's decode pass, finishing on the analysis pool
+ *
+ * As the loader decodes, the analyser keeps a mono copy downsampled to around
+ * BeatDetector::analysisSampleRate, which costs little next to the decoding and
+ * holds a six-minute track in about 16 MB. Once decoding is complete the copy is
+ * handed to a job on the AnalysisPool, so the load itself is never held up.
+ *
+ * Loudness needs the full-rate signal, so it is measured during the decode pass
+ * itself and is known as soon as decoding has finished, before the track is
+ * published, while the rest of the analysis is still queued.
+ *
+ * The result is polled from the message thread with isFinished(); cancel()
+ * abandons a job still queued or running, e.g. when another track is loaded.
+ * analyseFile() feeds an analyser by decoding a file on the pool itself, for
+ * analysing tracks that aren't loaded, such as a crate in the library.
+ * The result is written once, before the analysis is marked finished, so any
+ * thread that has seen isFinished() return true can read it without locking.
+ */
+class TrackAnalyser : public DecodeSink,
+                      public std::enable_shared_from_this<TrackAnalyser> {
+public:
+    /**
+     * Constructor for TrackAnalyser
+     * @param pool Pool to run the analysis on and remember results in; must outlive any job
+     * @param file The track's file, so results stored in the library can be used; empty if it isn't one
+     */
+    explicit TrackAnalyser(AnalysisPool& pool, const File& file = {});
+
+    ~TrackAnalyser() override;
+
+    /**
+     * Analyses a file without loading it on a deck, decoding it on the analysis pool
+     * @param pool Pool to decode and analyse on; must outlive the jobs
+     * @param formatManager Used to open the file; must outlive the jobs
+     * @param file The audio file to analyse
+     * @return The analyser, to poll and cancel as one fed by the loader
+     */
+    static std::shared_ptr<TrackAnalyser> analyseFile(AnalysisPool& pool, AudioFormatManager& formatManager,
+                                                      const File& file);
+
+    //==========================================================================
+    // DecodeSink overrides (decoding thread)
+    //==========================================================================
+
+    bool trackIdentified(const String& contentHash) override;
+    void decodeStarted(int numChannels, double sampleRate, int64 lengthInSamples) override;
+    void decodedBlock(const AudioBuffer<float>& block, int numSamples, int64 startSample) override;
+    void decodeFinished(bool completed) override;
+
+    //==========================================================================
+    // Results
+    //==========================================================================
+
+    /** Returns true once the analysis has finished, or failed */
+    bool isFinished() const noexcept;
+
+    /** Gets the analysis once isFinished() returns true, or nullptr if it failed */
+    std::shared_ptr<const TrackAnalysis> getResult() const;
+
+    /** Gets the analysis without touching its reference count, e.g. on the audio thread, or nullptr until finished */
+    const TrackAnalysis* getFinishedResult() const noexcept;
+
+    /**
+     * Gets the track's loudness once decoding has finished, or from the remembered
+     * analysis of a track seen before
+     * @return The loudness, or an unmeasured one if it isn't known (yet)
+     */
+    Loudness getLoudness() const;
+
+    /** Abandons the analysis if it hasn't finished */
+    void cancel() noexcept;
+
+private:
+    class Job;
+    class FileJob;
+
+    /** Runs the analysis on the collected samples (analysis pool) */
+    void analyse(const std::function<bool()>& shouldExit);
+
+    /** Publishes the result and marks the analysis finished */
+    void finish(std::shared_ptr<const TrackAnalysis> analysis);
+
+    AnalysisPool& pool;
+    File file;
+    String contentHash;
+
+    // Downsampled mono copy of the track, written only by the decoding thread until the job starts
+    std::vector<float> monoSamples;
+    double monoSampleRate = 0.0;
+    int decimation = 1;
+    int numChannels = 0;
+
+    // Anti-aliasing filter for the decimation, and the full-rate mono samples it runs over
+    std::vector<float> decimationFilter;
+    std::vector<float> fullRateMono;
+    int nextOutput = 0;
+
+    // Measured from the full-rate blocks, and written once before the release store to loudnessMeasured
+    LoudnessMeter loudnessMeter;
+    Loudness loudness;
+    std::atomic<bool> loudnessMeasured{false};
+
+    // Written once by finish(), before the release store to finished
+    std::shared_ptr<const TrackAnalysis> result;
+    std::atomic<bool> finished{false};
+    std::atomic<bool> cancelled{false};
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(TrackAnalyser)
+};
@@ -0,0 +1,619 @@
+/*
+  ==============================================================================
+
+    TrackLibrary.cpp
+    Created: 17 Oct 2026 7:02:15am
+
+  ==============================================================================
+*/
+
+#include "TrackLibrary.h"
+
+namespace {
+
+/** Start of every index file, followed by the format version */
+constexpr char indexMagic[4] = { 'O', 'T', 'L', 'I' };
+constexpr uint32 indexVersion = 2;
+
+/** What precedes the arrays in an index file */
+struct IndexFileHeader {
+    char magic[4];
+    uint32 version;
+    uint32 numTracks;
+    uint32 stringBytes;
+    uint32 searchTextBytes;
+};
+
+// Saved as raw arrays, so the layout is part of the file format
+static_assert(sizeof(LibraryIndex::Record) == 64, "LibraryIndex::Record layout changed; bump indexVersion");
+
+/** Record layout of version 1 indexes, which had no loudness or beat grid start */
+struct RecordVersion1 {
+    uint32 path;
+    uint32 title;
+    uint32 artist;
+    uint32 album;
+    uint32 searchText;
+    float lengthSeconds;
+    float bpm;
+    uint32 key;
+    int64 fileSize;
+    int64 modificationTime;
+};
+
+static_assert(sizeof(RecordVersion1) == 48, "RecordVersion1 must match the version 1 file format");
+
+/** Byte-wise, so the order matches comparing the stored UTF-8 with strcmp */
+bool pathLess(const char* a, const char* b) {
+    return std::strcmp(a, b) < 0;
+}
+
+/** Returns true if a byte can't be part of a word; bytes of multi-byte characters count as letters */
+bool isWordSeparator(char c) {
+    auto byte = static_cast<unsigned char>(c);
+    return byte < 0x80 && !std::isalnum(byte);
+}
+
+/** Finds a query word in a track's search text, preferring a place where it starts a word */
+enum class Match { none, substring, wordPrefix };
+
+Match findWord(std::string_view text, std::string_view word) {
+    auto found = Match::none;
+
+    for (auto position = text.find(word); position != std::string_view::npos; position = text.find(word, position + 1)) {
+        if (position == 0 || isWordSeparator(text[position - 1]))
+            return Match::wordPrefix;
+
+        found = Match::substring;
+    }
+
+    return found;
+}
+
+/** Reads one array from an index file */
+template <typename Element>
+bool readArray(InputStream& in, std::vector<Element>& array, size_t numElements) {
+    array.resize(numElements);
+    auto numBytes = static_cast<int>(numElements * sizeof(Element));
+    return numBytes == 0 || in.read(array.data(), numBytes) == numBytes;
+}
+
+/** Reads the records of an index file of either version */
+bool readRecords(InputStream& in, std::vector<LibraryIndex::Record>& records, size_t numRecords, uint32 version) {
+    if (version == indexVersion)
+        return readArray(in, records, numRecords);
+
+    // Older records are widened, leaving loudness unmeasured so the tracks count as unanalysed
+    std::vector<RecordVersion1> oldRecords;
+    if (!readArray(in, oldRecords, numRecords))
+        return false;
+
+    records.resize(numRecords);
+    for (size_t i = 0; i < numRecords; ++i) {
+        const auto& old = oldRecords[i];
+        auto& record = records[i];
+        record.path = old.path;
+        record.title = old.title;
+        record.artist = old.artist;
+        record.album = old.album;
+        record.searchText = old.searchText;
+        record.lengthSeconds = old.lengthSeconds;
+        record.bpm = old.bpm;
+        record.key = old.key;
+        record.fileSize = old.fileSize;
+        record.modificationTime = old.modificationTime;
+    }
+
+    return true;
+}
+
+} // namespace
+
+//==============================================================================
+LibraryIndex::LibraryIndex() {
+    // Offset zero is the empty string in both pools
+    strings.push_back('\0');
+    searchText.push_back('\0');
+}
+
+std::shared_ptr<const LibraryIndex> LibraryIndex::build(std::vector<LibraryTrack> tracks) {
+    std::sort(tracks.begin(), tracks.end(), [](const LibraryTrack& a, const LibraryTrack& b) {
+        if (auto byArtist = a.artist.compareIgnoreCase(b.artist))
+            return byArtist < 0;
+        if (auto byTitle = a.title.compareIgnoreCase(b.title))
+            return byTitle < 0;
+        return a.path < b.path;
+    });
+
+    auto index = std::make_shared<LibraryIndex>();
+    index->records.reserve(tracks.size());
+
+    for (const auto& track : tracks) {
+        Record record;
+        record.path = addString(index->strings, track.path);
+        record.title = addString(index->strings, track.title);
+        record.artist = addString(index->strings, track.artist);
+        record.album = addString(index->strings, track.album);
+        record.lengthSeconds = static_cast<float>(track.lengthSeconds);
+        record.bpm = track.bpm;
+        record.key = static_cast<uint32>(track.key);
+        record.fileSize = track.fileSize;
+        record.modificationTime = track.modificationTime;
+        record.firstBeatSeconds = static_cast<float>(track.firstBeatSeconds);
+        record.integratedLufs = static_cast<float>(track.loudness.integratedLufs);
+        record.truePeakDb = static_cast<float>(track.loudness.truePeakDb);
+        record.loudnessMeasured = track.loudness.isValid() ? 1u : 0u;
+
+        // Newlines keep a query word from matching across two fields
+        auto fileName = File(track.path).getFileNameWithoutExtension();
+        record.searchText = addString(index->searchText,
+                                      (track.title + "\n" + track.artist + "\n" + track.album + "\n" + fileName).toLowerCase());
+
+        index->records.push_back(record);
+    }
+
+    index->pathOrder.resize(index->records.size());
+    std::iota(index->pathOrder.begin(), index->pathOrder.end(), 0u);
+
+    const auto* pool = index->strings.data();
+    const auto& records = index->records;
+    std::sort(index->pathOrder.begin(), index->pathOrder.end(), [pool, &records](uint32 a, uint32 b) {
+        return pathLess(pool + records[a].path, pool + records[b].path);
+    });
+
+    return index;
+}
+
+std::shared_ptr<const LibraryIndex> LibraryIndex::load(const File& file) {
+    FileInputStream in(file);
+    if (!in.openedOk())
+        return nullptr;
+
+    IndexFileHeader header;
+    if (in.read(&header, sizeof(header)) != static_cast<int>(sizeof(header))
+        || std::memcmp(header.magic, indexMagic, sizeof(indexMagic)) != 0
+        || (header.version != indexVersion && header.version != 1))
+        return nullptr;
+
+    // Guards against a truncated or damaged file before anything is allocated
+    auto recordSize = header.version == indexVersion ? sizeof(Record) : sizeof(RecordVersion1);
+    auto expectedSize = static_cast<int64>(sizeof(header)) + static_cast<int64>(header.numTracks) * (recordSize + sizeof(uint32))
+                      + header.stringBytes + header.searchTextBytes;
+    if (expectedSize != file.getSize() || header.stringBytes == 0 || header.searchTextBytes == 0)
+        return nullptr;
+
+    auto index = std::make_shared<LibraryIndex>();
+    if (!readRecords(in, index->records, header.numTracks, header.version)
+        || !readArray(in, index->pathOrder, header.numTracks)
+        || !readArray(in, index->strings, header.stringBytes)
+        || !readArray(in, index->searchText, header.searchTextBytes))
+        return nullptr;
+
+    // Every offset must land inside its pool, and the pools must end in a terminator
+    if (index->strings.back() != '\0' || index->searchText.back() != '\0')
+        return nullptr;
+
+    for (const auto& record : index->records) {
+        for (auto offset : { record.path, record.title, record.artist, record.album })
+            if (offset >= header.stringBytes)
+                return nullptr;
+
+        if (record.searchText >= header.searchTextBytes)
+            return nullptr;
+    }
+
+    for (auto trackIndex : index->pathOrder)
+        if (trackIndex >= header.numTracks)
+            return nullptr;
+
+    return index;
+}
+
+bool LibraryIndex::save(const File& file) const {
+    file.getParentDirectory().createDirectory();
+
+    // Written next to the index and moved over it, so a crash never leaves half an index
+    TemporaryFile temp(file);
+    {
+        FileOutputStream out(temp.getFile());
+        if (!out.openedOk())
+            return false;
+
+        IndexFileHeader header;
+        std::memcpy(header.magic, indexMagic, sizeof(indexMagic));
+        header.version = indexVersion;
+        header.numTracks = static_cast<uint32>(records.size());
+        header.stringBytes = static_cast<uint32>(strings.size());
+        header.searchTextBytes = static_cast<uint32>(searchText.size());
+
+        if (!out.write(&header, sizeof(header))
+            || !out.write(records.data(), records.size() * sizeof(Record))
+            || !out.write(pathOrder.data(), pathOrder.size() * sizeof(uint32))
+            || !out.write(strings.data(), strings.size())
+            || !out.write(searchText.data(), searchText.size()))
+            return false;
+
+        out.flush();
+        if (out.getStatus().failed())
+            return false;
+    }
+
+    return temp.overwriteTargetFileWithTemporary();
+}
+
+//==============================================================================
+int LibraryIndex::getNumTracks() const noexcept {
+    return static_cast<int>(records.size());
+}
+
+const LibraryIndex::Record& LibraryIndex::getRecord(int index) const noexcept {
+    jassert(isPositiveAndBelow(index, getNumTracks()));
+    return records[static_cast<size_t>(index)];
+}
+
+String LibraryIndex::getString(uint32 offset) const {
+    return String::fromUTF8(strings.data() + offset);
+}
+
+LibraryTrack LibraryIndex::getTrack(int index) const {
+    const auto& record = getRecord(index);
+
+    LibraryTrack track;
+    track.path = getString(record.path);
+    track.title = getString(record.title);
+    track.artist = getString(record.artist);
+    track.album = getString(record.album);
+    track.lengthSeconds = record.lengthSeconds;
+    track.fileSize = record.fileSize;
+    track.modificationTime = record.modificationTime;
+    track.bpm = record.bpm;
+    track.key = static_cast<int>(record.key);
+    track.firstBeatSeconds = record.firstBeatSeconds;
+    track.loudness.integratedLufs = record.integratedLufs;
+    track.loudness.truePeakDb = record.truePeakDb;
+    track.loudness.measured = record.loudnessMeasured != 0;
+    return track;
+}
+
+std::vector<LibraryTrack> LibraryIndex::getAllTracks() const {
+    std::vector<LibraryTrack> tracks;
+    tracks.reserve(records.size());
+
+    for (int i = 0; i < getNumTracks(); ++i)
+        tracks.push_back(getTrack(i));
+
+    return tracks;
+}
+
+int LibraryIndex::find(const String& path) const {
+    const auto* key = path.toRawUTF8();
+    const auto* pool = strings.data();
+
+    auto found = std::lower_bound(pathOrder.begin(), pathOrder.end(), key, [this, pool](uint32 trackIndex, const char* wanted) {
+        return pathLess(pool + records[trackIndex].path, wanted);
+    });
+
+    if (found != pathOrder.end() && std::strcmp(pool + records[*found].path, key) == 0)
+        return static_cast<int>(*found);
+
+    return -1;
+}
+
+std::shared_ptr<const LibraryIndex> LibraryIndex::withAnalysis(const std::vector<std::pair<int, const TrackAnalysis*>>& updates) const {
+    // Only numbers change, so the pools and path order are copied as they are
+    auto copy = std::make_shared<LibraryIndex>();
+    copy->records = records;
+    copy->pathOrder = pathOrder;
+    copy->strings = strings;
+    copy->searchText = searchText;
+
+    for (const auto& [index, analysis] : updates) {
+        if (analysis == nullptr || !isPositiveAndBelow(index, getNumTracks()))
+            continue;
+
+        auto& record = copy->records[static_cast<size_t>(index)];
+
+        if (analysis->beatGrid.isValid()) {
+            record.bpm = static_cast<float>(analysis->beatGrid.bpm);
+            record.firstBeatSeconds = static_cast<float>(analysis->beatGrid.firstBeatSeconds);
+        }
+        if (analysis->key.isValid())
+            record.key = static_cast<uint32>(analysis->key.getCode());
+        if (analysis->loudness.isValid()) {
+            record.integratedLufs = static_cast<float>(analysis->loudness.integratedLufs);
+            record.truePeakDb = static_cast<float>(analysis->loudness.truePeakDb);
+            record.loudnessMeasured = 1;
+        }
+    }
+
+    return copy;
+}
+
+//==============================================================================
+std::vector<int> LibraryIndex::search(const String& query, int maxResults) const {
+    auto limit = maxResults < 0 ? records.size() : static_cast<size_t>(maxResults);
+
+    auto words = StringArray::fromTokens(query.toLowerCase(), true);
+    words.removeEmptyStrings();
+
+    if (words.isEmpty()) {
+        std::vector<int> all(jmin(limit, records.size()));
+        std::iota(all.begin(), all.end(), 0);
+        return all;
+    }
+
+    std::vector<std::string> wordBytes;
+    for (const auto& word : words)
+        wordBytes.emplace_back(word.toRawUTF8());
+
+    // The longest word is the rarest, and lets the scan skip furthest
+    std::sort(wordBytes.begin(), wordBytes.end(), [](const std::string& a, const std::string& b) {
+        return a.size() > b.size();
+    });
+
+    std::vector<int> prefixMatches;
+    std::vector<int> substringMatches;
+
+    // The library's find skips ahead with memchr on the first byte, faster than a skip table for short words
+    std::string_view text(searchText.data(), searchText.size());
+    auto trackIndex = -1;
+
+    for (size_t position = 0; prefixMatches.size() < limit;) {
+        auto hit = text.find(wordBytes.front(), position);
+        if (hit == std::string_view::npos)
+            break;
+
+        trackIndex = getTrackAtSearchOffset(hit, trackIndex + 1);
+        auto trackStart = static_cast<size_t>(records[static_cast<size_t>(trackIndex)].searchText);
+        auto trackEnd = trackIndex + 1 < getNumTracks() ? static_cast<size_t>(records[static_cast<size_t>(trackIndex + 1)].searchText) - 1
+                                                         : text.size() - 1;
+        auto track = text.substr(trackStart, trackEnd - trackStart);
+
+        auto match = Match::wordPrefix;
+        for (const auto& word : wordBytes) {
+            match = jmin(match, findWord(track, word));
+            if (match == Match::none)
+                break;
+        }
+
+        if (match == Match::wordPrefix)
+            prefixMatches.push_back(trackIndex);
+        else if (match == Match::substring)
+            substringMatches.push_back(trackIndex);
+
+        // Each track counts once, however often the word appears in it
+        position = trackEnd + 1;
+    }
+
+    prefixMatches.insert(prefixMatches.end(), substringMatches.begin(), substringMatches.end());
+    if (prefixMatches.size() > limit)
+        prefixMatches.resize(limit);
+
+    return prefixMatches;
+}
+
+int LibraryIndex::getTrackAtSearchOffset(size_t offset, int firstTrack) const noexcept {
+    // Search text is laid out in track order, so the offsets are sorted. Hits come in order too,
+    // so gallop forward from the last hit's track before bisecting
+    auto numTracks = records.size();
+    auto low = static_cast<size_t>(firstTrack);
+    auto bound = low;
+
+    for (size_t step = 1; bound < numTracks && records[bound].searchText <= offset; step *= 2) {
+        low = bound;
+        bound += step;
+    }
+
+    auto found = std::upper_bound(records.begin() + static_cast<std::ptrdiff_t>(low),
+                                  records.begin() + static_cast<std::ptrdiff_t>(jmin(bound, numTracks)),
+                                  offset, [](size_t wanted, const Record& record) {
+                                      return wanted < record.searchText;
+                                  });
+
+    return static_cast<int>(std::distance(records.begin(), found)) - 1;
+}
+
+uint32 LibraryIndex::addString(std::vector<char>& pool, const String& text) {
+    if (text.isEmpty())
+        return 0;
+
+    auto offset = static_cast<uint32>(pool.size());
+    const auto* utf8 = text.toRawUTF8();
+    pool.insert(pool.end(), utf8, utf8 + std::strlen(utf8) + 1);
+    return offset;
+}
+
+//==============================================================================
+TrackLibrary::TrackLibrary()
+    : TrackLibrary(File::getSpecialLocation(File::userApplicationDataDirectory)
+                       .getChildFile("OtoDecks")
+                       .getChildFile("Library.index")) {
+}
+
+TrackLibrary::TrackLibrary(const File& indexFile)
+    : indexFile(indexFile),
+      foldersFile(indexFile.getSiblingFile(indexFile.getFileNameWithoutExtension() + "Folders.xml")) {
+    index = LibraryIndex::load(indexFile);
+
+    if (index == nullptr) {
+        if (indexFile.existsAsFile())
+            DBG("TrackLibrary: could not read " + indexFile.getFullPathName() + ", starting empty");
+
+        index = std::make_shared<const LibraryIndex>();
+    }
+
+    if (auto root = parseXMLIfTagMatches(foldersFile, "LIBRARY_FOLDERS"))
+        for (auto* e : root->getChildWithTagNameIterator("FOLDER"))
+            folders.add(File(e->getStringAttribute("path")));
+}
+
+TrackLibrary::~TrackLibrary() {
+    save();
+}
+
+std::shared_ptr<const LibraryIndex> TrackLibrary::getIndex() const {
+    const ScopedLock sl(lock);
+    return index;
+}
+
+void TrackLibrary::addOrUpdate(const std::vector<LibraryTrack>& tracks) {
+    if (tracks.empty())
+        return;
+
+    const ScopedLock sl(writeLock);
+    auto current = getIndex();
+
+    std::map<String, LibraryTrack> byPath;
+    for (auto& track : current->getAllTracks())
+        byPath[track.path] = std::move(track);
+
+    for (const auto& track : tracks) {
+        // A rescan doesn't know the analysis, so keep what was found before
+        auto& entry = byPath[track.path];
+        auto previous = entry;
+        entry = track;
+        if (entry.bpm <= 0.0f) {
+            entry.bpm = previous.bpm;
+            entry.firstBeatSeconds = previous.firstBeatSeconds;
+        }
+        if (entry.key == 0)
+            entry.key = previous.key;
+        if (!entry.loudness.isValid())
+            entry.loudness = previous.loudness;
+    }
+
+    std::vector<LibraryTrack> merged;
+    merged.reserve(byPath.size());
+    for (auto& [path, track] : byPath)
+        merged.push_back(std::move(track));
+
+    setIndex(LibraryIndex::build(std::move(merged)));
+}
+
+void TrackLibrary::remove(const StringArray& paths) {
+    if (paths.isEmpty())
+        return;
+
+    const ScopedLock sl(writeLock);
+    auto tracks = getIndex()->getAllTracks();
+    auto sizeBefore = tracks.size();
+
+    std::set<String> toRemove(paths.begin(), paths.end());
+    tracks.erase(std::remove_if(tracks.begin(), tracks.end(), [&toRemove](const LibraryTrack& track) {
+        return toRemove.count(track.path) > 0;
+    }), tracks.end());
+
+    if (tracks.size() != sizeBefore)
+        setIndex(LibraryIndex::build(std::move(tracks)));
+}
+
+int TrackLibrary::updateAnalysis(const std::vector<AnalysisUpdate>& updates) {
+    const ScopedLock sl(writeLock);
+    auto current = getIndex();
+
+    // Copying the index is the cost, so a whole batch goes into one copy
+    std::vector<std::pair<int, const TrackAnalysis*>> found;
+    found.reserve(updates.size());
+
+    for (const auto& [file, analysis] : updates) {
+        auto trackIndex = current->find(file.getFullPathName());
+        if (trackIndex >= 0 && analysis != nullptr)
+            found.emplace_back(trackIndex, analysis.get());
+    }
+
+    if (!found.empty())
+        setIndex(current->withAnalysis(found));
+
+    return static_cast<int>(found.size());
+}
+
+void TrackLibrary::save() {
+    const ScopedLock sl(writeLock);
+
+    if (!unsavedChanges)
+        return;
+
+    if (getIndex()->save(indexFile))
+        unsavedChanges = false;
+    else
+        DBG("TrackLibrary: could not write " + indexFile.getFullPathName());
+}
+
+Array<File> TrackLibrary::getFolders() const {
+    const ScopedLock sl(lock);
+    return folders;
+}
+
+void TrackLibrary::addFolder(const File& folder) {
+    const ScopedLock sl(writeLock);
+
+    for (const auto& existing : getFolders())
+        if (folder == existing || folder.isAChildOf(existing))
+            return;
+
+    {
+        const ScopedLock sl2(lock);
+
+        // A new parent folder covers the ones below it
+        folders.removeIf([&folder](const File& existing) { return existing.isAChildOf(folder); });
+        folders.add(folder);
+    }
+
+    saveFolders();
+}
+
+void TrackLibrary::saveFolders() const {
+    XmlElement root("LIBRARY_FOLDERS");
+
+    for (const auto& folder : getFolders())
+        root.createNewChildElement("FOLDER")->setAttribute("path", folder.getFullPathName());
+
+    indexFile.getParentDirectory().createDirectory();
+
+    if (!root.writeTo(foldersFile))
+        DBG("TrackLibrary: could not write " + foldersFile.getFullPathName());
+}
+
+bool TrackLibrary::readTrackInfo(const File& file, AudioFormatManager& formatManager, LibraryTrack& track) {
+    // Creating a reader parses the header and tags only; no audio is decoded
+    std::unique_ptr<AudioFormatReader> reader(formatManager.createReaderFor(file));
+    if (reader == nullptr || reader->sampleRate <= 0.0)
+        return false;
+
+    auto tag = [&reader](std::initializer_list<const char*> keys) {
+        for (const auto* key : keys) {
+            auto value = reader->metadataValues.getValue(key, {}).trim();
+            if (value.isNotEmpty())
+                return value;
+        }
+        return String();
+    };
+
+    track.path = file.getFullPathName();
+    track.title = tag({ "title", "TITLE", "INAM", "id3title" });
+    track.artist = tag({ "artist", "ARTIST", "IART", "id3artist" });
+    track.album = tag({ "album", "ALBUM", "IPRD", "id3album" });
+    track.lengthSeconds = static_cast<double>(reader->lengthInSamples) / reader->sampleRate;
+    track.fileSize = file.getSize();
+    track.modificationTime = file.getLastModificationTime().toMilliseconds();
+
+    if (track.title.isEmpty()) {
+        auto name = file.getFileNameWithoutExtension();
+        track.title = name.contains(" - ") ? name.fromFirstOccurrenceOf(" - ", false, false).trim() : name;
+
+        if (track.artist.isEmpty() && name.contains(" - "))
+            track.artist = name.upToFirstOccurrenceOf(" - ", false, false).trim();
+    }
+
+    return true;
+}
+
+void TrackLibrary::setIndex(std::shared_ptr<const LibraryIndex> newIndex) {
+    {
+        const ScopedLock sl(lock);
+        index = std::move(newIndex);
+    }
+
+    unsavedChanges = true;
+    sendChangeMessage();
+}
@@ -0,0 +1,211 @@
+/*
+  ==============================================================================
+
+    TrackLibrary.h
+    Created: 17 Oct 2026 7:02:15am
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include "TrackAnalysis.h"
+
+/**
+ * @struct LibraryTrack
+ * @brief One track's metadata and analysis, as added to or read from the library
+ */
+struct LibraryTrack {
+    String path;
+    String title;
+    String artist;
+    String album;
+    double lengthSeconds = 0.0;
+    int64 fileSize = 0;
+    int64 modificationTime = 0;
+    float bpm = 0.0f;   /**< 0 until the track has been analysed */
+    int key = 0;        /**< MusicalKey::getCode(), 0 until the track has been analysed */
+    double firstBeatSeconds = 0.0;  /**< Start of the beat grid, if bpm is known */
+    Loudness loudness;  /**< Unmeasured until the track has been analysed */
+};
+
+/**
+ * @class LibraryIndex
+ * @brief Immutable, compact index of every track in the library, with text search
+ *
+ * Tracks are stored as fixed-size records pointing into one pool of UTF-8 strings,
+ * sorted by artist and title, so the whole index is a handful of flat arrays. It is
+ * saved and loaded as those arrays, with no per-track parsing, and a list view only
+ * touches the records of the rows it draws.
+ *
+ * Search runs over a second pool holding each track's title, artist, album and file
+ * name, lower-cased, one track after another. The longest query word is found with a
+ * single scan over the whole pool and the other words are only checked in the tracks
+ * it hits, which takes a few milliseconds for tens of thousands of tracks.
+ *
+ * An index never changes once built: the TrackLibrary swaps in a new one, so readers
+ * can hold on to a snapshot, and row numbers from a search stay valid with it.
+ */
+class LibraryIndex {
+public:
+    /** A track as stored in the index; offsets point into the string pools */
+    struct Record {
+        uint32 path = 0;
+        uint32 title = 0;
+        uint32 artist = 0;
+        uint32 album = 0;
+        uint32 searchText = 0;
+        float lengthSeconds = 0.0f;
+        float bpm = 0.0f;
+        uint32 key = 0;     // Unused and so 0 in the first indexes written, which reads as an unknown key
+        int64 fileSize = 0;
+        int64 modificationTime = 0;
+        float firstBeatSeconds = 0.0f;
+        float integratedLufs = 0.0f;
+        float truePeakDb = 0.0f;
+        uint32 loudnessMeasured = 0;    // 1 once integratedLufs and truePeakDb hold a measurement
+
+        /** Returns true if the record holds a full analysis: tempo, key and loudness */
+        bool isAnalysed() const noexcept { return bpm > 0.0f && key != 0 && loudnessMeasured != 0; }
+    };
+
+    /** Creates an empty index */
+    LibraryIndex();
+
+    /** Builds an index from a list of tracks, sorted by artist then title */
+    static std::shared_ptr<const LibraryIndex> build(std::vector<LibraryTrack> tracks);
+
+    /** Loads an index written by save(), or returns nullptr if the file is missing or damaged */
+    static std::shared_ptr<const LibraryIndex> load(const File& file);
+
+    /** Writes the index to a file */
+    bool save(const File& file) const;
+
+    //==========================================================================
+    // Tracks
+    //==========================================================================
+
+    /** Gets the number of tracks */
+    int getNumTracks() const noexcept;
+
+    /** Gets a track's record, e.g. to draw its row */
+    const Record& getRecord(int index) const noexcept;
+
+    /** Gets one of a record's strings */
+    String getString(uint32 offset) const;
+
+    /** Gets everything stored about a track */
+    LibraryTrack getTrack(int index) const;
+
+    /** Gets every track, e.g. to build a changed index */
+    std::vector<LibraryTrack> getAllTracks() const;
+
+    /** Finds a track by its full path, returning its index or -1 */
+    int find(const String& path) const;
+
+    /** Returns a copy of the index with some tracks' analysis results replaced, given by track index */
+    std::shared_ptr<const LibraryIndex> withAnalysis(const std::vector<std::pair<int, const TrackAnalysis*>>& updates) const;
+
+    //==========================================================================
+    // Search
+    //==========================================================================
+
+    /**
+     * Finds the tracks whose title, artist, album or file name contain every word of a query
+     * Tracks where each word starts a word of the text (a prefix match) come first, then
+     * tracks that only contain the words; each group is in index order.
+     * @param query Words separated by spaces, matched without regard to case
+     * @param maxResults Most results to return, or -1 for all
+     * @return Track indices; every track for an empty query
+     */
+    std::vector<int> search(const String& query, int maxResults = -1) const;
+
+private:
+    /** Finds the track whose search text contains the given offset, starting from a track at or before it */
+    int getTrackAtSearchOffset(size_t offset, int firstTrack) const noexcept;
+
+    /** Adds a string to a pool, returning its offset */
+    static uint32 addString(std::vector<char>& pool, const String& text);
+
+    std::vector<Record> records;
+    std::vector<uint32> pathOrder;
+    std::vector<char> strings;
+    std::vector<char> searchText;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(LibraryIndex)
+};
+
+/**
+ * @class TrackLibrary
+ * @brief The user's track library, shared by the whole app
+ *
+ * Holds the current LibraryIndex and replaces it whenever tracks are added, removed or
+ * analysed; listeners get a change message each time. The index is kept in the
+ * application data folder and loaded on startup, along with the list of folders the
+ * library is scanned from. Hold it through a SharedResourcePointer; it is safe to use
+ * from several threads.
+ */
+class TrackLibrary : public ChangeBroadcaster {
+public:
+    /** Opens the app's library */
+    TrackLibrary();
+
+    /** Opens a library kept in another file, e.g. for tools and benchmarks */
+    explicit TrackLibrary(const File& indexFile);
+
+    ~TrackLibrary() override;
+
+    /** Gets the current index; it stays valid however the library changes afterwards */
+    std::shared_ptr<const LibraryIndex> getIndex() const;
+
+    /** Adds tracks, replacing any already in the library with the same path */
+    void addOrUpdate(const std::vector<LibraryTrack>& tracks);
+
+    /** Removes tracks by path */
+    void remove(const StringArray& paths);
+
+    /** A track's file and the analysis results found for it */
+    using AnalysisUpdate = std::pair<File, std::shared_ptr<const TrackAnalysis>>;
+
+    /**
+     * Stores analysis results for the tracks that are in the library, as one change
+     * @return the number of tracks updated
+     */
+    int updateAnalysis(const std::vector<AnalysisUpdate>& updates);
+
+    /** Writes the index to disk if it has changed */
+    void save();
+
+    /** Gets the folders the library is scanned from */
+    Array<File> getFolders() const;
+
+    /** Adds a folder to scan from, if it isn't already covered by one */
+    void addFolder(const File& folder);
+
+    /**
+     * Reads a file's metadata from its header and tags, without decoding any audio
+     * Tracks without title tags are named after the file, split at " - " into artist and title.
+     * @return false if no format can read the file
+     */
+    static bool readTrackInfo(const File& file, AudioFormatManager& formatManager, LibraryTrack& track);
+
+private:
+    /** Makes a new index current and tells the listeners */
+    void setIndex(std::shared_ptr<const LibraryIndex> newIndex);
+
+    /** Writes the folder list next to the index */
+    void saveFolders() const;
+
+    File indexFile;
+    File foldersFile;
+
+    // Changes are built one at a time under writeLock; lock only guards swapping the index and reading the folders
+    CriticalSection writeLock;
+    mutable CriticalSection lock;
+    std::shared_ptr<const LibraryIndex> index;
+    bool unsavedChanges = false;
+    Array<File> folders;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(TrackLibrary)
+};
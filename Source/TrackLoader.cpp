@@ -0,0 +1,279 @@
+/*
+  ==============================================================================
+
+    TrackLoader.cpp
+    Created: 16 Oct 2026 11:05:47am
+
+  ==============================================================================
+*/
+
+#include "TrackLoader.h"
+
+//==============================================================================
+LoadedTrack::~LoadedTrack() {
+    transport.setSource(nullptr);
+}
+
+//==============================================================================
+TrackLoaderPool::TrackLoaderPool()
+    : ThreadPool(ThreadPoolOptions{}.withThreadName("Track loader")
+                                    .withNumberOfThreads(2)) {
+}
+
+TrackLoaderPool::~TrackLoaderPool() {
+    removeAllJobs(true, 10000);
+}
+
+//==============================================================================
+TrackDecodePool::TrackDecodePool()
+    : ThreadPool(ThreadPoolOptions{}.withThreadName("Track decode")
+                                    .withNumberOfThreads(2)
+                                    .withDesiredThreadPriority(Thread::Priority::low)) {
+}
+
+TrackDecodePool::~TrackDecodePool() {
+    removeAllJobs(true, 10000);
+}
+
+//==============================================================================
+TrackDecodeJob::TrackDecodeJob(std::unique_ptr<AudioFormatReader> reader,
+                               std::unique_ptr<PcmCache::EntryWriter> cacheEntry,
+                               const Array<std::shared_ptr<DecodeSink>>& sinks)
+    : ThreadPoolJob("Decode"),
+      reader(std::move(reader)),
+      cacheEntry(std::move(cacheEntry)),
+      sinks(sinks) {
+}
+
+ThreadPoolJob::JobStatus TrackDecodeJob::runJob() {
+    decode(*reader, nullptr, cacheEntry, sinks, [this] { return shouldExit(); }, nullptr);
+    return jobHasFinished;
+}
+
+bool TrackDecodeJob::decode(AudioFormatReader& reader,
+                            AudioBuffer<float>* destination,
+                            std::unique_ptr<PcmCache::EntryWriter>& cacheEntry,
+                            const Array<std::shared_ptr<DecodeSink>>& sinks,
+                            const std::function<bool()>& shouldStop,
+                            const std::function<void(double)>& onProgress) {
+    constexpr int decodeChunkSize = 65536;
+
+    auto numChannels = static_cast<int>(reader.numChannels);
+    auto lengthInSamples = reader.lengthInSamples;
+
+    AudioBuffer<float> chunk;
+    if (destination == nullptr)
+        chunk.setSize(numChannels, decodeChunkSize);
+
+    for (auto& sink : sinks)
+        sink->decodeStarted(numChannels, reader.sampleRate, lengthInSamples);
+
+    for (int64 start = 0; start < lengthInSamples; start += decodeChunkSize) {
+        if (shouldStop()) {
+            for (auto& sink : sinks)
+                sink->decodeFinished(false);
+            return false;
+        }
+
+        auto numThisTime = static_cast<int>(jmin(static_cast<int64>(decodeChunkSize), lengthInSamples - start));
+
+        // With a destination the reader decodes straight into it and the sinks see a view of it
+        AudioBuffer<float> block;
+        if (destination != nullptr) {
+            block.setDataToReferTo(destination->getArrayOfWritePointers(), numChannels,
+                                   static_cast<int>(start), numThisTime);
+        }
+        else {
+            block.setDataToReferTo(chunk.getArrayOfWritePointers(), numChannels, 0, numThisTime);
+        }
+
+        reader.read(&block, 0, numThisTime, start, true, true);
+
+        if (destination != nullptr && numChannels == 1 && destination->getNumChannels() > 1)
+            destination->copyFrom(1, static_cast<int>(start), *destination, 0, static_cast<int>(start), numThisTime);
+
+        if (cacheEntry != nullptr && !cacheEntry->write(block, numThisTime)) {
+            DBG("TrackDecodeJob: could not write a PCM cache entry");
+            cacheEntry.reset();
+        }
+
+        for (auto& sink : sinks)
+            sink->decodedBlock(block, numThisTime, start);
+
+        if (onProgress != nullptr)
+            onProgress(static_cast<double>(start + numThisTime) / static_cast<double>(lengthInSamples));
+    }
+
+    if (cacheEntry != nullptr && !cacheEntry->commit())
+        DBG("TrackDecodeJob: could not commit a PCM cache entry");
+
+    for (auto& sink : sinks)
+        sink->decodeFinished(true);
+
+    return true;
+}
+
+//==============================================================================
+TrackLoadJob::TrackLoadJob(const URL& url,
+                           AudioFormatManager& formatManager,
+                           const TrackLoadSettings& settings,
+                           const Array<std::shared_ptr<DecodeSink>>& sinks)
+    : ThreadPoolJob("Load " + url.getFileName()),
+      url(url),
+      formatManager(formatManager),
+      settings(settings),
+      sinks(sinks) {
+}
+
+ThreadPoolJob::JobStatus TrackLoadJob::runJob() {
+    result = loadTrack();
+    progress = 1.0;
+    return jobHasFinished;
+}
+
+double TrackLoadJob::getProgress() const noexcept {
+    return progress.load();
+}
+
+std::unique_ptr<LoadedTrack> TrackLoadJob::takeResult() {
+    return std::move(result);
+}
+
+const URL& TrackLoadJob::getURL() const noexcept {
+    return url;
+}
+
+std::unique_ptr<AudioFormatReader> TrackLoadJob::openReader(bool usePcmCache, bool& fromPcmCache) {
+    std::unique_ptr<AudioFormatReader> reader;
+
+    if (usePcmCache)
+        reader = pcmCache->openReader(url.getLocalFile());
+
+    fromPcmCache = reader != nullptr;
+
+    if (reader == nullptr) {
+        auto stream = url.createInputStream(false);
+        if (stream == nullptr || shouldExit()) {
+            DBG("TrackLoadJob: could not open " + url.toString(false));
+            return nullptr;
+        }
+
+        reader.reset(formatManager.createReaderFor(std::move(stream)));
+    }
+
+    if (reader == nullptr)
+        DBG("TrackLoadJob: no reader for " + url.toString(false));
+
+    return reader;
+}
+
+std::unique_ptr<LoadedTrack> TrackLoadJob::loadTrack() {
+    auto usePcmCache = settings.usePcmCache && url.isLocalFile();
+    auto fromPcmCache = false;
+    auto reader = openReader(usePcmCache, fromPcmCache);
+
+    if (reader == nullptr || shouldExit())
+        return nullptr;
+
+    progress = 0.2;
+
+    auto track = std::make_unique<LoadedTrack>();
+    track->url = url;
+    track->sampleRate = reader->sampleRate;
+    track->lengthInSamples = reader->lengthInSamples;
+    track->numChannels = static_cast<int>(reader->numChannels);
+    track->fromPcmCache = fromPcmCache;
+
+    // The PCM cache lookup above has already hashed the file, so this is normally an index hit
+    if (url.isLocalFile())
+        track->contentHash = contentHashes->getHash(url.getLocalFile());
+
+    // Sinks that already have what they need for this content (e.g. a cached waveform) drop out
+    sinks.removeIf([&track](const std::shared_ptr<DecodeSink>& sink) {
+        return !sink->trackIdentified(track->contentHash);
+    });
+
+    std::unique_ptr<PcmCache::EntryWriter> cacheEntry;
+    if (usePcmCache && !fromPcmCache)
+        cacheEntry = pcmCache->createEntryWriter(url.getLocalFile(), *reader);
+
+    auto inMemory = settings.decodeToMemory && reserveMemory(*track);
+
+    if (inMemory) {
+        auto decoded = TrackDecodeJob::decode(*reader, &track->decodedAudio, cacheEntry, sinks,
+                                              [this] { return shouldExit(); },
+                                              [this](double proportion) { progress = 0.2 + 0.7 * proportion; });
+        if (!decoded)
+            return nullptr;
+    }
+    else if (cacheEntry != nullptr || !sinks.isEmpty()) {
+        // The deck streams from its reader straight away, and the pass runs behind it on another
+        auto decodeFromCache = false;
+        if (auto decodeReader = openReader(fromPcmCache, decodeFromCache)) {
+            decodePool->addJob(new TrackDecodeJob(std::move(decodeReader), std::move(cacheEntry), sinks), true);
+        }
+        else {
+            for (auto& sink : sinks)
+                sink->decodeFinished(false);
+        }
+    }
+
+    // No sample rate is passed to the transport: the deck converts the rate in the same pass as the speed
+    if (inMemory) {
+        // Everything is in RAM now, so the file handle isn't needed any more
+        reader.reset();
+        track->memorySource = std::make_unique<MemoryAudioSource>(track->decodedAudio, false);
+        track->transport.setSource(track->memorySource.get());
+    }
+    else {
+        track->readerSource = std::make_unique<AudioFormatReaderSource>(reader.release(), true);
+
+        if (settings.readAheadSamples > 0) {
+            track->bufferedSource = std::make_unique<ReadAheadAudioSource>(track->readerSource.get(),
+                                                                           *readAheadThread,
+                                                                           settings.readAheadSamples,
+                                                                           track->numChannels);
+            track->transport.setSource(track->bufferedSource.get());
+        }
+        else {
+            track->transport.setSource(track->readerSource.get());
+        }
+    }
+
+    if (shouldExit())
+        return nullptr;
+
+    // Preparing here also prefills the read-ahead buffer, so the first block after the swap is ready
+    if (settings.sampleRate > 0.0)
+        track->transport.prepareToPlay(settings.blockSize, settings.sampleRate);
+
+    // The deck starts and stops by ramping its own gate, so the transport just runs
+    track->transport.start();
+
+    if (shouldExit())
+        return nullptr;
+
+    return track;
+}
+
+bool TrackLoadJob::reserveMemory(LoadedTrack& track) {
+    if (track.lengthInSamples <= 0 || track.lengthInSamples > std::numeric_limits<int>::max()) {
+        DBG("TrackLoadJob: " + url.getFileName() + " is too long to decode into memory, streaming instead");
+        return false;
+    }
+
+    // A mono track is held as stereo, since MemoryAudioSource leaves output channels it doesn't have silent
+    auto numChannels = jmax(2, track.numChannels);
+    auto numSamples = static_cast<int>(track.lengthInSamples);
+    auto numBytes = static_cast<size_t>(numChannels) * static_cast<size_t>(numSamples) * sizeof(float);
+
+    auto reservation = memoryBudget->tryReserve(numBytes);
+    if (!reservation.isValid()) {
+        DBG("TrackLoadJob: memory budget exceeded by " + url.getFileName() + ", streaming instead");
+        return false;
+    }
+
+    track.decodedAudio.setSize(numChannels, numSamples);
+    track.memoryReservation = std::move(reservation);
+    return true;
+}
@@ -0,0 +1,220 @@
+/*
+  ==============================================================================
+
+    TrackLoader.h
+    Created: 16 Oct 2026 11:05:47am
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include "ReadAheadAudioSource.h"
+#include "TrackMemoryBudget.h"
+#include "PcmCache.h"
+#include "DecodeSink.h"
+
+class TrackAnalyser;
+
+/**
+ * @struct LoadedTrack
+ * @brief Everything a deck needs to play one file, built off the message thread
+ *
+ * A LoadedTrack is opened, probed and prepared by a TrackLoadJob and then handed
+ * to the audio thread in one pointer swap. Its transport is already running; the
+ * deck decides whether it is heard. The transport plays at the file's sample rate
+ * and its positions are in file samples; the deck converts to the device rate.
+ *
+ * The transport plays either from the streaming read-ahead source or, for decks
+ * in memory mode, from a fully decoded planar buffer. Either way the reader may be
+ * a memory-mapped view of the PCM cache instead of the original file.
+ *
+ * The deck attaches the track's analyser before publishing it, so the audio thread
+ * can read the beat grid once the analysis has finished. The deck fixes the track's
+ * auto-gain before handing it over if the loudness is known by then, and otherwise
+ * as soon as the decode pass behind the streaming track has measured it.
+ */
+struct LoadedTrack {
+    LoadedTrack() = default;
+    ~LoadedTrack();
+
+    URL url;
+    double sampleRate = 0.0;
+    int64 lengthInSamples = 0;
+    int numChannels = 0;
+    String contentHash;
+    bool fromPcmCache = false;
+
+    /** Returns true if the track plays from the decoded buffer rather than streaming */
+    bool isInMemory() const noexcept { return memorySource != nullptr; }
+
+    std::unique_ptr<AudioFormatReaderSource> readerSource;
+    std::unique_ptr<ReadAheadAudioSource> bufferedSource;
+
+    AudioBuffer<float> decodedAudio;
+    std::unique_ptr<MemoryAudioSource> memorySource;
+    TrackMemoryBudget::Reservation memoryReservation;
+
+    AudioTransportSource transport;
+
+    /** Background analysis of this track, or nullptr if it isn't being analysed */
+    std::shared_ptr<TrackAnalyser> analyser;
+
+    /** Gain that brings the track to the deck's target loudness, set by the message thread */
+    std::atomic<float> autoGain{1.0f};
+
+    JUCE_DECLARE_NON_COPYABLE(LoadedTrack)
+};
+
+/**
+ * @struct TrackLoadSettings
+ * @brief Snapshot of the deck settings a load job prepares the track for
+ */
+struct TrackLoadSettings {
+    double sampleRate = 0.0;
+    int blockSize = 0;
+    int readAheadSamples = 0;
+    bool decodeToMemory = false;
+    bool usePcmCache = false;
+};
+
+/**
+ * @class TrackLoaderPool
+ * @brief Small worker pool shared by all decks for opening and preparing tracks
+ */
+class TrackLoaderPool : public ThreadPool {
+public:
+    TrackLoaderPool();
+    ~TrackLoaderPool() override;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(TrackLoaderPool)
+};
+
+/**
+ * @class TrackDecodePool
+ * @brief Background pool that decodes streaming tracks for their caches and sinks
+ *
+ * Kept apart from TrackLoaderPool so a long decode never holds up the next load.
+ */
+class TrackDecodePool : public ThreadPool {
+public:
+    TrackDecodePool();
+    ~TrackDecodePool() override;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(TrackDecodePool)
+};
+
+/**
+ * @class TrackDecodeJob
+ * @brief Reads a whole track once, feeding a new PCM cache entry and any DecodeSinks
+ *
+ * A streaming deck plays from its own reader as soon as the track is open, and this
+ * job fills in the waveform, analysis and cache behind it on a reader of its own.
+ */
+class TrackDecodeJob : public ThreadPoolJob {
+public:
+    /**
+     * Constructor for TrackDecodeJob
+     * @param reader Reader to decode from, owned by the job
+     * @param cacheEntry Entry to write and commit, or nullptr
+     * @param sinks Consumers to feed
+     */
+    TrackDecodeJob(std::unique_ptr<AudioFormatReader> reader,
+                   std::unique_ptr<PcmCache::EntryWriter> cacheEntry,
+                   const Array<std::shared_ptr<DecodeSink>>& sinks);
+
+    /** ThreadPoolJob override - runs the decode pass */
+    JobStatus runJob() override;
+
+    /**
+     * Reads the whole track once, feeding a buffer, a cache entry and sinks
+     * A cache entry that fails to write is dropped rather than committed half-written;
+     * one that is written completely is committed.
+     * @param destination Buffer to decode the whole track into, or nullptr
+     * @param shouldStop Checked between blocks to cancel the pass
+     * @param onProgress Called with the proportion decoded after each block, if set
+     * @return false if the pass was cancelled
+     */
+    static bool decode(AudioFormatReader& reader,
+                       AudioBuffer<float>* destination,
+                       std::unique_ptr<PcmCache::EntryWriter>& cacheEntry,
+                       const Array<std::shared_ptr<DecodeSink>>& sinks,
+                       const std::function<bool()>& shouldStop,
+                       const std::function<void(double)>& onProgress);
+
+private:
+    SharedResourcePointer<PcmCache> pcmCache;
+    std::unique_ptr<AudioFormatReader> reader;
+    std::unique_ptr<PcmCache::EntryWriter> cacheEntry;
+    Array<std::shared_ptr<DecodeSink>> sinks;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(TrackDecodeJob)
+};
+
+/**
+ * @class TrackLoadJob
+ * @brief Opens, probes and prepares a track on a worker thread
+ *
+ * Progress and the result are polled from the message thread. The job checks
+ * shouldExit() between stages so a cancelled load stops as soon as it can.
+ *
+ * Whatever needs the whole track is fed from a single decode pass: the in-memory
+ * buffer, a new PCM cache entry and any DecodeSinks such as the waveform. Only a
+ * deck in memory mode waits for that pass; a streaming track is handed over as soon
+ * as it is open, and the pass runs behind it as a TrackDecodeJob.
+ */
+class TrackLoadJob : public ThreadPoolJob {
+public:
+    /**
+     * Constructor for TrackLoadJob
+     * @param url The file to load
+     * @param formatManager Format manager used to probe the file
+     * @param settings Device settings and read-ahead size to prepare the track with
+     * @param sinks Consumers to feed from the decode pass
+     */
+    TrackLoadJob(const URL& url,
+                 AudioFormatManager& formatManager,
+                 const TrackLoadSettings& settings,
+                 const Array<std::shared_ptr<DecodeSink>>& sinks = {});
+
+    /** ThreadPoolJob override - does the actual loading */
+    JobStatus runJob() override;
+
+    /** Gets the load progress (0.0 to 1.0) */
+    double getProgress() const noexcept;
+
+    /** Takes the loaded track, or nullptr if loading failed or was cancelled */
+    std::unique_ptr<LoadedTrack> takeResult();
+
+    /** Gets the URL being loaded */
+    const URL& getURL() const noexcept;
+
+private:
+    /** Builds the track, returning nullptr on failure or cancellation */
+    std::unique_ptr<LoadedTrack> loadTrack();
+
+    /**
+     * Opens a reader for the file, from the PCM cache if allowed and it has an entry
+     * @param fromPcmCache Set to whether the reader is over the cache entry
+     */
+    std::unique_ptr<AudioFormatReader> openReader(bool usePcmCache, bool& fromPcmCache);
+
+    /** Claims memory for the whole track and sizes its buffer, returns false if it doesn't fit */
+    bool reserveMemory(LoadedTrack& track);
+
+    URL url;
+    AudioFormatManager& formatManager;
+    TrackLoadSettings settings;
+    Array<std::shared_ptr<DecodeSink>> sinks;
+    SharedResourcePointer<ReadAheadThread> readAheadThread;
+    SharedResourcePointer<TrackMemoryBudget> memoryBudget;
+    SharedResourcePointer<PcmCache> pcmCache;
+    SharedResourcePointer<ContentHashIndex> contentHashes;
+    SharedResourcePointer<TrackDecodePool> decodePool;
+
+    std::atomic<double> progress{0.0};
+    std::unique_ptr<LoadedTrack> result;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(TrackLoadJob)
+};
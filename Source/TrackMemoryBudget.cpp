@@ -0,0 +1,81 @@
+/*
+  ==============================================================================
+
+    TrackMemoryBudget.cpp
+    Created: 16 Oct 2026 1:22:09pm
+
+  ==============================================================================
+*/
+
+#include "TrackMemoryBudget.h"
+
+//==============================================================================
+TrackMemoryBudget::Reservation::Reservation(TrackMemoryBudget& budget, size_t numBytes)
+    : budget(&budget), numBytes(numBytes) {
+}
+
+TrackMemoryBudget::Reservation::~Reservation() {
+    release();
+}
+
+TrackMemoryBudget::Reservation::Reservation(Reservation&& other) noexcept
+    : budget(std::exchange(other.budget, nullptr)),
+      numBytes(std::exchange(other.numBytes, 0)) {
+}
+
+TrackMemoryBudget::Reservation& TrackMemoryBudget::Reservation::operator=(Reservation&& other) noexcept {
+    if (this != &other) {
+        release();
+        budget = std::exchange(other.budget, nullptr);
+        numBytes = std::exchange(other.numBytes, 0);
+    }
+    return *this;
+}
+
+size_t TrackMemoryBudget::Reservation::getNumBytes() const noexcept {
+    return numBytes;
+}
+
+bool TrackMemoryBudget::Reservation::isValid() const noexcept {
+    return budget != nullptr;
+}
+
+void TrackMemoryBudget::Reservation::release() {
+    if (budget != nullptr)
+        budget->bytesInUse -= numBytes;
+
+    budget = nullptr;
+    numBytes = 0;
+}
+
+//==============================================================================
+TrackMemoryBudget::TrackMemoryBudget() {
+}
+
+TrackMemoryBudget::~TrackMemoryBudget() {
+    // Every reservation must be gone before the budget is
+    jassert(bytesInUse.load() == 0);
+}
+
+TrackMemoryBudget::Reservation TrackMemoryBudget::tryReserve(size_t numBytes) {
+    auto inUse = bytesInUse.load();
+
+    do {
+        if (inUse + numBytes > budgetBytes.load())
+            return {};
+    } while (!bytesInUse.compare_exchange_weak(inUse, inUse + numBytes));
+
+    return Reservation(*this, numBytes);
+}
+
+void TrackMemoryBudget::setBudgetBytes(size_t newBudget) {
+    budgetBytes = newBudget;
+}
+
+size_t TrackMemoryBudget::getBudgetBytes() const noexcept {
+    return budgetBytes.load();
+}
+
+size_t TrackMemoryBudget::getBytesInUse() const noexcept {
+    return bytesInUse.load();
+}
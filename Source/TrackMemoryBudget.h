@@ -0,0 +1,78 @@
+/*
+  ==============================================================================
+
+    TrackMemoryBudget.h
+    Created: 16 Oct 2026 1:22:09pm
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "../JuceLibraryCode/JuceHeader.h"
+
+/**
+ * @class TrackMemoryBudget
+ * @brief Global limit on the memory all decks may use for fully decoded tracks
+ *
+ * Hold it through a SharedResourcePointer so every deck draws from the same budget.
+ * Memory is claimed with a Reservation, which gives it back when destroyed.
+ */
+class TrackMemoryBudget {
+public:
+    /** Default budget shared by all decks */
+    static constexpr size_t defaultBudgetBytes = static_cast<size_t>(1024) * 1024 * 1024;
+
+    /**
+     * @class Reservation
+     * @brief Move-only claim on part of the budget, released on destruction
+     */
+    class Reservation {
+    public:
+        Reservation() = default;
+        Reservation(TrackMemoryBudget& budget, size_t numBytes);
+        ~Reservation();
+
+        Reservation(Reservation&& other) noexcept;
+        Reservation& operator=(Reservation&& other) noexcept;
+
+        /** Gets the number of bytes this reservation holds */
+        size_t getNumBytes() const noexcept;
+
+        /** Returns true if this reservation holds any memory */
+        bool isValid() const noexcept;
+
+    private:
+        void release();
+
+        TrackMemoryBudget* budget = nullptr;
+        size_t numBytes = 0;
+
+        JUCE_DECLARE_NON_COPYABLE(Reservation)
+    };
+
+    TrackMemoryBudget();
+    ~TrackMemoryBudget();
+
+    /**
+     * Tries to claim memory from the budget
+     * @param numBytes Number of bytes wanted
+     * @return A valid reservation, or an empty one if the budget would be exceeded
+     */
+    Reservation tryReserve(size_t numBytes);
+
+    /** Sets the budget; existing reservations are kept even if they now exceed it */
+    void setBudgetBytes(size_t newBudget);
+
+    /** Gets the budget */
+    size_t getBudgetBytes() const noexcept;
+
+    /** Gets the number of bytes currently reserved across all decks */
+    size_t getBytesInUse() const noexcept;
+
+private:
+    std::atomic<size_t> budgetBytes{defaultBudgetBytes};
+    std::atomic<size_t> bytesInUse{0};
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(TrackMemoryBudget)
+};
@@ -0,0 +1,160 @@
+/*
+  ==============================================================================
+
+    TrackWindow.cpp
+    Created: 17 Oct 2026 11:52:40am
+
+  ==============================================================================
+*/
+
+#include "TrackWindow.h"
+
+//==============================================================================
+std::unique_ptr<TrackWindow> TrackWindow::forCue(const LoadedTrack& track, int64 cueSample, int64 numSamples) {
+    auto length = jmin(numSamples, track.lengthInSamples - cueSample);
+    if (cueSample < 0 || length <= 0)
+        return nullptr;
+
+    auto window = std::make_unique<TrackWindow>();
+    window->startSample = cueSample;
+    window->endSample = cueSample + length;
+    return window;
+}
+
+std::unique_ptr<TrackWindow> TrackWindow::forLoop(const LoadedTrack& track, int64 loopStart, int64 loopEnd) {
+    if (loopStart < 0 || loopEnd <= loopStart || loopEnd > track.lengthInSamples)
+        return nullptr;
+
+    // A loop at the very start of the track has no lead-in, and wraps without a crossfade
+    auto leadIn = jmin(static_cast<int64>(getCrossfadeSamples(track.sampleRate)), loopStart);
+
+    auto window = std::make_unique<TrackWindow>();
+    window->startSample = loopStart - leadIn;
+    window->loopStart = loopStart;
+    window->loopEnd = loopEnd;
+    window->endSample = loopEnd;
+    return window;
+}
+
+int TrackWindow::getCrossfadeSamples(double sampleRate) noexcept {
+    return jlimit(0, maxCrossfadeSamples, roundToInt(sampleRate * crossfadeSeconds));
+}
+
+void TrackWindow::referTo(const AudioBuffer<float>& decodedTrack) {
+    // The decoded track is only ever read, by this window as by the deck
+    audio.setDataToReferTo(const_cast<float* const*>(decodedTrack.getArrayOfReadPointers()),
+                           decodedTrack.getNumChannels(), static_cast<int>(startSample),
+                           static_cast<int>(endSample - startSample));
+}
+
+bool TrackWindow::read(AudioFormatReader& reader) {
+    audio.setSize(jmax(1, static_cast<int>(reader.numChannels)), static_cast<int>(endSample - startSample));
+    return reader.read(&audio, 0, audio.getNumSamples(), startSample, true, true);
+}
+
+void TrackWindow::prepareLoop() {
+    if (!isLoop())
+        return;
+
+    auto tailLength = static_cast<int>(jmin(loopStart - startSample, (loopEnd - loopStart) / 2));
+    loopTail.setSize(audio.getNumChannels(), tailLength);
+
+    // The end of the loop fades out while the audio just before the loop start fades in, so the
+    // tail runs straight on into the loop start. Linear, as the two sides are the same music a
+    // whole loop apart and mostly in phase
+    auto fadeOutOffset = static_cast<int>(loopEnd - tailLength - startSample);
+    auto fadeInOffset = static_cast<int>(loopStart - tailLength - startSample);
+
+    for (int chan = 0; chan < audio.getNumChannels(); ++chan) {
+        const auto* samples = audio.getReadPointer(chan);
+        auto* tail = loopTail.getWritePointer(chan);
+
+        for (int i = 0; i < tailLength; ++i) {
+            auto fadeIn = (static_cast<float>(i) + 0.5f) / static_cast<float>(tailLength);
+            tail[i] = samples[fadeOutOffset + i] * (1.0f - fadeIn) + samples[fadeInOffset + i] * fadeIn;
+        }
+    }
+}
+
+void TrackWindow::copyTo(AudioBuffer<float>& dest, int destStartSample, int64 position, int numSamples,
+                         bool looping) const noexcept {
+    jassert(position >= startSample && position + numSamples <= endSample);
+
+    // Only the samples before the crossfaded end of the loop come straight from the track
+    auto tailStart = loopEnd - loopTail.getNumSamples();
+    auto numDirect = looping && isLoop() ? static_cast<int>(jlimit(static_cast<int64>(0), static_cast<int64>(numSamples),
+                                                                   tailStart - position))
+                                         : numSamples;
+    auto offset = static_cast<int>(position - startSample);
+
+    for (int chan = 0; chan < dest.getNumChannels(); ++chan) {
+        auto sourceChannel = jmin(chan, audio.getNumChannels() - 1);
+        dest.copyFrom(chan, destStartSample, audio, sourceChannel, offset, numDirect);
+
+        if (numDirect < numSamples)
+            dest.copyFrom(chan, destStartSample + numDirect, loopTail, sourceChannel,
+                          static_cast<int>(position + numDirect - tailStart), numSamples - numDirect);
+    }
+}
+
+//==============================================================================
+bool TrackWindowSet::contains(const TrackWindow* window) const noexcept {
+    if (window == nullptr)
+        return false;
+
+    if (loop.get() == window)
+        return true;
+
+    for (auto& cue : cues)
+        if (cue.get() == window)
+            return true;
+
+    return false;
+}
+
+const TrackWindow* TrackWindowSet::find(int64 sample) const noexcept {
+    if (loop != nullptr && loop->contains(sample))
+        return loop.get();
+
+    for (auto& cue : cues)
+        if (cue != nullptr && cue->contains(sample))
+            return cue.get();
+
+    return nullptr;
+}
+
+//==============================================================================
+TrackWindowJob::TrackWindowJob(const LoadedTrack& track, AudioFormatManager& formatManager,
+                               std::unique_ptr<TrackWindow> windowToFill)
+    : ThreadPoolJob("Read track window"),
+      url(track.url),
+      fromPcmCache(track.fromPcmCache),
+      formatManager(formatManager),
+      window(std::move(windowToFill)) {
+}
+
+ThreadPoolJob::JobStatus TrackWindowJob::runJob() {
+    if (shouldExit())
+        return jobHasFinished;
+
+    std::unique_ptr<AudioFormatReader> reader;
+    if (fromPcmCache)
+        reader = pcmCache->openReader(url.getLocalFile());
+
+    if (reader == nullptr)
+        if (auto stream = url.createInputStream(false))
+            reader.reset(formatManager.createReaderFor(std::move(stream)));
+
+    if (reader == nullptr || !window->read(*reader)) {
+        DBG("TrackWindowJob: could not read " + url.toString(false));
+        window.reset();
+        return jobHasFinished;
+    }
+
+    window->prepareLoop();
+    return jobHasFinished;
+}
+
+std::unique_ptr<TrackWindow> TrackWindowJob::takeResult() {
+    return shouldExit() ? nullptr : std::move(window);
+}
@@ -0,0 +1,137 @@
+/*
+  ==============================================================================
+
+    TrackWindow.h
+    Created: 17 Oct 2026 11:52:40am
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include "TrackLoader.h"
+
+/**
+ * @struct TrackWindow
+ * @brief A span of a track held in memory, for a deck to play without touching its stream
+ *
+ * Loops and hot cues play from windows, so going round a loop or jumping to a cue
+ * never seeks the track's reader or empties its read-ahead buffer. A window of a
+ * track decoded into memory just refers to the decoded buffer.
+ *
+ * A loop window starts a crossfade's length before the loop, and keeps a copy of
+ * the end of the loop faded into that lead-in. Played up to the loop end from the
+ * copy and on from the loop start, the join has no click.
+ */
+struct TrackWindow {
+    /** Length of the crossfade at loop points and jumps */
+    static constexpr double crossfadeSeconds = 0.005;
+
+    /** Most samples a crossfade takes, enough for crossfadeSeconds at 192 kHz */
+    static constexpr int maxCrossfadeSamples = 1024;
+
+    int64 startSample = 0;          /**< Track sample of the window's first sample */
+    int64 endSample = 0;            /**< Track sample after the window's last */
+    int64 loopStart = 0;            /**< First sample of the loop */
+    int64 loopEnd = 0;              /**< Sample after the loop, or 0 if this is a hot cue's window */
+    AudioBuffer<float> audio;       /**< The track's samples, owned or referring to the decoded track */
+    AudioBuffer<float> loopTail;    /**< The loop's last samples, faded into the lead-in */
+
+    /**
+     * Makes a window, not yet filled, holding a hot cue and what follows it
+     * @return The window, or nullptr if the cue is at the end of the track
+     */
+    static std::unique_ptr<TrackWindow> forCue(const LoadedTrack& track, int64 cueSample, int64 numSamples);
+
+    /**
+     * Makes a window, not yet filled, holding a loop and the lead-in its crossfade needs
+     * @return The window, or nullptr if the loop isn't inside the track
+     */
+    static std::unique_ptr<TrackWindow> forLoop(const LoadedTrack& track, int64 loopStart, int64 loopEnd);
+
+    /** Gets the crossfade length at a sample rate */
+    static int getCrossfadeSamples(double sampleRate) noexcept;
+
+    /** Returns true if the window holds a loop */
+    bool isLoop() const noexcept { return loopEnd > loopStart; }
+
+    /** Returns true if the window holds a track sample */
+    bool contains(int64 sample) const noexcept { return sample >= startSample && sample < endSample; }
+
+    /** Points the window at a track decoded into memory, which must outlive it, instead of reading it */
+    void referTo(const AudioBuffer<float>& decodedTrack);
+
+    /** Reads the window's span of a track, returning false if the reader fails */
+    bool read(AudioFormatReader& reader);
+
+    /** Fades the end of the loop into the lead-in, once the audio is in place */
+    void prepareLoop();
+
+    /**
+     * Copies samples out of the window (audio thread)
+     * @param dest Buffer to write to; a mono window is copied to every channel
+     * @param destStartSample Where to start writing in dest
+     * @param position Track sample to start from; the span must be inside the window
+     * @param numSamples Number of samples to copy
+     * @param looping True to play the end of the loop from the crossfaded copy, as the playback will wrap
+     */
+    void copyTo(AudioBuffer<float>& dest, int destStartSample, int64 position, int numSamples, bool looping) const noexcept;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(TrackWindow)
+};
+
+/**
+ * @struct TrackWindowSet
+ * @brief The loop and hot cue windows of one track, handed to the audio thread as one
+ *
+ * A set is never changed once published; the deck publishes a new one, sharing the
+ * windows that haven't changed. The audio thread only ever uses raw pointers into
+ * it, so reference counts are only touched on the message thread.
+ */
+struct TrackWindowSet {
+    static constexpr int maxHotCues = 4;
+
+    const LoadedTrack* track = nullptr;
+    std::shared_ptr<const TrackWindow> loop;
+    std::array<std::shared_ptr<const TrackWindow>, maxHotCues> cues;
+
+    /** Returns true if the set holds a window */
+    bool contains(const TrackWindow* window) const noexcept;
+
+    /** Finds the window holding a track sample, the loop before any cue, or nullptr */
+    const TrackWindow* find(int64 sample) const noexcept;
+};
+
+/**
+ * @class TrackWindowJob
+ * @brief Reads a window of a streaming track on a worker thread
+ *
+ * The job opens its own reader, from the PCM cache if the track plays from there,
+ * so the deck's stream is left alone. The result is polled from the message thread.
+ */
+class TrackWindowJob : public ThreadPoolJob {
+public:
+    /**
+     * Constructor for TrackWindowJob
+     * @param track The track the window is of
+     * @param formatManager Used to open the track if it isn't in the PCM cache; must outlive the job
+     * @param windowToFill The window to read into
+     */
+    TrackWindowJob(const LoadedTrack& track, AudioFormatManager& formatManager, std::unique_ptr<TrackWindow> windowToFill);
+
+    /** ThreadPoolJob override - reads the window */
+    JobStatus runJob() override;
+
+    /** Takes the filled window, or nullptr if reading failed or was abandoned */
+    std::unique_ptr<TrackWindow> takeResult();
+
+private:
+    URL url;
+    bool fromPcmCache;
+    AudioFormatManager& formatManager;
+    std::unique_ptr<TrackWindow> window;
+    SharedResourcePointer<PcmCache> pcmCache;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(TrackWindowJob)
+};
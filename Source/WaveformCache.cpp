@@ -0,0 +1,108 @@
+/*
+  ==============================================================================
+
+    WaveformCache.cpp
+    Created: 16 Oct 2026 6:02:44pm
+
+  ==============================================================================
+*/
+
+#include "WaveformCache.h"
+#include "WaveformPyramid.h"
+
+//==============================================================================
+WaveformCache::WaveformCache()
+    : directory(File::getSpecialLocation(File::userApplicationDataDirectory)
+                    .getChildFile("OtoDecks")
+                    .getChildFile("Waveforms")) {
+    directory.createDirectory();
+}
+
+WaveformCache::~WaveformCache() {
+    // Give queued pyramids a moment to reach the disk before dropping them
+    auto deadline = Time::getMillisecondCounter() + 2000;
+    while (writerPool.getNumJobs() > 0 && Time::getMillisecondCounter() < deadline)
+        Thread::sleep(10);
+
+    writerPool.removeAllJobs(true, 1000);
+}
+
+std::shared_ptr<WaveformPyramid> WaveformCache::load(const String& contentHash) {
+    auto file = getPyramidFile(contentHash);
+
+    FileInputStream in(file);
+    if (!in.openedOk())
+        return nullptr;
+
+    BufferedInputStream buffered(in, 1 << 16);
+    std::shared_ptr<WaveformPyramid> pyramid = WaveformPyramid::readFrom(buffered);
+    if (pyramid == nullptr) {
+        DBG("WaveformCache: ignoring unreadable " + file.getFullPathName());
+        return nullptr;
+    }
+
+    // Mark the file as recently used, eviction goes by access time
+    file.setLastAccessTime(Time::getCurrentTime());
+    return pyramid;
+}
+
+void WaveformCache::store(const String& contentHash, std::shared_ptr<const WaveformPyramid> pyramid) {
+    auto file = getPyramidFile(contentHash);
+
+    // The pyramid is read-only once finished, so the writer can serialise it while the deck draws from it
+    writerPool.addJob([this, file, pyramid] {
+        auto tempFile = file.getSiblingFile(file.getFileNameWithoutExtension() + ".tmp");
+        bool written = false;
+        {
+            FileOutputStream out(tempFile);
+            if (out.openedOk() && out.setPosition(0) && out.truncate().wasOk()) {
+                pyramid->writeTo(out);
+                out.flush();
+                written = out.getStatus().wasOk();
+            }
+        }
+
+        if (written && tempFile.moveFileTo(file))
+            trim();
+        else
+            DBG("WaveformCache: could not write " + file.getFullPathName());
+    });
+}
+
+void WaveformCache::setMaxSizeBytes(int64 newMaxSize) {
+    maxSizeBytes = newMaxSize;
+    writerPool.addJob([this] { trim(); });
+}
+
+int64 WaveformCache::getMaxSizeBytes() const noexcept {
+    return maxSizeBytes.load();
+}
+
+//==============================================================================
+File WaveformCache::getPyramidFile(const String& contentHash) const {
+    return directory.getChildFile(contentHash.substring(0, 16) + ".wave");
+}
+
+void WaveformCache::trim() {
+    auto files = directory.findChildFiles(File::findFiles, false, "*.wave");
+
+    int64 total = 0;
+    for (const auto& file : files)
+        total += file.getSize();
+
+    if (total <= maxSizeBytes.load())
+        return;
+
+    std::sort(files.begin(), files.end(), [](const File& a, const File& b) {
+        return a.getLastAccessTime() < b.getLastAccessTime();
+    });
+
+    for (const auto& file : files) {
+        if (total <= maxSizeBytes.load())
+            break;
+
+        auto size = file.getSize();
+        if (file.deleteFile())
+            total -= size;
+    }
+}
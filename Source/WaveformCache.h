@@ -0,0 +1,62 @@
+/*
+  ==============================================================================
+
+    WaveformCache.h
+    Created: 16 Oct 2026 6:02:44pm
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "../JuceLibraryCode/JuceHeader.h"
+
+class WaveformPyramid;
+
+/**
+ * @class WaveformCache
+ * @brief Keeps every finished waveform pyramid on disk, keyed by content hash
+ *
+ * Pyramids are stored in the application data folder, so a track seen in an earlier
+ * session gets its waveform without being decoded again. Only the coarse level is
+ * stored (about 200 KB for a six-minute stereo track); finer detail is rebuilt from
+ * the audio when the track is on a deck. New pyramids are written
+ * on a background thread, and the folder is kept under a size limit by deleting
+ * the least recently used files. Both methods may be called from any thread.
+ */
+class WaveformCache {
+public:
+    /** Default size limit of the waveform folder, enough for a library of about 20000 tracks */
+    static constexpr int64 defaultMaxSizeBytes = static_cast<int64>(4) * 1024 * 1024 * 1024;
+
+    WaveformCache();
+
+    /** Destructor - waits briefly for queued writes to finish */
+    ~WaveformCache();
+
+    /** Reads the pyramid stored for a track, or returns nullptr if there isn't a usable one */
+    std::shared_ptr<WaveformPyramid> load(const String& contentHash);
+
+    /** Queues a finished pyramid to be written to disk */
+    void store(const String& contentHash, std::shared_ptr<const WaveformPyramid> pyramid);
+
+    /** Sets the size limit and evicts pyramids if the folder is now over it */
+    void setMaxSizeBytes(int64 newMaxSize);
+
+    /** Gets the size limit */
+    int64 getMaxSizeBytes() const noexcept;
+
+private:
+    /** Gets the file a track's pyramid is stored in */
+    File getPyramidFile(const String& contentHash) const;
+
+    /** Deletes least recently used pyramids until the folder fits its size limit */
+    void trim();
+
+    File directory;
+    std::atomic<int64> maxSizeBytes{defaultMaxSizeBytes};
+    ThreadPool writerPool{ThreadPoolOptions{}.withThreadName("Waveform writer")
+                                             .withNumberOfThreads(1)};
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(WaveformCache)
+};
@@ -14,60 +14,38 @@
 #include "WaveformDisplay.h"
 
 //==============================================================================
-WaveformDisplay::WaveformDisplay(AudioFormatManager& formatManagerToUse,
-                               AudioThumbnailCache& cacheToUse) :
-    audioThumb(1000, formatManagerToUse, cacheToUse) {
-    audioThumb.addChangeListener(this);
-    
+WaveformDisplay::WaveformDisplay(WaveformCache& cacheToUse) :
+    waveformCache(cacheToUse) {
     // Register as a mouse listener
     addMouseListener(this, true);
     
+    // The cached layer fills every pixel, so nothing behind needs repainting
+    setOpaque(true);
+
     // Set mouse cursor to pointing hand to indicate clickable area
     setMouseCursor(MouseCursor::PointingHandCursor);
 }
 
 WaveformDisplay::~WaveformDisplay() {
-    audioThumb.removeChangeListener(this);
+    stopTimer();
     removeMouseListener(this);
 }
 
 void WaveformDisplay::paint(Graphics& g) {
-    // Create a nice gradient background for the waveform
-    Rectangle<float> bounds = getLocalBounds().toFloat();
-    g.setGradientFill(ColourGradient(
-        Colour(20, 20, 30),
-        0, 0,
-        Colour(10, 10, 20),
-        0, bounds.getHeight(),
-        false));
-    g.fillAll();
-    
-    // Draw a more attractive border
-    g.setColour(Colours::grey.withAlpha(0.5f));
-    g.drawRoundedRectangle(bounds.reduced(1.0f), 3.0f, 1.0f);
-    
+    // The static layer is only redrawn when the track, view or size changes
+    auto scale = g.getInternalContext().getPhysicalPixelScaleFactor();
+    if (!waveformImage.isValid() || waveformImageScale != scale)
+        renderWaveformImage(scale);
+
+    if (waveformImage.isValid())
+        g.drawImageTransformed(waveformImage, AffineTransform::scale(1.0f / waveformImageScale));
+
     if (fileLoaded) {
-        // Draw waveform with better colors
+        Rectangle<float> bounds = getLocalBounds().toFloat();
         Rectangle<int> waveformBounds = getLocalBounds().reduced(4);
-        g.setColour(Colours::cadetblue.withAlpha(0.7f));  // Nicer color for waveform
-        
-        audioThumb.drawChannel(g,
-            waveformBounds,
-            0,
-            audioThumb.getTotalLength(),
-            0,
-            1.0f
-        );
-        
-        // Draw time markers
-        g.setColour(Colours::darkgrey.withAlpha(0.3f));
-        for (int i = 1; i < 10; ++i) {
-            float xPos = waveformBounds.getX() + (waveformBounds.getWidth() * i / 10.0f);
-            g.drawVerticalLine(xPos, waveformBounds.getY(), waveformBounds.getBottom());
-        }
-        
+
         // Draw playhead position with a more attractive style
-        auto playheadX = waveformBounds.getX() + position * waveformBounds.getWidth();
+        auto playheadX = positionToX(position, waveformBounds);
         
         // Draw playhead line
         g.setColour(Colours::lime.withAlpha(0.8f));
@@ -76,11 +54,10 @@ void WaveformDisplay::paint(Graphics& g) {
         // Draw playhead position marker at the top
         g.setColour(Colours::lime);
         Path triangle;
-        float triangleSize = 6.0f;
         triangle.addTriangle(
             playheadX, waveformBounds.getY(), 
-            playheadX - triangleSize, waveformBounds.getY() - triangleSize,
-            playheadX + triangleSize, waveformBounds.getY() - triangleSize);
+            playheadX - playheadTriangleSize, waveformBounds.getY() - playheadTriangleSize,
+            playheadX + playheadTriangleSize, waveformBounds.getY() - playheadTriangleSize);
         g.fillPath(triangle);
         
         // Add highlight if dragging
@@ -96,6 +73,36 @@ void WaveformDisplay::paint(Graphics& g) {
             g.fillRect(bounds.getX(), bounds.getY(), 
                       playheadX - bounds.getX(), bounds.getHeight());
         }
+    }
+}
+
+void WaveformDisplay::paintWaveformLayer(Graphics& g) {
+    // Create a nice gradient background for the waveform
+    Rectangle<float> bounds = getLocalBounds().toFloat();
+    g.setGradientFill(ColourGradient(
+        Colour(20, 20, 30),
+        0, 0,
+        Colour(10, 10, 20),
+        0, bounds.getHeight(),
+        false));
+    g.fillAll();
+    
+    // Draw a more attractive border
+    g.setColour(Colours::grey.withAlpha(0.5f));
+    g.drawRoundedRectangle(bounds.reduced(1.0f), 3.0f, 1.0f);
+    
+    if (fileLoaded) {
+        // Draw waveform with better colors
+        Rectangle<int> waveformBounds = getLocalBounds().reduced(4);
+        g.setColour(Colours::cadetblue.withAlpha(0.7f));  // Nicer color for waveform
+        drawPyramid(g, waveformBounds);
+        
+        // Draw time markers
+        g.setColour(Colours::darkgrey.withAlpha(0.3f));
+        for (int i = 1; i < 10; ++i) {
+            float xPos = waveformBounds.getX() + (waveformBounds.getWidth() * i / 10.0f);
+            g.drawVerticalLine(xPos, waveformBounds.getY(), waveformBounds.getBottom());
+        }
     } else {
         // Display message when no file is loaded - with better styling
         g.setColour(Colours::white.withAlpha(0.7f));
@@ -111,38 +118,118 @@ void WaveformDisplay::paint(Graphics& g) {
     }
 }
 
+void WaveformDisplay::renderWaveformImage(float scale) {
+    waveformImageScale = scale;
+    waveformImage = Image();
+
+    auto width = roundToInt(getWidth() * scale);
+    auto height = roundToInt(getHeight() * scale);
+    if (width <= 0 || height <= 0)
+        return;
+
+    // Rendered at the display's pixel density so it blits 1:1 without resampling
+    waveformImage = Image(Image::RGB, width, height, false);
+    Graphics imageGraphics(waveformImage);
+    imageGraphics.addTransform(AffineTransform::scale(scale));
+    paintWaveformLayer(imageGraphics);
+}
+
+void WaveformDisplay::invalidateWaveformImage() {
+    waveformImage = Image();
+    repaint();
+}
+
 void WaveformDisplay::resized() {
-    // No child components to resize
+    // No child components to resize, but the cached layer no longer fits
+    invalidateWaveformImage();
 }
 
-void WaveformDisplay::loadURL(URL audioURL) {
-    audioThumb.clear();
-    fileLoaded = audioThumb.setSource(new URLInputSource(audioURL));
-    
-    if (fileLoaded) {
-        DBG("WaveformDisplay: Successfully loaded file");
+Array<std::shared_ptr<DecodeSink>> WaveformDisplay::beginLoad() {
+    pendingPyramid = std::make_shared<PyramidDecodeSink>(waveformCache);
+
+    Array<std::shared_ptr<DecodeSink>> sinks;
+    sinks.add(pendingPyramid);
+    return sinks;
+}
+
+void WaveformDisplay::finishLoad(bool loaded, FineDetailOpener openFineDetailReaderToUse) {
+    if (loaded && pendingPyramid != nullptr) {
+        loadedPyramid = std::move(pendingPyramid);
+        openFineDetailReader = std::move(openFineDetailReaderToUse);
+
+        pyramid.reset();
+        fileLoaded = false;
         position = 0.0;
-    } else {
-        DBG("WaveformDisplay: Failed to load file: " + audioURL.toString(false));
+        viewStart = 0.0;
+        viewLength = 1.0;
+        invalidateWaveformImage();
+
+        if (!showFinishedPyramid())
+            startTimer(100);
     }
-    
-    repaint();
+
+    cancelLoad();
+}
+
+void WaveformDisplay::timerCallback() {
+    if (showFinishedPyramid())
+        stopTimer();
 }
 
-void WaveformDisplay::changeListenerCallback(ChangeBroadcaster* source) {
-    // Audio thumbnail has changed, so repaint the component
-    if (source == &audioThumb) {
-        DBG("WaveformDisplay: Thumbnail changed");
-        repaint();
+bool WaveformDisplay::showFinishedPyramid() {
+    if (loadedPyramid == nullptr)
+        return true;
+
+    if (!loadedPyramid->isFinished())
+        return false;
+
+    pyramid = loadedPyramid->getPyramid();
+    loadedPyramid.reset();
+
+    // Called only now, as the cache entry a streaming track's reader reads is written by the same pass
+    if (pyramid != nullptr && openFineDetailReader != nullptr)
+        if (auto reader = openFineDetailReader())
+            pyramid->setSampleReader(std::move(reader));
+
+    openFineDetailReader = nullptr;
+    fileLoaded = pyramid != nullptr && pyramid->getLengthInSamples() > 0;
+
+    if (fileLoaded) {
+        DBG("WaveformDisplay: Successfully loaded waveform");
+    } else {
+        DBG("WaveformDisplay: Waveform is empty");
     }
+
+    invalidateWaveformImage();
+    return true;
+}
+
+void WaveformDisplay::cancelLoad() {
+    pendingPyramid.reset();
 }
 
 void WaveformDisplay::setPositionRelative(double pos) {
     // Only repaint if the position has actually changed
     if (pos != position && pos >= 0.0 && pos <= 1.0)
     {
+        auto oldStrip = getPlayheadStrip();
         position = pos;
-        repaint();
+
+        // When zoomed in, turn the page once the playhead leaves the visible range
+        if (!isDragging && (pos < viewStart || pos >= viewStart + viewLength)) {
+            viewStart = pos;
+            constrainView();
+            invalidateWaveformImage();
+        }
+        else if (isDragging) {
+            // The drag highlight spans everything left of the playhead
+            repaint();
+        }
+        else {
+            // Only the strips the playhead left and moved into need redrawing from the cached layer
+            repaint(oldStrip);
+            repaint(getPlayheadStrip());
+        }
     }
 }
 
@@ -185,6 +272,28 @@ void WaveformDisplay::mouseUp(const MouseEvent& event) {
     repaint(); // Refresh to remove any drag-specific visual elements
 }
 
+void WaveformDisplay::mouseDoubleClick(const MouseEvent& event) {
+    viewStart = 0.0;
+    viewLength = 1.0;
+    invalidateWaveformImage();
+}
+
+void WaveformDisplay::mouseWheelMove(const MouseEvent& event, const MouseWheelDetails& wheel) {
+    if (!fileLoaded || wheel.deltaY == 0.0f)
+        return;
+
+    // Keep the position under the cursor where it is while the range around it shrinks or grows
+    auto anchor = xToPosition(event.x);
+    auto anchorProportion = (anchor - viewStart) / viewLength;
+    auto zoomFactor = wheel.deltaY > 0.0f ? 0.8 : 1.25;
+
+    viewLength = jlimit(getMinViewLength(), 1.0, viewLength * zoomFactor);
+    viewStart = anchor - anchorProportion * viewLength;
+    constrainView();
+
+    invalidateWaveformImage();
+}
+
 //==============================================================================
 // Helper Methods
 //==============================================================================
@@ -196,7 +305,64 @@ double WaveformDisplay::xToPosition(int x) const {
     double relativeX = static_cast<double>(x - usableArea.getX()) / usableArea.getWidth();
     
     // Ensure bounds are respected
-    return jlimit(0.0, 1.0, relativeX);
+    return jlimit(0.0, 1.0, viewStart + jlimit(0.0, 1.0, relativeX) * viewLength);
+}
+
+float WaveformDisplay::positionToX(double pos, Rectangle<int> area) const {
+    return static_cast<float>(area.getX() + (pos - viewStart) / viewLength * area.getWidth());
+}
+
+Rectangle<int> WaveformDisplay::getPlayheadStrip() const {
+    auto playheadX = positionToX(position, getLocalBounds().reduced(4));
+    auto halfWidth = playheadTriangleSize + 2.0f;
+
+    return Rectangle<float>(playheadX - halfWidth, 0.0f, halfWidth * 2.0f, static_cast<float>(getHeight()))
+               .getSmallestIntegerContainer();
+}
+
+void WaveformDisplay::drawPyramid(Graphics& g, Rectangle<int> area) {
+    auto numColumns = area.getWidth();
+    if (numColumns <= 0)
+        return;
+
+    columns.resize(static_cast<size_t>(numColumns));
+
+    auto length = pyramid->getLengthInSamples();
+    auto startSample = static_cast<int64>(viewStart * length);
+    auto endSample = jmax(startSample + 1, static_cast<int64>((viewStart + viewLength) * length));
+    pyramid->getColumns(0, startSample, endSample, columns.data(), numColumns);
+
+    auto centreY = static_cast<float>(area.getCentreY());
+    auto halfHeight = area.getHeight() * 0.5f;
+
+    // Peaks first, then the RMS body on top in a darker shade
+    g.setColour(Colours::cadetblue.withAlpha(0.7f));
+    for (int i = 0; i < numColumns; ++i) {
+        auto top = centreY - jlimit(-1.0f, 1.0f, columns[static_cast<size_t>(i)].max) * halfHeight;
+        auto bottom = centreY - jlimit(-1.0f, 1.0f, columns[static_cast<size_t>(i)].min) * halfHeight;
+        g.drawVerticalLine(area.getX() + i, top, jmax(top + 1.0f, bottom));
+    }
+
+    g.setColour(Colours::cadetblue.darker(0.6f));
+    for (int i = 0; i < numColumns; ++i) {
+        auto rmsHeight = jmin(1.0f, columns[static_cast<size_t>(i)].rms) * halfHeight;
+        if (rmsHeight >= 0.5f)
+            g.drawVerticalLine(area.getX() + i, centreY - rmsHeight, centreY + rmsHeight);
+    }
+}
+
+double WaveformDisplay::getMinViewLength() const {
+    auto width = jmax(1, getLocalBounds().reduced(4).getWidth());
+
+    if (pyramid != nullptr && pyramid->getLengthInSamples() > 0)
+        return jmin(1.0, width / maxPixelsPerSample / static_cast<double>(pyramid->getLengthInSamples()));
+
+    return 1.0;
+}
+
+void WaveformDisplay::constrainView() {
+    viewLength = jlimit(getMinViewLength(), 1.0, viewLength);
+    viewStart = jlimit(0.0, 1.0 - viewLength, viewStart);
 }
 
 void WaveformDisplay::notifyPositionChanged(double pos) {
@@ -13,6 +13,8 @@
 #pragma once
 
 #include "../JuceLibraryCode/JuceHeader.h"
+#include "DecodeSink.h"
+#include "WaveformPyramid.h"
 
 /**
  * @class WaveformDisplay
@@ -20,9 +22,22 @@
  * 
  * Displays an audio waveform and playback position indicator for the loaded audio file.
  * Supports click-to-seek and dragging to scrub through audio.
+ *
+ * The display never decodes files itself. Its waveform pyramid is built by a sink
+ * attached to the player's decode pass, or read from the disk cache for a track seen
+ * before. A streaming track plays while that pass is still running, so the display
+ * stays blank after the load until the pyramid is finished.
+ *
+ * The background, waveform and grid are drawn once into a cached image, rebuilt only
+ * when the track, zoom or size changes. Moving the playhead just repaints the narrow
+ * strips it leaves and enters, blitting them back from the cache.
+ *
+ * The mouse wheel zooms around the cursor, from the whole track down to a few pixels
+ * per sample. Each repaint asks the pyramid for one summary per pixel column, so the
+ * cost depends on the width of the display rather than the length of the track.
  */
-class WaveformDisplay : public Component, 
-                       public ChangeListener {
+class WaveformDisplay : public Component,
+                        private Timer {
 public:
     /**
      * Callback function for position changes via user interaction
@@ -32,11 +47,9 @@ public:
 
     /**
      * Constructor for WaveformDisplay
-     * @param formatManagerToUse Reference to the AudioFormatManager for loading audio files
-     * @param cacheToUse Reference to the AudioThumbnailCache for caching audio thumbnails
+     * @param cacheToUse Reference to the disk cache waveform pyramids are kept in
      */
-    WaveformDisplay(AudioFormatManager& formatManagerToUse,
-                   AudioThumbnailCache& cacheToUse);
+    explicit WaveformDisplay(WaveformCache& cacheToUse);
     
     /** Destructor */
     ~WaveformDisplay();
@@ -51,13 +64,6 @@ public:
     /** Handles component resizing */
     void resized() override;
 
-    //==========================================================================
-    // ChangeListener override
-    //==========================================================================
-    
-    /** Responds to changes in the audio thumbnail */
-    void changeListenerCallback(ChangeBroadcaster* source) override;
-
     //==========================================================================
     // MouseListener overrides
     //==========================================================================
@@ -71,12 +77,34 @@ public:
     /** Handles mouse button release */
     void mouseUp(const MouseEvent& event) override;
 
+    /** Handles double-click - zooms back out to the whole track */
+    void mouseDoubleClick(const MouseEvent& event) override;
+
+    /** Handles the mouse wheel - zooms in or out around the cursor */
+    void mouseWheelMove(const MouseEvent& event, const MouseWheelDetails& wheel) override;
+
     //==========================================================================
     // Public methods
     //==========================================================================
     
-    /** Loads an audio file from a URL */
-    void loadURL(URL audioURL);
+    /**
+     * Creates the sink that builds the next track's waveform from the player's decode pass
+     * The current waveform stays on screen until finishLoad is called.
+     */
+    Array<std::shared_ptr<DecodeSink>> beginLoad();
+
+    /** Opens a reader over the track's samples for zooming past the pyramid, or returns nullptr */
+    using FineDetailOpener = std::function<std::unique_ptr<AudioFormatReader>()>;
+
+    /**
+     * Shows the waveform built by the sink from beginLoad, as soon as it is finished
+     * @param loaded False if the load failed, in which case the current waveform is kept
+     * @param openFineDetailReader Optional; called once the pyramid is finished
+     */
+    void finishLoad(bool loaded, FineDetailOpener openFineDetailReader);
+
+    /** Drops the sink from beginLoad without changing the display */
+    void cancelLoad();
 
     /** 
      * Sets the relative position of the playhead
@@ -85,13 +113,65 @@ public:
     void setPositionRelative(double pos);
 
 private:
+    /** Timer override - waits for the loaded track's pyramid */
+    void timerCallback() override;
+
+    /** Shows the loaded track's pyramid if it is finished, returning false if it isn't yet */
+    bool showFinishedPyramid();
+
     /** Converts x-coordinate to relative position (0-1) */
     double xToPosition(int x) const;
+
+    /** Converts a relative position (0-1) to an x-coordinate within the given area */
+    float positionToX(double pos, Rectangle<int> area) const;
+
+    /** Draws the static layer: background, waveform and grid */
+    void paintWaveformLayer(Graphics& g);
+
+    /** Renders the static layer into the cached image at the given pixel scale */
+    void renderWaveformImage(float scale);
+
+    /** Discards the cached layer and repaints, e.g. after a load, zoom or resize */
+    void invalidateWaveformImage();
+
+    /** Gets the area covered by the playhead line and marker */
+    Rectangle<int> getPlayheadStrip() const;
+
+    /** Draws the visible range from the pyramid, one min/max line and RMS band per pixel */
+    void drawPyramid(Graphics& g, Rectangle<int> area);
+
+    /** Gets the shortest visible range allowed, as a proportion of the track */
+    double getMinViewLength() const;
+
+    /** Clamps the visible range to the track */
+    void constrainView();
     
     /** Triggers the position change callback if set */
     void notifyPositionChanged(double pos);
 
-    AudioThumbnail audioThumb;
+    WaveformCache& waveformCache;
+    std::shared_ptr<WaveformPyramid> pyramid;
+    std::shared_ptr<PyramidDecodeSink> pendingPyramid;
+
+    // The loaded track's pyramid while it is still being decoded
+    std::shared_ptr<PyramidDecodeSink> loadedPyramid;
+    FineDetailOpener openFineDetailReader;
+    std::vector<WaveformPyramid::Bin> columns;
+
+    // Visible range as proportions of the track
+    double viewStart = 0.0;
+    double viewLength = 1.0;
+
+    // Static layer, redrawn only when invalidated
+    Image waveformImage;
+    float waveformImageScale = 1.0f;
+
+    /** Half-width of the marker above the playhead */
+    static constexpr float playheadTriangleSize = 6.0f;
+
+    /** Closest zoom allowed, in pixels per sample */
+    static constexpr double maxPixelsPerSample = 8.0;
+
     bool fileLoaded = false;
     double position = 0.0;
     bool isDragging = false;
@@ -0,0 +1,352 @@
+/*
+  ==============================================================================
+
+    WaveformPyramid.cpp
+    Created: 16 Oct 2026 7:14:26pm
+
+  ==============================================================================
+*/
+
+#include "WaveformPyramid.h"
+
+//==============================================================================
+WaveformPyramid::WaveformPyramid(int numChannels, double sampleRate, int64 lengthInSamples, int baseBinSizeToUse)
+    : numChannels(numChannels),
+      sampleRate(sampleRate),
+      lengthInSamples(lengthInSamples),
+      baseBinSize(baseBinSizeToUse > 0 ? baseBinSizeToUse : minBaseBinSize) {
+    while (lengthInSamples / baseBinSize > maxBaseBins)
+        baseBinSize *= 2;
+
+    levels.resize(static_cast<size_t>(numChannels));
+    for (auto& channelLevels : levels) {
+        channelLevels.resize(1);
+        channelLevels[0].reserve(static_cast<size_t>(lengthInSamples / baseBinSize + 1));
+    }
+
+    pendingSamples.setSize(numChannels, baseBinSize);
+}
+
+//==============================================================================
+void WaveformPyramid::addBlock(const AudioBuffer<float>& block, int numSamples) {
+    auto channelsToUse = jmin(numChannels, block.getNumChannels());
+    int offset = 0;
+
+    while (offset < numSamples) {
+        // Whole bins straight from the block, without copying, in one kernel call per channel
+        if (numPendingSamples == 0 && numSamples - offset >= baseBinSize) {
+            auto numWholeBins = (numSamples - offset) / baseBinSize;
+            binStats.resize(static_cast<size_t>(numWholeBins));
+
+            for (int chan = 0; chan < channelsToUse; ++chan) {
+                PeakKernels::analyseBins(block.getReadPointer(chan, offset), numWholeBins, baseBinSize, binStats.data());
+
+                for (const auto& stats : binStats)
+                    levels[static_cast<size_t>(chan)][0].push_back(toBin(stats, baseBinSize));
+            }
+
+            offset += numWholeBins * baseBinSize;
+            continue;
+        }
+
+        auto numToCopy = jmin(baseBinSize - numPendingSamples, numSamples - offset);
+        for (int chan = 0; chan < channelsToUse; ++chan)
+            pendingSamples.copyFrom(chan, numPendingSamples, block, chan, offset, numToCopy);
+
+        numPendingSamples += numToCopy;
+        offset += numToCopy;
+
+        if (numPendingSamples == baseBinSize) {
+            for (int chan = 0; chan < channelsToUse; ++chan)
+                levels[static_cast<size_t>(chan)][0].push_back(analyseSamples(pendingSamples.getReadPointer(chan), baseBinSize));
+
+            numPendingSamples = 0;
+        }
+    }
+}
+
+void WaveformPyramid::finish() {
+    if (numPendingSamples > 0) {
+        for (int chan = 0; chan < numChannels; ++chan)
+            levels[static_cast<size_t>(chan)][0].push_back(analyseSamples(pendingSamples.getReadPointer(chan), numPendingSamples));
+
+        numPendingSamples = 0;
+    }
+
+    pendingSamples.setSize(0, 0);
+    binStats = {};
+
+    const auto factor = static_cast<size_t>(levelFactor);
+
+    for (auto& channelLevels : levels) {
+        while (channelLevels.back().size() > 1) {
+            const auto& finer = channelLevels.back();
+            std::vector<Bin> coarser;
+            coarser.reserve(finer.size() / factor + 1);
+
+            for (size_t i = 0; i < finer.size(); i += factor)
+                coarser.push_back(combineBins(finer.data() + i, static_cast<int>(jmin(factor, finer.size() - i))));
+
+            channelLevels.push_back(std::move(coarser));
+        }
+    }
+}
+
+void WaveformPyramid::writeTo(OutputStream& out) const {
+    // The finer levels are most of the size and only matter when zoomed right in
+    int level = 0;
+    while (getBinSize(level) < storedMinBinSize && level + 1 < static_cast<int>(levels.front().size()))
+        ++level;
+
+    out.writeInt(fileMagic);
+    out.writeInt(fileVersion);
+    out.writeInt(numChannels);
+    out.writeDouble(sampleRate);
+    out.writeInt64(lengthInSamples);
+    out.writeInt(static_cast<int>(getBinSize(level)));
+
+    auto toStored = [](float scaled) {
+        return static_cast<int8>(jlimit(-storedScale, storedScale, scaled));
+    };
+
+    for (const auto& channelLevels : levels) {
+        const auto& bins = channelLevels[static_cast<size_t>(level)];
+        std::vector<int8> values;
+        values.reserve(bins.size() * 3);
+
+        // Peaks are rounded outwards so the stored waveform never looks quieter than the track
+        for (const auto& bin : bins) {
+            values.push_back(toStored(std::floor(bin.min * storedScale)));
+            values.push_back(toStored(std::ceil(bin.max * storedScale)));
+            values.push_back(toStored(std::round(bin.rms * storedScale)));
+        }
+
+        out.writeInt64(static_cast<int64>(bins.size()));
+        out.write(values.data(), values.size());
+    }
+}
+
+std::unique_ptr<WaveformPyramid> WaveformPyramid::readFrom(InputStream& in) {
+    if (in.readInt() != fileMagic || in.readInt() != fileVersion)
+        return nullptr;
+
+    auto numChannels = in.readInt();
+    auto sampleRate = in.readDouble();
+    auto lengthInSamples = in.readInt64();
+    auto binSize = in.readInt();
+
+    if (numChannels <= 0 || numChannels > 64 || sampleRate <= 0.0 || lengthInSamples <= 0 || binSize <= 0)
+        return nullptr;
+
+    auto pyramid = std::make_unique<WaveformPyramid>(numChannels, sampleRate, lengthInSamples, binSize);
+    if (pyramid->baseBinSize != binSize)
+        return nullptr;
+
+    auto maxBins = lengthInSamples / binSize + 1;
+    std::vector<int8> values;
+
+    for (auto& channelLevels : pyramid->levels) {
+        auto numBins = in.readInt64();
+        if (numBins <= 0 || numBins > maxBins)
+            return nullptr;
+
+        values.resize(static_cast<size_t>(numBins) * 3);
+        auto numBytes = static_cast<int>(values.size());
+        if (in.read(values.data(), numBytes) != numBytes)
+            return nullptr;
+
+        auto& bins = channelLevels.front();
+        bins.resize(static_cast<size_t>(numBins));
+
+        for (size_t i = 0; i < bins.size(); ++i) {
+            bins[i].min = values[i * 3] / storedScale;
+            bins[i].max = values[i * 3 + 1] / storedScale;
+            bins[i].rms = values[i * 3 + 2] / storedScale;
+        }
+    }
+
+    pyramid->finish();
+    return pyramid;
+}
+
+//==============================================================================
+void WaveformPyramid::setSampleReader(std::unique_ptr<AudioFormatReader> reader) {
+    sampleReader = std::move(reader);
+}
+
+void WaveformPyramid::getColumns(int channel, int64 startSample, int64 endSample, Bin* columns, int numColumns) const {
+    if (numColumns <= 0)
+        return;
+
+    if (!isPositiveAndBelow(channel, numChannels) || endSample <= startSample || levels[static_cast<size_t>(channel)][0].empty()) {
+        std::fill(columns, columns + numColumns, Bin());
+        return;
+    }
+
+    auto samplesPerColumn = static_cast<double>(endSample - startSample) / numColumns;
+
+    if (samplesPerColumn < baseBinSize && sampleReader != nullptr) {
+        getColumnsFromSamples(channel, startSample, endSample, columns, numColumns);
+        return;
+    }
+
+    // The coarsest level whose bins still fit in a column keeps the work per column constant
+    const auto& channelLevels = levels[static_cast<size_t>(channel)];
+    int level = 0;
+    while (level + 1 < static_cast<int>(channelLevels.size()) && getBinSize(level + 1) <= samplesPerColumn)
+        ++level;
+
+    const auto& bins = channelLevels[static_cast<size_t>(level)];
+    auto binSize = getBinSize(level);
+    auto numBins = static_cast<int64>(bins.size());
+
+    for (int col = 0; col < numColumns; ++col) {
+        auto colStart = startSample + static_cast<int64>(col * samplesPerColumn);
+        auto colEnd = startSample + static_cast<int64>((col + 1) * samplesPerColumn);
+
+        auto firstBin = jlimit(static_cast<int64>(0), numBins, colStart / binSize);
+        auto lastBin = jlimit(static_cast<int64>(0), numBins, jmax(firstBin + 1, (colEnd + binSize - 1) / binSize));
+
+        columns[col] = firstBin < lastBin ? combineBins(bins.data() + firstBin, static_cast<int>(lastBin - firstBin))
+                                          : Bin();
+    }
+}
+
+int WaveformPyramid::getNumChannels() const noexcept {
+    return numChannels;
+}
+
+double WaveformPyramid::getSampleRate() const noexcept {
+    return sampleRate;
+}
+
+int64 WaveformPyramid::getLengthInSamples() const noexcept {
+    return lengthInSamples;
+}
+
+int WaveformPyramid::getBaseBinSize() const noexcept {
+    return baseBinSize;
+}
+
+size_t WaveformPyramid::getMemoryUsageBytes() const noexcept {
+    size_t total = 0;
+
+    for (const auto& channelLevels : levels)
+        for (const auto& level : channelLevels)
+            total += level.capacity() * sizeof(Bin);
+
+    return total;
+}
+
+//==============================================================================
+WaveformPyramid::Bin WaveformPyramid::analyseSamples(const float* samples, int numSamples) {
+    if (numSamples <= 0)
+        return {};
+
+    return toBin(PeakKernels::analyse(samples, numSamples), numSamples);
+}
+
+WaveformPyramid::Bin WaveformPyramid::toBin(const PeakKernels::Stats& stats, int numSamples) {
+    Bin bin;
+    bin.min = stats.min;
+    bin.max = stats.max;
+    bin.rms = std::sqrt(stats.sumOfSquares / static_cast<float>(numSamples));
+    return bin;
+}
+
+WaveformPyramid::Bin WaveformPyramid::combineBins(const Bin* bins, int numBins) {
+    Bin combined = bins[0];
+    float sumOfSquares = 0.0f;
+
+    for (int i = 0; i < numBins; ++i) {
+        combined.min = jmin(combined.min, bins[i].min);
+        combined.max = jmax(combined.max, bins[i].max);
+        sumOfSquares += bins[i].rms * bins[i].rms;
+    }
+
+    combined.rms = std::sqrt(sumOfSquares / static_cast<float>(numBins));
+    return combined;
+}
+
+void WaveformPyramid::getColumnsFromSamples(int channel, int64 startSample, int64 endSample,
+                                            Bin* columns, int numColumns) const {
+    auto first = jmax(static_cast<int64>(0), startSample);
+    auto last = jmin(lengthInSamples, endSample);
+
+    if (last <= first) {
+        std::fill(columns, columns + numColumns, Bin());
+        return;
+    }
+
+    // Only reached when a column is narrower than a base bin, so this is at most numColumns * baseBinSize samples
+    auto numSamples = static_cast<int>(last - first);
+    sampleScratch.setSize(numChannels, numSamples, false, false, true);
+    sampleReader->read(&sampleScratch, 0, numSamples, first, true, true);
+
+    auto* samples = sampleScratch.getReadPointer(channel);
+    auto samplesPerColumn = static_cast<double>(endSample - startSample) / numColumns;
+
+    for (int col = 0; col < numColumns; ++col) {
+        auto colStart = startSample + static_cast<int64>(col * samplesPerColumn);
+        auto colEnd = jmax(colStart + 1, startSample + static_cast<int64>((col + 1) * samplesPerColumn));
+
+        colStart = jlimit(first, last, colStart);
+        colEnd = jlimit(first, last, colEnd);
+
+        columns[col] = colStart < colEnd ? analyseSamples(samples + (colStart - first), static_cast<int>(colEnd - colStart))
+                                         : Bin();
+    }
+}
+
+int64 WaveformPyramid::getBinSize(int level) const noexcept {
+    int64 size = baseBinSize;
+    for (int i = 0; i < level; ++i)
+        size *= levelFactor;
+    return size;
+}
+
+//==============================================================================
+PyramidDecodeSink::PyramidDecodeSink(WaveformCache& cacheToUse)
+    : cache(cacheToUse) {
+}
+
+bool PyramidDecodeSink::trackIdentified(const String& hash) {
+    contentHash = hash;
+    if (contentHash.isEmpty())
+        return true;
+
+    pyramid = cache.load(contentHash);
+    completed = pyramid != nullptr;
+    finished.store(completed, std::memory_order_release);
+    return !completed;
+}
+
+void PyramidDecodeSink::decodeStarted(int numChannels, double sampleRate, int64 lengthInSamples) {
+    pyramid = std::make_shared<WaveformPyramid>(numChannels, sampleRate, lengthInSamples);
+}
+
+void PyramidDecodeSink::decodedBlock(const AudioBuffer<float>& block, int numSamples, int64 startSample) {
+    ignoreUnused(startSample);
+    pyramid->addBlock(block, numSamples);
+}
+
+void PyramidDecodeSink::decodeFinished(bool decodeCompleted) {
+    completed = decodeCompleted;
+
+    if (completed) {
+        pyramid->finish();
+
+        if (contentHash.isNotEmpty())
+            cache.store(contentHash, pyramid);
+    }
+
+    finished.store(true, std::memory_order_release);
+}
+
+bool PyramidDecodeSink::isFinished() const noexcept {
+    return finished.load(std::memory_order_acquire);
+}
+
+std::shared_ptr<WaveformPyramid> PyramidDecodeSink::getPyramid() const {
+    return isFinished() && completed ? pyramid : nullptr;
+}
@@ -0,0 +1,197 @@
+/*
+  ==============================================================================
+
+    WaveformPyramid.h
+    Created: 16 Oct 2026 7:14:26pm
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include "DecodeSink.h"
+#include "WaveformCache.h"
+#include "PeakKernels.h"
+
+/**
+ * @class WaveformPyramid
+ * @brief Min/max/RMS summaries of a track at several resolutions
+ *
+ * The finest level summarises a fixed number of samples per bin, and each level
+ * above it summarises levelFactor bins of the one below. The finest bin size grows
+ * with the track length so the pyramid never exceeds maxBaseBins bins per channel,
+ * which keeps memory bounded even for multi-hour recordings.
+ *
+ * Drawing a view asks for one summary per pixel column. The level whose bins are
+ * just smaller than a column is used, so every column combines only a handful of
+ * bins whatever the zoom. Below the finest level the samples themselves are read
+ * from an optional reader, down to single-sample resolution.
+ *
+ * The finest level is computed straight from decoded blocks with the vectorised
+ * PeakKernels. The pyramid is filled once by a PyramidDecodeSink and read-only after finish().
+ * Only one level of at least storedMinBinSize samples per bin is stored on disk, with
+ * each value in a byte, which keeps a typical track to a couple of hundred kilobytes.
+ * A pyramid read back starts at that level, and views finer than it come from the
+ * sample reader when there is one.
+ */
+class WaveformPyramid {
+public:
+    /** Summary of a range of samples */
+    struct Bin {
+        float min = 0.0f;
+        float max = 0.0f;
+        float rms = 0.0f;
+    };
+
+    /** Number of bins of one level combined into a bin of the next */
+    static constexpr int levelFactor = 4;
+
+    /** Smallest number of samples summarised by a bin of the finest level */
+    static constexpr int minBaseBinSize = 16;
+
+    /** Upper bound on the number of bins per channel in the finest level */
+    static constexpr int maxBaseBins = 1 << 19;
+
+    /** Fewest samples per bin in the level stored on disk */
+    static constexpr int storedMinBinSize = 512;
+
+    /**
+     * Constructor for WaveformPyramid
+     * @param numChannels Number of channels in the track
+     * @param sampleRate Sample rate of the track
+     * @param lengthInSamples Length of the track
+     * @param baseBinSizeToUse Samples per bin of the finest level, or 0 to choose it from the length
+     */
+    WaveformPyramid(int numChannels, double sampleRate, int64 lengthInSamples, int baseBinSizeToUse = 0);
+
+    //==========================================================================
+    // Building
+    //==========================================================================
+
+    /** Adds the next block of samples; blocks must arrive in order */
+    void addBlock(const AudioBuffer<float>& block, int numSamples);
+
+    /** Flushes the last partial bin and builds the coarser levels */
+    void finish();
+
+    /** Writes a finished pyramid's first level of at least storedMinBinSize samples per bin to a stream */
+    void writeTo(OutputStream& out) const;
+
+    /** Reads a pyramid written by writeTo, returning nullptr if the data is damaged or from another version */
+    static std::unique_ptr<WaveformPyramid> readFrom(InputStream& in);
+
+    //==========================================================================
+    // Reading
+    //==========================================================================
+
+    /**
+     * Sets a reader over the track's samples for views finer than the finest level
+     * Without one, the finest level is simply stretched when zoomed in further.
+     */
+    void setSampleReader(std::unique_ptr<AudioFormatReader> reader);
+
+    /**
+     * Summarises numColumns equal slices of a range, one per pixel column
+     * @param channel Channel to summarise
+     * @param startSample First sample of the range
+     * @param endSample End of the range (exclusive)
+     * @param columns Receives numColumns summaries
+     * @param numColumns Number of slices
+     */
+    void getColumns(int channel, int64 startSample, int64 endSample, Bin* columns, int numColumns) const;
+
+    /** Gets the number of channels */
+    int getNumChannels() const noexcept;
+
+    /** Gets the sample rate of the track */
+    double getSampleRate() const noexcept;
+
+    /** Gets the length of the track in samples */
+    int64 getLengthInSamples() const noexcept;
+
+    /** Gets the number of samples summarised by a bin of the finest level */
+    int getBaseBinSize() const noexcept;
+
+    /** Gets the memory held by the summaries */
+    size_t getMemoryUsageBytes() const noexcept;
+
+private:
+    /** Summarises a run of raw samples */
+    static Bin analyseSamples(const float* samples, int numSamples);
+
+    /** Converts a kernel reduction of numSamples samples to a bin */
+    static Bin toBin(const PeakKernels::Stats& stats, int numSamples);
+
+    /** Combines a run of bins of the same size */
+    static Bin combineBins(const Bin* bins, int numBins);
+
+    /** Fills columns from raw samples read from the sample reader */
+    void getColumnsFromSamples(int channel, int64 startSample, int64 endSample, Bin* columns, int numColumns) const;
+
+    /** Gets the number of samples summarised by a bin of the given level */
+    int64 getBinSize(int level) const noexcept;
+
+    /** Marks the start of a stored pyramid, followed by the format version */
+    static constexpr int fileMagic = 0x5057544f;
+    static constexpr int fileVersion = 2;
+
+    /** Full scale of a stored value; min and max are in -1..1 and the RMS in 0..1 */
+    static constexpr float storedScale = 127.0f;
+
+    int numChannels;
+    double sampleRate;
+    int64 lengthInSamples;
+    int baseBinSize;
+
+    // levels[channel][level][bin]
+    std::vector<std::vector<std::vector<Bin>>> levels;
+
+    // Samples of the finest bin still being filled while building
+    AudioBuffer<float> pendingSamples;
+    int numPendingSamples = 0;
+    std::vector<PeakKernels::Stats> binStats;
+
+    std::unique_ptr<AudioFormatReader> sampleReader;
+    mutable AudioBuffer<float> sampleScratch;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(WaveformPyramid)
+};
+
+/**
+ * @class PyramidDecodeSink
+ * @brief Builds a WaveformPyramid from the loader's decode pass
+ *
+ * Pyramids are looked up in and stored to the disk cache by content hash, so a track
+ * that has been seen before gets its waveform without being decoded for it.
+ */
+class PyramidDecodeSink : public DecodeSink {
+public:
+    /**
+     * Constructor for PyramidDecodeSink
+     * @param cacheToUse Cache to look the pyramid up in and store it to; must outlive the sink
+     */
+    explicit PyramidDecodeSink(WaveformCache& cacheToUse);
+
+    bool trackIdentified(const String& contentHash) override;
+    void decodeStarted(int numChannels, double sampleRate, int64 lengthInSamples) override;
+    void decodedBlock(const AudioBuffer<float>& block, int numSamples, int64 startSample) override;
+    void decodeFinished(bool completed) override;
+
+    /** Checks whether the pyramid has been found or the decode has ended, either way (any thread) */
+    bool isFinished() const noexcept;
+
+    /** Gets the finished pyramid, or nullptr if it isn't finished or the decode didn't complete */
+    std::shared_ptr<WaveformPyramid> getPyramid() const;
+
+private:
+    WaveformCache& cache;
+    String contentHash;
+
+    // Written by the decoding thread before the release store to finished
+    std::shared_ptr<WaveformPyramid> pyramid;
+    bool completed = false;
+    std::atomic<bool> finished{false};
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(PyramidDecodeSink)
+};
@@ -0,0 +1,108 @@
+/*
+  ==============================================================================
+
+    LoudnessMeterTests.cpp
+    Created: 17 Oct 2026 6:12:40pm
+
+  ==============================================================================
+*/
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include "../Source/LoudnessMeter.h"
+
+namespace {
+
+constexpr double sampleRate = 48000.0;
+constexpr int blockSize = 4096;
+
+/** One stretch of a test signal: a stereo sine at a level in dBFS, for some seconds */
+struct Segment {
+    float levelDb;
+    double seconds;
+};
+
+/**
+ * Measures a stereo sine made of segments, fed to the meter in blocks as a decode pass would
+ * @param frequency Frequency of the sine in Hz
+ * @param phase Phase of the sine at the start, in radians
+ */
+Loudness measureSine(std::initializer_list<Segment> segments, double frequency = 1000.0, double phase = 0.0) {
+    LoudnessMeter meter;
+    meter.reset(2, sampleRate);
+
+    AudioBuffer<float> block(2, blockSize);
+    int64 position = 0;
+
+    for (const auto& segment : segments) {
+        auto amplitude = Decibels::decibelsToGain(segment.levelDb);
+        auto remaining = roundToInt(segment.seconds * sampleRate);
+
+        while (remaining > 0) {
+            auto numSamples = jmin(blockSize, remaining);
+
+            for (int i = 0; i < numSamples; ++i) {
+                auto angle = MathConstants<double>::twoPi * frequency * static_cast<double>(position + i) / sampleRate + phase;
+                auto sample = amplitude * static_cast<float>(std::sin(angle));
+                block.setSample(0, i, sample);
+                block.setSample(1, i, sample);
+            }
+
+            meter.process(block, numSamples);
+            position += numSamples;
+            remaining -= numSamples;
+        }
+    }
+
+    return meter.getLoudness();
+}
+
+} // namespace
+
+/** Cases 1 to 5 of EBU Tech 3341, which allows 0.1 LU either way */
+class LoudnessMeterTests : public UnitTest {
+public:
+    LoudnessMeterTests() : UnitTest("LoudnessMeter", "Analysis") {}
+
+    void runTest() override {
+        constexpr double tolerance = 0.1;
+
+        beginTest("1 kHz stereo sine at -23 dBFS reads -23 LUFS");
+        {
+            auto loudness = measureSine({ { -23.0f, 20.0 } });
+            expect(loudness.isValid());
+            expectWithinAbsoluteError(loudness.integratedLufs, -23.0, tolerance);
+        }
+
+        beginTest("1 kHz stereo sine at -33 dBFS reads -33 LUFS");
+        expectWithinAbsoluteError(measureSine({ { -33.0f, 20.0 } }).integratedLufs, -33.0, tolerance);
+
+        beginTest("Relative gate leaves out quiet passages");
+        expectWithinAbsoluteError(measureSine({ { -36.0f, 10.0 }, { -23.0f, 60.0 }, { -36.0f, 10.0 } }).integratedLufs,
+                                  -23.0, tolerance);
+
+        beginTest("Absolute gate leaves out near silence");
+        expectWithinAbsoluteError(measureSine({ { -72.0f, 10.0 }, { -36.0f, 10.0 }, { -23.0f, 60.0 },
+                                                { -36.0f, 10.0 }, { -72.0f, 10.0 } }).integratedLufs,
+                                  -23.0, tolerance);
+
+        beginTest("Passages above the gates are averaged by power");
+        expectWithinAbsoluteError(measureSine({ { -26.0f, 20.0 }, { -20.0f, 20.1 }, { -26.0f, 20.0 } }).integratedLufs,
+                                  -23.0, tolerance);
+
+        beginTest("Silence and signal under the absolute gate aren't measured");
+        expect(!measureSine({ { -200.0f, 5.0 } }).isValid());
+        expect(!measureSine({ { -80.0f, 5.0 } }).isValid());
+
+        beginTest("True peak finds the peak between samples");
+        {
+            // A quarter of the sample rate at 45 degrees puts every sample 3 dB under the peak
+            auto loudness = measureSine({ { -6.0f, 2.0 } }, sampleRate / 4.0, MathConstants<double>::pi / 4.0);
+            expectWithinAbsoluteError(loudness.truePeakDb, -6.0, 0.3);
+        }
+
+        beginTest("True peak of a low sine is its sample peak");
+        expectWithinAbsoluteError(measureSine({ { -23.0f, 2.0 } }).truePeakDb, -23.0, 0.1);
+    }
+};
+
+static LoudnessMeterTests loudnessMeterTests;
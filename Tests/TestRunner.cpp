@@ -0,0 +1,28 @@
+/*
+  ==============================================================================
+
+    TestRunner.cpp
+    Created: 17 Oct 2026 2:41:09pm
+
+    Runs every juce::UnitTest linked into the test app and returns non-zero if
+    any of them failed, so ctest can report the result.
+
+  ==============================================================================
+*/
+
+#include "../JuceLibraryCode/JuceHeader.h"
+
+int main(int argc, char* argv[]) {
+    ignoreUnused(argc, argv);
+    ScopedJuceInitialiser_GUI juceInitialiser;
+
+    UnitTestRunner runner;
+    runner.setAssertOnFailure(false);
+    runner.runAllTests();
+
+    int numFailures = 0;
+    for (int i = 0; i < runner.getNumResults(); ++i)
+        numFailures += runner.getResult(i)->failures;
+
+    return numFailures > 0 ? 1 : 0;
+}
@@ -0,0 +1,71 @@
+/*
+  ==============================================================================
+
+    TrackWindowTests.cpp
+    Created: 17 Oct 2026 2:41:09pm
+
+  ==============================================================================
+*/
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include "../Source/TrackWindow.h"
+
+namespace {
+
+constexpr double sampleRate = 48000.0;
+constexpr double testFrequency = 220.0;
+constexpr float amplitude = 0.5f;
+
+/** The test track: a sine that doesn't fit the loop a whole number of times, so a bad splice shows */
+float trackSample(int64 position) {
+    return amplitude * static_cast<float>(std::sin(MathConstants<double>::twoPi * testFrequency
+                                                   * static_cast<double>(position) / sampleRate));
+}
+
+} // namespace
+
+class TrackWindowTests : public UnitTest {
+public:
+    TrackWindowTests() : UnitTest("TrackWindow", "Loops") {}
+
+    void runTest() override {
+        beginTest("Loop seam is continuous for a loop in the middle of its window");
+
+        // The lead-in is much longer than the loop allows the crossfade to be
+        TrackWindow window;
+        window.startSample = 10000;
+        window.loopStart = 12000;
+        window.loopEnd = 12400;
+        window.endSample = window.loopEnd;
+
+        auto length = static_cast<int>(window.endSample - window.startSample);
+        window.audio.setSize(1, length);
+        for (int i = 0; i < length; ++i)
+            window.audio.setSample(0, i, trackSample(window.startSample + i));
+
+        window.prepareLoop();
+        expectEquals(window.loopTail.getNumSamples(), static_cast<int>(window.loopEnd - window.loopStart) / 2);
+
+        // Twice round the loop, wrapping in between as the deck does
+        auto loopLength = static_cast<int>(window.loopEnd - window.loopStart);
+        AudioBuffer<float> output(1, loopLength * 2);
+        window.copyTo(output, 0, window.loopStart, loopLength, true);
+        window.copyTo(output, loopLength, window.loopStart, loopLength, true);
+
+        // The tail ends on the sample just before the loop start, so the wrap is seamless
+        expectWithinAbsoluteError(output.getSample(0, loopLength - 1), trackSample(window.loopStart - 1), 0.01f);
+
+        // No step is much bigger than the sine's own steepest one
+        auto maxNaturalStep = amplitude * static_cast<float>(MathConstants<double>::twoPi * testFrequency / sampleRate);
+        auto maxStep = 0.0f;
+        for (int i = 1; i < output.getNumSamples(); ++i)
+            maxStep = jmax(maxStep, std::abs(output.getSample(0, i) - output.getSample(0, i - 1)));
+
+        expectLessOrEqual(maxStep, maxNaturalStep * 2.0f, "The loop seam has a discontinuity");
+
+        beginTest("Samples before the crossfade come straight from the track");
+        expectEquals(output.getSample(0, 10), trackSample(window.loopStart + 10));
+    }
+};
+
+static TrackWindowTests trackWindowTests;
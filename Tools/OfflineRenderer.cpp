@@ -0,0 +1,330 @@
+/*
+  ==============================================================================
+
+    OfflineRenderer.cpp
+    Created: 17 Oct 2026 1:46:27am
+
+    Headless renderer: drives the same DJAudioPlayer decks and DeckMixerEngine
+    as the app, with no audio device, as fast as the CPU allows, and writes the
+    mix to a WAV or FLAC file. Useful for pre-rendering mixes, for regression
+    tests (the output is deterministic for a given command line) and for
+    measuring raw engine throughput.
+
+    Synced decks read the tempo the master published after its last block, so
+    which block that is must not depend on thread timing: with --sync every deck
+    renders on the main thread, the master first, then the others in order.
+
+    Usage:
+      OtoDecksRender --out mix.flac [options] --deck a.mp3 [deck options] --deck b.wav ...
+
+    Options:
+      --out FILE         Output file; .flac writes FLAC, anything else WAV
+      --rate HZ          Sample rate to render at (default 48000)
+      --block N          Block size in samples (default 512)
+      --bits N           16, 24, or 32 for float WAV (default 24)
+      --length SECONDS   Length of the mix (default: until the last deck ends)
+      --threads N        Render worker threads besides the main one (default: one per spare core);
+                         always 0 when a deck uses --sync
+      --quality Q        Resampler tier for all decks: fast, sinc or hq (default fast)
+
+    Deck options, applying to the --deck before them:
+      --offset SECONDS   Where in the track to start playing (default 0)
+      --at SECONDS       When in the mix the deck starts (default 0)
+      --speed RATIO      Playback speed (default 1)
+      --gain GAIN        Deck gain, 0 to 1 (default 1)
+      --keylock          Keep the pitch when the speed is not 1
+      --master           Make this the deck synced decks follow
+      --sync             Lock tempo and beats to the master deck, ignoring --speed
+
+  ==============================================================================
+*/
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include "../Source/DJAudioPlayer.h"
+#include "../Source/DeckMixerEngine.h"
+
+namespace {
+
+struct DeckSettings {
+    File file;
+    double offsetSeconds = 0.0;
+    double startAtSeconds = 0.0;
+    double speed = 1.0;
+    double gain = 1.0;
+    bool keyLock = false;
+    bool master = false;
+    bool sync = false;
+};
+
+struct RenderSettings {
+    File output;
+    double sampleRate = 48000.0;
+    int blockSize = 512;
+    int bitsPerSample = 24;
+    double lengthSeconds = -1.0;
+    int numWorkerThreads = -1;
+    QualityResamplingAudioSource::Quality quality = QualityResamplingAudioSource::Quality::fast;
+    Array<DeckSettings> decks;
+};
+
+void printUsage() {
+    std::cout << "Usage: OtoDecksRender --out FILE [--rate HZ] [--block N] [--bits 16|24|32] [--length SECONDS]" << std::endl
+              << "                      [--threads N] [--quality fast|sinc|hq]" << std::endl
+              << "                      --deck FILE [--offset SECONDS] [--at SECONDS] [--speed RATIO] [--gain GAIN] [--keylock]" << std::endl
+              << "                      [--master] [--sync]" << std::endl
+              << "                      [--deck FILE ...]" << std::endl;
+}
+
+/** Parses the command line, returning an error message or an empty string */
+String parseArguments(const StringArray& arguments, RenderSettings& settings) {
+    for (int i = 0; i < arguments.size(); ++i) {
+        auto option = arguments[i];
+        auto hasValue = i + 1 < arguments.size();
+        auto value = hasValue ? arguments[i + 1] : String();
+
+        auto needsValue = option != "--keylock" && option != "--master" && option != "--sync";
+        if (needsValue && !hasValue)
+            return option + " needs a value";
+
+        auto* deck = settings.decks.isEmpty() ? nullptr : &settings.decks.getReference(settings.decks.size() - 1);
+        auto isDeckOption = option == "--offset" || option == "--at" || option == "--speed"
+                         || option == "--gain" || option == "--keylock" || option == "--master" || option == "--sync";
+
+        if (isDeckOption && deck == nullptr)
+            return option + " must follow a --deck";
+
+        if (option == "--out")            settings.output = File::getCurrentWorkingDirectory().getChildFile(value);
+        else if (option == "--rate")      settings.sampleRate = value.getDoubleValue();
+        else if (option == "--block")     settings.blockSize = value.getIntValue();
+        else if (option == "--bits")      settings.bitsPerSample = value.getIntValue();
+        else if (option == "--length")    settings.lengthSeconds = value.getDoubleValue();
+        else if (option == "--threads")   settings.numWorkerThreads = value.getIntValue();
+        else if (option == "--offset")    deck->offsetSeconds = value.getDoubleValue();
+        else if (option == "--at")        deck->startAtSeconds = value.getDoubleValue();
+        else if (option == "--speed")     deck->speed = value.getDoubleValue();
+        else if (option == "--gain")      deck->gain = value.getDoubleValue();
+        else if (option == "--keylock")   deck->keyLock = true;
+        else if (option == "--master")    deck->master = true;
+        else if (option == "--sync")      deck->sync = true;
+        else if (option == "--quality") {
+            using Quality = QualityResamplingAudioSource::Quality;
+            if (value == "fast")          settings.quality = Quality::fast;
+            else if (value == "sinc")     settings.quality = Quality::sinc;
+            else if (value == "hq")       settings.quality = Quality::highQuality;
+            else                          return "unknown quality " + value;
+        }
+        else if (option == "--deck") {
+            DeckSettings newDeck;
+            newDeck.file = File::getCurrentWorkingDirectory().getChildFile(value);
+            settings.decks.add(newDeck);
+        }
+        else {
+            return "unknown option " + option;
+        }
+
+        if (needsValue)
+            ++i;
+    }
+
+    if (settings.output == File())
+        return "no --out file";
+    if (settings.decks.isEmpty())
+        return "no --deck files";
+    if (settings.decks.size() > DeckMixerEngine::maxDecks)
+        return "at most " + String(DeckMixerEngine::maxDecks) + " decks";
+    if (settings.sampleRate <= 0.0 || settings.blockSize <= 0)
+        return "--rate and --block must be positive";
+
+    auto isFlac = settings.output.hasFileExtension("flac");
+    if (settings.bitsPerSample != 16 && settings.bitsPerSample != 24 && (isFlac || settings.bitsPerSample != 32))
+        return "--bits must be 16 or 24" + String(isFlac ? "" : ", or 32 for WAV");
+
+    auto numMasters = std::count_if(settings.decks.begin(), settings.decks.end(), [](const DeckSettings& deck) { return deck.master; });
+    if (numMasters > 1)
+        return "only one deck can be --master";
+
+    for (auto& deck : settings.decks) {
+        if (!deck.file.existsAsFile())
+            return "no such file " + deck.file.getFullPathName();
+        if (deck.speed <= 0.0 || deck.offsetSeconds < 0.0 || deck.startAtSeconds < 0.0)
+            return "--speed must be positive, --offset and --at not negative";
+    }
+
+    return {};
+}
+
+/** Opens a writer for the output file, in the format its extension asks for */
+std::unique_ptr<AudioFormatWriter> createWriter(const RenderSettings& settings) {
+    std::unique_ptr<AudioFormat> format;
+    if (settings.output.hasFileExtension("flac"))
+        format = std::make_unique<FlacAudioFormat>();
+    else
+        format = std::make_unique<WavAudioFormat>();
+
+    settings.output.deleteFile();
+    auto stream = settings.output.createOutputStream();
+    if (stream == nullptr)
+        return nullptr;
+
+    std::unique_ptr<AudioFormatWriter> writer(format->createWriterFor(stream.get(), settings.sampleRate,
+                                                                      DeckMixerEngine::numDeckChannels,
+                                                                      settings.bitsPerSample, {}, 0));
+    if (writer != nullptr)
+        stream.release(); // the writer owns it now
+
+    return writer;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    ScopedJuceInitialiser_GUI juceInitialiser;
+
+    StringArray arguments;
+    for (int i = 1; i < argc; ++i)
+        arguments.add(CharPointer_UTF8(argv[i]));
+
+    RenderSettings settings;
+    auto error = parseArguments(arguments, settings);
+    if (error.isNotEmpty()) {
+        std::cerr << "OtoDecksRender: " << error << std::endl;
+        printUsage();
+        return 1;
+    }
+
+    // With workers, a synced deck could render before or after the master in the same block
+    auto anySync = std::any_of(settings.decks.begin(), settings.decks.end(), [](const DeckSettings& deck) { return deck.sync; });
+    if (anySync) {
+        if (settings.numWorkerThreads > 0)
+            std::cout << "OtoDecksRender: --sync renders on one thread, ignoring --threads" << std::endl;
+
+        settings.numWorkerThreads = 0;
+    }
+
+    AudioFormatManager formatManager;
+    formatManager.registerBasicFormats();
+
+    // Declared before the mixer so the decks outlive its workers
+    OwnedArray<DJAudioPlayer> players;
+    DeckMixerEngine mixer(settings.numWorkerThreads);
+
+    for (int i = 0; i < settings.decks.size(); ++i) {
+        auto* player = players.add(new DJAudioPlayer(formatManager));
+
+        // Decoding on the render thread can't underrun, and bypassing the cache keeps runs reproducible;
+        // only decks taking part in sync need a beat grid, so the others skip the analysis
+        const auto& deck = settings.decks.getReference(i);
+        player->setReadAheadSamples(0);
+        player->setUsePcmCache(false);
+        player->setAnalyseOnLoad(deck.master || deck.sync);
+    }
+
+    // A single-threaded mixer renders decks in the order they were added, so the master goes first
+    for (int i = 0; i < settings.decks.size(); ++i)
+        if (settings.decks.getReference(i).master)
+            mixer.addDeck(players[i]);
+
+    for (int i = 0; i < settings.decks.size(); ++i)
+        if (!settings.decks.getReference(i).master)
+            mixer.addDeck(players[i]);
+
+    mixer.prepareToPlay(settings.blockSize, settings.sampleRate);
+
+    // Each deck's start time in the mix, and the end of the mix unless a length was given
+    Array<int64> startSamples;
+    auto mixEndSeconds = 0.0;
+
+    for (int i = 0; i < settings.decks.size(); ++i) {
+        const auto& deck = settings.decks.getReference(i);
+        auto* player = players[i];
+
+        std::unique_ptr<AudioFormatReader> probe(formatManager.createReaderFor(deck.file));
+        if (probe == nullptr || !player->loadURL(URL(deck.file))) {
+            std::cerr << "OtoDecksRender: could not load " << deck.file.getFullPathName() << std::endl;
+            return 1;
+        }
+
+        auto trackSeconds = static_cast<double>(probe->lengthInSamples) / probe->sampleRate;
+        mixEndSeconds = jmax(mixEndSeconds, deck.startAtSeconds + jmax(0.0, trackSeconds - deck.offsetSeconds) / deck.speed);
+
+        // Applied at the start of the first block, so the deck starts exactly where asked
+        player->setResamplerQuality(settings.quality);
+        player->setKeyLock(deck.keyLock);
+        player->setGain(deck.gain);
+        player->setSpeed(deck.speed);
+        player->setPosition(deck.offsetSeconds);
+        player->setSyncEnabled(deck.sync);
+
+        if (deck.master)
+            player->setSyncMaster(true);
+
+        // Sync needs the beat grid before the first block
+        while (player->isAnalysing())
+            Thread::sleep(10);
+
+        startSamples.add(static_cast<int64>(std::llround(deck.startAtSeconds * settings.sampleRate)));
+    }
+
+    auto lengthSeconds = settings.lengthSeconds >= 0.0 ? settings.lengthSeconds : mixEndSeconds;
+    auto totalSamples = static_cast<int64>(std::ceil(lengthSeconds * settings.sampleRate));
+
+    auto writer = createWriter(settings);
+    if (writer == nullptr) {
+        std::cerr << "OtoDecksRender: could not write " << settings.output.getFullPathName() << std::endl;
+        return 1;
+    }
+
+    std::cout << "Rendering " << settings.decks.size() << " decks, " << String(lengthSeconds, 2) << " s at "
+              << settings.sampleRate << " Hz with " << mixer.getNumWorkerThreads() << " worker threads" << std::endl;
+
+    AudioBuffer<float> block(DeckMixerEngine::numDeckChannels, settings.blockSize);
+    Array<bool> started;
+    started.insertMultiple(0, false, settings.decks.size());
+
+    double renderSeconds = 0.0;
+    auto wallStart = Time::getHighResolutionTicks();
+
+    for (int64 position = 0; position < totalSamples;) {
+        // Start any deck due now, then render up to the next start so every deck enters on its exact sample
+        auto chunkEnd = jmin(totalSamples, position + settings.blockSize);
+
+        for (int i = 0; i < players.size(); ++i) {
+            if (started[i])
+                continue;
+
+            if (startSamples[i] <= position) {
+                players[i]->start();
+                started.set(i, true);
+            }
+            else {
+                chunkEnd = jmin(chunkEnd, startSamples[i]);
+            }
+        }
+
+        auto numSamples = static_cast<int>(chunkEnd - position);
+
+        auto renderStart = Time::getHighResolutionTicks();
+        mixer.getNextAudioBlock(AudioSourceChannelInfo(&block, 0, numSamples));
+        renderSeconds += Time::highResolutionTicksToSeconds(Time::getHighResolutionTicks() - renderStart);
+
+        if (!writer->writeFromAudioSampleBuffer(block, 0, numSamples)) {
+            std::cerr << "OtoDecksRender: write failed" << std::endl;
+            return 1;
+        }
+
+        position = chunkEnd;
+    }
+
+    writer.reset();
+    auto wallSeconds = Time::highResolutionTicksToSeconds(Time::getHighResolutionTicks() - wallStart);
+
+    mixer.releaseResources();
+
+    std::cout << "Wrote " << settings.output.getFullPathName() << std::endl
+              << "Engine: " << String(renderSeconds, 3) << " s, " << String(lengthSeconds / jmax(renderSeconds, 1.0e-9), 1)
+              << "x real time" << std::endl
+              << "Total:  " << String(wallSeconds, 3) << " s, " << String(lengthSeconds / jmax(wallSeconds, 1.0e-9), 1)
+              << "x real time, including encoding" << std::endl;
+
+    return 0;
+}